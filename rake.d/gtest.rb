@@ -1,6 +1,6 @@
 #!/usr/bin/env ruby
 
-$gtest_apps     = %w{common merge propedit}
+$gtest_apps     = %w{common extract merge propedit}
 $gtest_internal = c(:GTEST_TYPE) == "internal"
 
 namespace :tests do
@@ -11,6 +11,14 @@ namespace :tests do
   task :run_unit => 'tests:unit' do
     $gtest_apps.each { |app| run "./tests/unit/#{app}/#{app}" }
   end
+
+  desc "Build the micro benchmarks"
+  task :benchmark => "tests/unit/benchmark/benchmark" + c(:EXEEXT)
+
+  desc "Build and run the micro benchmarks"
+  task :run_benchmark => 'tests:benchmark' do
+    run "./tests/unit/benchmark/benchmark"
+  end
 end
 
 $build_system_modules[:gtest] = {
@@ -24,6 +32,7 @@ $build_system_modules[:gtest] = {
   :define_tasks => lambda do
     gtest_libs = {
       'common'   => [],
+      'extract'  => [ :mtxextract ],
       'propedit' => [ :mtxpropedit ],
       'merge'    => [ :mtxmerge ],
     }
@@ -52,5 +61,15 @@ $build_system_modules[:gtest] = {
         libraries(gtest_libs[app], :mtxunittest, $common_libs, :gtest, :pthread).
         create
     end
+
+    # Not part of $gtest_apps as the benchmarks take a while; they're
+    # only built & run on request.
+    Application.
+      new("tests/unit/benchmark/benchmark").
+      description("Build the micro benchmarks executable").
+      aliases("benchmark").
+      sources([ "tests/unit/benchmark" ], :type => :dir).
+      libraries(:mtxmerge, :mtxunittest, $common_libs, :gtest, :pthread).
+      create
   end,
 }
@@ -45,19 +45,152 @@
 
 #include "common/common_pch.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define MTX_BASE64_SSSE3
+# include <immintrin.h>
+#endif
+
 #include "common/base64.h"
 #include "common/error.h"
 
-static const char base64_encoding[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+namespace {
+
+char const s_encoding[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Maps each character to its six bit value; 0xff for characters
+// outside the alphabet.
+struct decoding_table_t {
+  unsigned char values[256];
+
+  decoding_table_t() {
+    std::memset(values, 0xff, sizeof(values));
+    for (auto idx = 0u; 64 > idx; ++idx)
+      values[static_cast<unsigned char>(s_encoding[idx])] = idx;
+  }
+};
+
+decoding_table_t const s_decoding;
+
+// Vectorized kernels return the number of three byte blocks
+// (encoding) or input characters (decoding) they've processed. The
+// rest is handled by the table-driven code. They may read up to four
+// bytes more than they process and write up to four bytes more than
+// they produce.
+using encode_kernel_t = size_t (*)(unsigned char const *src, size_t src_size, size_t num_blocks, char *dst);
+using decode_kernel_t = size_t (*)(char const *src, size_t src_size, unsigned char *dst);
+
+#if defined(MTX_BASE64_SSSE3)
+// Both kernels follow Wojciech Muła's SSE algorithms: shuffles and
+// multiplications move the six bit groups into place, and nibble
+// indexed lookups map them from and to the alphabet.
+__attribute__((target("ssse3")))
+size_t
+encode_ssse3(unsigned char const *src,
+             size_t src_size,
+             size_t num_blocks,
+             char *dst) {
+  auto const shuffle  = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  auto const shift    = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  auto processed      = size_t{};
+
+  // Each round consumes 12 bytes but loads 16.
+  for (; ((processed + 4) <= num_blocks) && ((processed * 3 + 16) <= src_size); processed += 4) {
+    auto in      = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(src + processed * 3)), shuffle);
+    auto hi      = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    auto lo      = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    auto indices = _mm_or_si128(hi, lo);
+
+    auto ranges  = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    ranges       = _mm_or_si128(ranges, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + processed * 4), _mm_add_epi8(indices, _mm_shuffle_epi8(shift, ranges)));
+  }
+
+  return processed;
+}
+
+__attribute__((target("ssse3")))
+size_t
+decode_ssse3(char const *src,
+             size_t src_size,
+             unsigned char *dst) {
+  auto const lut_lo   = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+  auto const lut_hi   = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  auto const lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  auto const mask_2f  = _mm_set1_epi8(0x2f);
+  auto const pack     = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  auto processed      = size_t{};
+
+  for (; (processed + 16) <= src_size; processed += 16) {
+    auto in          = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + processed));
+    auto hi_nibbles  = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+    auto lo_nibbles  = _mm_and_si128(in, mask_2f);
+    auto invalid     = _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo_nibbles), _mm_shuffle_epi8(lut_hi, hi_nibbles));
+
+    // Anything outside the alphabet including padding and white space
+    // is left to the table-driven code.
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xffff)
+      break;
+
+    auto roll        = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(in, mask_2f), hi_nibbles));
+    auto values      = _mm_add_epi8(in, roll);
+    auto merged      = _mm_madd_epi16(_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + processed / 4 * 3), _mm_shuffle_epi8(merged, pack));
+  }
+
+  return processed;
+}
+#endif  // MTX_BASE64_SSSE3
+
+encode_kernel_t
+select_encode_kernel() {
+#if defined(MTX_BASE64_SSSE3)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("ssse3"))
+    return encode_ssse3;
+#endif
+
+  return nullptr;
+}
+
+decode_kernel_t
+select_decode_kernel() {
+#if defined(MTX_BASE64_SSSE3)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("ssse3"))
+    return decode_ssse3;
+#endif
+
+  return nullptr;
+}
+
+// Encodes 'num_blocks' complete three byte blocks. 'src_size' is the
+// number of bytes readable starting at 'src'.
+char *
+encode_blocks(unsigned char const *src,
+              size_t src_size,
+              size_t num_blocks,
+              char *dst) {
+  static auto s_kernel = select_encode_kernel();
+
+  if (s_kernel) {
+    auto processed  = s_kernel(src, src_size, num_blocks, dst);
+    src            += processed * 3;
+    dst            += processed * 4;
+    num_blocks     -= processed;
+  }
+
+  for (; num_blocks; --num_blocks, src += 3, dst += 4) {
+    dst[0] = s_encoding[  src[0] >> 2];
+    dst[1] = s_encoding[((src[0] & 0x03) << 4) | (src[1] >> 4)];
+    dst[2] = s_encoding[((src[1] & 0x0f) << 2) | (src[2] >> 6)];
+    dst[3] = s_encoding[  src[2] & 0x3f];
+  }
+
+  return dst;
+}
 
-static void
-encode_block(const unsigned char in[3],
-             int len,
-             std::string &out) {
-  out += base64_encoding[in[0] >> 2];
-  out += base64_encoding[((in[0] & 0x03) << 4) | ((in[1] & 0xf0) >> 4)];
-  out += (unsigned char)(len > 1 ? base64_encoding[((in[1] & 0x0f) << 2) | ((in[2] & 0xc0) >> 6)] : '=');
-  out += (unsigned char)(len > 2 ? base64_encoding[in[2] & 0x3f]                                  : '=');
 }
 
 std::string
@@ -65,96 +198,121 @@ base64_encode(const unsigned char *src,
               int src_len,
               bool line_breaks,
               int max_line_len) {
-  int pos        = 0;
-  int blocks_out = 0;
-
   if (4 > max_line_len)
     max_line_len = 4;
 
-  int i, len_mod = max_line_len / 4;
-  std::string out;
-
-  while (pos < src_len) {
-    unsigned char in[3];
-    int len = 0;
-    for (i = 0; 3 > i; ++i) {
-      if (pos < src_len) {
-        ++len;
-        in[i] = (unsigned char)src[pos];
-      } else
-        in[i] = 0;
-      ++pos;
-    }
+  if (0 >= src_len)
+    return {};
+
+  size_t size          = src_len;
+  size_t len_mod       = max_line_len / 4;
+  auto num_blocks      = (size + 2) / 3;
+  auto num_full        = size / 3;
+  auto blocks_per_line = line_breaks ? len_mod : num_blocks;
+
+  // A line break follows every 'len_mod' blocks including the last
+  // one.
+  std::string out(num_blocks * 4 + (line_breaks ? num_blocks / len_mod : 0), '\0');
+  auto dst = &out[0];
 
-    encode_block(in, len, out);
+  for (size_t block = 0; block < num_full;) {
+    auto num_line_blocks  = std::min(num_full - block, blocks_per_line - block % blocks_per_line);
+    dst                   = encode_blocks(src + block * 3, size - block * 3, num_line_blocks, dst);
+    block                += num_line_blocks;
 
-    ++blocks_out;
-    if (line_breaks && ((blocks_out % len_mod) == 0))
-      out += "\n";
+    if (line_breaks && !(block % len_mod))
+      *dst++ = '\n';
   }
 
+  if (size % 3) {
+    auto in  = src + num_full * 3;
+    auto two = 2 == (size % 3);
+
+    *dst++ = s_encoding[  in[0] >> 2];
+    *dst++ = s_encoding[((in[0] & 0x03) << 4) | (two ? in[1] >> 4 : 0)];
+    *dst++ = two ? s_encoding[(in[1] & 0x0f) << 2] : '=';
+    *dst++ = '=';
+
+    if (line_breaks && !(num_blocks % len_mod))
+      *dst++ = '\n';
+  }
+
+  out.resize(dst - out.data());
+
   return out;
 }
 
 std::string
 base64_decode(std::string const &src) {
-  auto pos = 0u;
-  auto pad = 0u;
-  auto dst = std::string{};
+  static auto s_kernel = select_decode_kernel();
+
+  auto values = s_decoding.values;
+  auto size   = src.size();
+  auto in     = src.data();
+  auto pos    = size_t{};
+
+  // Each group ends after four characters from the alphabet or at the
+  // end of the input. Groups produce at most three bytes each, the
+  // rest is room for the vectorized kernel's excess writes.
+  std::string decoded(size / 4 * 3 + 3 + 4, '\0');
+  auto dst = reinterpret_cast<unsigned char *>(&decoded[0]);
+
+  while (pos < size) {
+    // Fast path: groups consisting of four characters from the
+    // alphabet only.
+    if (s_kernel) {
+      auto processed  = s_kernel(in + pos, size - pos, dst);
+      pos            += processed;
+      dst            += processed / 4 * 3;
+    }
 
-  while (pos < src.size()) {
-    unsigned char in[4];
-    unsigned int in_pos = 0;
+    for (; (pos + 4) <= size; pos += 4, dst += 3) {
+      auto v0 = values[static_cast<unsigned char>(in[pos])],     v1 = values[static_cast<unsigned char>(in[pos + 1])];
+      auto v2 = values[static_cast<unsigned char>(in[pos + 2])], v3 = values[static_cast<unsigned char>(in[pos + 3])];
 
-    while ((src.size() > pos) && (4 > in_pos)) {
-      unsigned char c = (unsigned char)src[pos];
+      if ((v0 | v1 | v2 | v3) & 0x80)
+        break;
+
+      dst[0] = (v0 << 2) | (v1 >> 4);
+      dst[1] = (v1 << 4) | (v2 >> 2);
+      dst[2] = (v2 << 6) |  v3;
+    }
+
+    if (pos >= size)
+      break;
+
+    // Slow path for one group containing padding, white space or
+    // invalid characters, or being cut short by the end of the input.
+    unsigned char group[4] = { 0, 0, 0, 0 };
+    auto num_values        = 0u;
+    auto pad               = 0u;
+
+    while ((pos < size) && (4 > num_values)) {
+      auto c = static_cast<unsigned char>(in[pos]);
       ++pos;
 
-      if ((('A' <= c) && ('Z' >= c)) || (('a' <= c) && ('z' >= 'c')) || (('0' <= c) && ('9' >= c)) || ('+' == c) || ('/' == c)) {
-        in[in_pos] = c;
-        ++in_pos;
+      if (0xff != values[c])
+        group[num_values++] = values[c];
 
-      } else if (c == '=')
-        pad++;
+      else if ('=' == c)
+        ++pad;
 
       else if (!isblanktab(c) && !iscr(c))
         throw mtx::base64::invalid_data_x{};
     }
 
-    unsigned int values_idx;
-    unsigned char values[4];
-    memset(values, 0, 4);
-    for (values_idx = 0; values_idx < in_pos; values_idx++) {
-      values[values_idx] =
-          (('A' <= in[values_idx]) && ('Z' >= in[values_idx])) ? in[values_idx] - 'A'
-        : (('a' <= in[values_idx]) && ('z' >= in[values_idx])) ? in[values_idx] - 'a' + 26
-        : (('0' <= in[values_idx]) && ('9' >= in[values_idx])) ? in[values_idx] - '0' + 52
-        :  ('+' == in[values_idx])                             ?  62
-        :  ('/' == in[values_idx])                             ?  63
-        :                                                        255;
-
-      if (255 == values[values_idx])
-        throw mtx::base64::invalid_data_x{};
-    }
-
-    unsigned char mid[6];
-    mid[0] = values[0] << 2;
-    mid[1] = values[1] >> 4;
-    mid[2] = values[1] << 4;
-    mid[3] = values[2] >> 2;
-    mid[4] = values[2] << 6;
-    mid[5] = values[3];
-
-    dst += mid[0] | mid[1];
+    *dst++ = (group[0] << 2) | (group[1] >> 4);
     if (1 >= pad) {
-      dst += mid[2] | mid[3];
+      *dst++ = (group[1] << 4) | (group[2] >> 2);
       if (0 == pad)
-        dst += mid[4] | mid[5];
+        *dst++ = (group[2] << 6) | group[3];
     }
 
     if (0 != pad)
       break;
   }
 
-  return dst;
+  decoded.resize(reinterpret_cast<char *>(dst) - decoded.data());
+
+  return decoded;
 }
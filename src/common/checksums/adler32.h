@@ -36,6 +36,10 @@ protected:
   virtual void add_impl(unsigned char const *buffer, size_t size);
 };
 
+// Returns the Adler-32 of the concatenation of two buffers given the
+// Adler-32 of each buffer and the second buffer's size.
+uint32_t combine_adler32(uint32_t adler1, uint32_t adler2, uint64_t size2);
+
 }} // namespace mtx { namespace checksum {
 
 #endif // MTX_COMMON_CHECKSUMS_ADLER32_H
@@ -12,16 +12,155 @@
 
    This code was adopted from the ffmpeg project, files
    "libavutil/crc.h" and "libavutil/crc.c".
+
+   The folding with carry-less multiplications for CRC-32 follows
+   Intel's white paper "Fast CRC Computation for Generic Polynomials
+   Using PCLMULQDQ Instruction" and the implementation in zlib as
+   used by Chromium.
 */
 
 #include "common/common_pch.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define MTX_CRC32_PCLMUL
+# include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__AARCH64EL__) && defined(SYS_LINUX)
+# define MTX_CRC32_ARMV8
+# include <arm_acle.h>
+# include <sys/auxv.h>
+# include <asm/hwcap.h>
+#endif
+
 #include "common/bswap.h"
 #include "common/checksums/crc.h"
 #include "common/endian.h"
 
 namespace mtx { namespace checksum {
 
+namespace {
+
+// Hardware kernels return the number of bytes they've processed. The
+// rest is handled by the table-driven code.
+using hardware_kernel_t = size_t (*)(uint32_t &crc, unsigned char const *buffer, size_t size);
+
+#if defined(MTX_CRC32_PCLMUL)
+__attribute__((target("pclmul,sse4.1")))
+size_t
+crc32_ieee_le_pclmul(uint32_t &crc,
+                     unsigned char const *buffer,
+                     size_t size) {
+  if (64 > size)
+    return 0;
+
+  alignas(16) static uint64_t const s_k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+  alignas(16) static uint64_t const s_k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+  alignas(16) static uint64_t const s_k5k0[] = { 0x0163cd6124, 0x0000000000 };
+  alignas(16) static uint64_t const s_poly[] = { 0x01db710641, 0x01f7011641 };
+
+  auto processed = size & ~static_cast<size_t>(15);
+  auto remaining = processed - 64;
+  auto ptr       = reinterpret_cast<__m128i const *>(buffer);
+
+  // Fold four 128-bit lanes in parallel over 64 bytes at a time.
+  auto x1 = _mm_xor_si128(_mm_loadu_si128(ptr + 0), _mm_cvtsi32_si128(crc));
+  auto x2 = _mm_loadu_si128(ptr + 1);
+  auto x3 = _mm_loadu_si128(ptr + 2);
+  auto x4 = _mm_loadu_si128(ptr + 3);
+  auto x0 = _mm_load_si128(reinterpret_cast<__m128i const *>(s_k1k2));
+
+  ptr += 4;
+
+  while (64 <= remaining) {
+    auto x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    auto x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    auto x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+    auto x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), x5), _mm_loadu_si128(ptr + 0));
+    x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, x0, 0x11), x6), _mm_loadu_si128(ptr + 1));
+    x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, x0, 0x11), x7), _mm_loadu_si128(ptr + 2));
+    x4 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x4, x0, 0x11), x8), _mm_loadu_si128(ptr + 3));
+
+    ptr       += 4;
+    remaining -= 64;
+  }
+
+  // Fold the four lanes into one and continue with 16 bytes at a time.
+  x0 = _mm_load_si128(reinterpret_cast<__m128i const *>(s_k3k4));
+
+  for (auto next : { x2, x3, x4 })
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), next), _mm_clmulepi64_si128(x1, x0, 0x00));
+
+  while (16 <= remaining) {
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, x0, 0x11), _mm_loadu_si128(ptr)), _mm_clmulepi64_si128(x1, x0, 0x00));
+
+    ++ptr;
+    remaining -= 16;
+  }
+
+  // Reduce 128 to 64 bits and then to 32 bits with a Barrett reduction.
+  auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  x0 = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(s_k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask), x0, 0x00), x2);
+
+  x0 = _mm_load_si128(reinterpret_cast<__m128i const *>(s_poly));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), x0, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  crc = _mm_extract_epi32(x1, 1);
+
+  return processed;
+}
+#endif  // MTX_CRC32_PCLMUL
+
+#if defined(MTX_CRC32_ARMV8)
+# if defined(__clang__)
+__attribute__((target("crc")))
+# else
+__attribute__((target("+crc")))
+# endif
+size_t
+crc32_ieee_le_armv8(uint32_t &crc,
+                    unsigned char const *buffer,
+                    size_t size) {
+  auto end = buffer + size;
+
+  for (; (buffer + 8) <= end; buffer += 8) {
+    uint64_t value;
+    std::memcpy(&value, buffer, 8);
+    crc = __crc32d(crc, value);
+  }
+
+  for (; buffer < end; ++buffer)
+    crc = __crc32b(crc, *buffer);
+
+  return size;
+}
+#endif  // MTX_CRC32_ARMV8
+
+hardware_kernel_t
+select_crc32_ieee_le_kernel() {
+#if defined(MTX_CRC32_PCLMUL)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+    return crc32_ieee_le_pclmul;
+
+#elif defined(MTX_CRC32_ARMV8)
+  if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+    return crc32_ieee_le_armv8;
+#endif
+
+  return nullptr;
+}
+
+}
+
 crc_base_c::table_parameters_t const crc_base_c::ms_table_parameters[5] = {
   { 0,  8,       0x07 },
   { 0, 16,     0x8005 },
@@ -56,7 +195,7 @@ crc_base_c::init_table() {
   if ((parameters.bits < 8) || (parameters.bits > 32) || (parameters.poly >= (1LL<<parameters.bits)))
     throw std::domain_error{"Invalid CRC parameters"};
 
-  m_table.resize(256);
+  m_table.resize(256 * num_slices);
 
   for (auto i = 0u; i < 256u; i++) {
     if (parameters.le) {
@@ -73,6 +212,14 @@ crc_base_c::init_table() {
     }
   }
 
+  // Slice n contains the CRC of the byte followed by n zero bytes so
+  // that several bytes can be looked up independently of each other.
+  for (auto slice = 1u; slice < num_slices; ++slice)
+    for (auto i = 0u; i < 256u; i++) {
+      auto previous            = m_table[(slice - 1) * 256 + i];
+      m_table[slice * 256 + i] = m_table[previous & 0xff] ^ (previous >> 8);
+    }
+
   // for (auto row = 0u; row < (265u / 4); ++row)
   //   mxinfo(boost::format("0x%|1$08x| 0x%|2$08x| 0x%|3$08x| 0x%|4$08x|\n")
   //          % m_table[row * 4 + 0] % m_table[row * 4 + 1] % m_table[row * 4 + 2] % m_table[row * 4 + 3]);
@@ -114,10 +261,46 @@ crc_base_c::set_xor_result(uint64_t xor_result) {
 void
 crc_base_c::add_impl(unsigned char const *buffer,
                      size_t size) {
+  if (crc_32_ieee_le == m_type) {
+    static auto s_hardware_kernel = select_crc32_ieee_le_kernel();
+
+    if (s_hardware_kernel) {
+      auto processed  = s_hardware_kernel(m_crc, buffer, size);
+      buffer         += processed;
+      size           -= processed;
+    }
+  }
+
   auto end = buffer + size;
+  auto t   = m_table.data();
+
+  // Slicing-by-16: all table lookups for 16 bytes are independent of
+  // each other.
+  for (; (buffer + 16) <= end; buffer += 16) {
+    auto one   = get_uint32_le(buffer) ^ m_crc;
+    auto two   = get_uint32_le(buffer +  4);
+    auto three = get_uint32_le(buffer +  8);
+    auto four  = get_uint32_le(buffer + 12);
+
+    m_crc = t[15 * 256 + (one   & 0xff)] ^ t[14 * 256 + ((one   >> 8) & 0xff)] ^ t[13 * 256 + ((one   >> 16) & 0xff)] ^ t[12 * 256 + (one   >> 24)]
+          ^ t[11 * 256 + (two   & 0xff)] ^ t[10 * 256 + ((two   >> 8) & 0xff)] ^ t[ 9 * 256 + ((two   >> 16) & 0xff)] ^ t[ 8 * 256 + (two   >> 24)]
+          ^ t[ 7 * 256 + (three & 0xff)] ^ t[ 6 * 256 + ((three >> 8) & 0xff)] ^ t[ 5 * 256 + ((three >> 16) & 0xff)] ^ t[ 4 * 256 + (three >> 24)]
+          ^ t[ 3 * 256 + (four  & 0xff)] ^ t[ 2 * 256 + ((four  >> 8) & 0xff)] ^ t[ 1 * 256 + ((four  >> 16) & 0xff)] ^ t[ 0 * 256 + (four  >> 24)];
+  }
+
+  // Slicing-by-8 for the remainder.
+  if ((buffer + 8) <= end) {
+    auto one = get_uint32_le(buffer) ^ m_crc;
+    auto two = get_uint32_le(buffer + 4);
+
+    m_crc = t[ 7 * 256 + (one   & 0xff)] ^ t[ 6 * 256 + ((one   >> 8) & 0xff)] ^ t[ 5 * 256 + ((one   >> 16) & 0xff)] ^ t[ 4 * 256 + (one   >> 24)]
+          ^ t[ 3 * 256 + (two   & 0xff)] ^ t[ 2 * 256 + ((two   >> 8) & 0xff)] ^ t[ 1 * 256 + ((two   >> 16) & 0xff)] ^ t[ 0 * 256 + (two   >> 24)];
+
+    buffer += 8;
+  }
 
   while (buffer < end) {
-    m_crc = m_table[(m_crc & 0xff) ^ *buffer] ^ (m_crc >> 8);
+    m_crc = t[(m_crc & 0xff) ^ *buffer] ^ (m_crc >> 8);
     ++buffer;
   }
 }
@@ -182,4 +365,63 @@ crc32_ieee_le_c::crc32_ieee_le_c(uint32_t initial_value)
 crc32_ieee_le_c::~crc32_ieee_le_c() {
 }
 
+// ----------------------------------------------------------------------
+
+static uint32_t
+gf2_matrix_times(uint32_t const *matrix,
+                 uint32_t vector) {
+  auto sum = uint32_t{};
+
+  for (; vector; vector >>= 1, ++matrix)
+    if (vector & 1)
+      sum ^= *matrix;
+
+  return sum;
+}
+
+static void
+gf2_matrix_square(uint32_t *square,
+                  uint32_t const *matrix) {
+  for (auto idx = 0; idx < 32; ++idx)
+    square[idx] = gf2_matrix_times(matrix, matrix[idx]);
+}
+
+uint32_t
+combine_crc32_ieee_le(uint32_t crc1,
+                      uint32_t crc2,
+                      uint64_t size2) {
+  if (!size2)
+    return crc1;
+
+  // Operators applying 2^n zero bits to a CRC, starting with the one
+  // for a single zero bit.
+  uint32_t even[32], odd[32];
+
+  odd[0] = 0xedb88320;
+  for (auto idx = 1, row = 1; idx < 32; ++idx, row <<= 1)
+    odd[idx] = row;
+
+  gf2_matrix_square(even, odd);
+  gf2_matrix_square(odd, even);
+
+  // Apply size2 zero bytes to crc1.
+  while (true) {
+    gf2_matrix_square(even, odd);
+    if (size2 & 1)
+      crc1 = gf2_matrix_times(even, crc1);
+    size2 >>= 1;
+    if (!size2)
+      break;
+
+    gf2_matrix_square(odd, even);
+    if (size2 & 1)
+      crc1 = gf2_matrix_times(odd, crc1);
+    size2 >>= 1;
+    if (!size2)
+      break;
+  }
+
+  return crc1 ^ crc2;
+}
+
 }} // namespace mtx { namespace checksum {
@@ -30,7 +30,9 @@ protected:
     crc_32_ieee_le = 4,
   };
 
+  // 16 tables of 256 entries each for slicing-by-16.
   using table_t = std::vector<uint32_t>;
+  static unsigned int const num_slices = 16;
 
   struct table_parameters_t {
     uint8_t  le;
@@ -111,6 +113,12 @@ public:
   virtual ~crc32_ieee_le_c();
 };
 
+// Returns the CRC-32 of the concatenation of two buffers given the
+// CRC-32 of each buffer and the second buffer's size. Both values must
+// have been calculated the way zlib does: with an initial value of
+// 0xffffffff and the result XORed with 0xffffffff.
+uint32_t combine_crc32_ieee_le(uint32_t crc1, uint32_t crc2, uint64_t size2);
+
 }} // namespace mtx { namespace checksum {
 
 #endif // MTX_COMMON_CHECKSUMS_CRC_H
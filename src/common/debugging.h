@@ -16,6 +16,9 @@
 
 #include "common/common_pch.h"
 
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
 
@@ -43,47 +46,76 @@ public:
 
 class debugging_option_c {
   struct option_c {
-    boost::tribool m_requested;
+    // -1: not determined yet; 0: not requested; 1: requested
+    std::atomic<int> m_requested;
     std::string m_option;
 
     option_c(std::string const &option)
-      : m_requested{boost::logic::indeterminate}
+      : m_requested{-1}
       , m_option{option}
     {
     }
 
     bool get() {
-      if (boost::logic::indeterminate(m_requested))
-        m_requested = debugging_c::requested(m_option);
+      auto requested = m_requested.load();
+      if (-1 == requested) {
+        requested   = debugging_c::requested(m_option) ? 1 : 0;
+        m_requested = requested;
+      }
 
-      return m_requested;
+      return 1 == requested;
     }
   };
 
 protected:
-  mutable size_t m_registered_idx;
+  mutable std::once_flag m_registration_flag;
+  mutable option_c *m_registered_option;
   std::string m_option;
 
 private:
-  static std::vector<option_c> ms_registered_options;
+  // Options may be evaluated for the first time from several threads
+  // at once. A deque keeps references to existing entries valid when
+  // new ones are registered.
+  static std::deque<option_c> ms_registered_options;
+  static std::mutex ms_mutex;
 
 public:
+  // Registration is deferred until the first evaluation as instances
+  // with static storage duration may be constructed before the
+  // registry itself.
   debugging_option_c(std::string const &option)
-    : m_registered_idx{std::numeric_limits<size_t>::max()}
+    : m_registered_option{}
     , m_option{option}
   {
   }
 
+  debugging_option_c(debugging_option_c const &other)
+    : m_registered_option{}
+    , m_option{other.m_option}
+  {
+  }
+
+  debugging_option_c &
+  operator =(debugging_option_c const &other) {
+    if (this != &other) {
+      m_option            = other.m_option;
+      m_registered_option = &register_option(m_option);
+    }
+
+    return *this;
+  }
+
   operator bool() const {
-    if (m_registered_idx == std::numeric_limits<size_t>::max())
-      m_registered_idx = register_option(m_option);
+    std::call_once(m_registration_flag, [this]() { m_registered_option = &register_option(m_option); });
 
-    return ms_registered_options.at(m_registered_idx).get();
+    return m_registered_option->get();
   }
 
 public:
-  static size_t register_option(std::string const &option);
   static void invalidate_cache();
+
+private:
+  static option_c &register_option(std::string const &option);
 };
 
 #define mxdebug(msg) debugging_c::output((boost::format("Debug> %1%:%2%: %3%") % __FILE__ % __LINE__ % (msg)).str())
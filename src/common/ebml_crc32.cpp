@@ -0,0 +1,157 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   writing and verifying EBML CRC-32 elements
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <ebml/EbmlCrc32.h>
+
+#include "common/checksums/base.h"
+#include "common/ebml_crc32.h"
+#include "common/endian.h"
+#include "common/kax_cluster_walker.h"
+#include "common/mm_io.h"
+
+namespace {
+
+// A memory buffer pretending to start at a given position in the
+// output file.
+class mm_positioned_mem_io_c: public mm_mem_io_c {
+protected:
+  uint64_t m_base;
+
+public:
+  mm_positioned_mem_io_c(uint64_t base)
+    : mm_mem_io_c{nullptr, 0, 1024 * 1024}
+    , m_base{base}
+  {
+  }
+
+  virtual uint64
+  getFilePointer() {
+    return m_base + mm_mem_io_c::getFilePointer();
+  }
+
+  virtual void
+  setFilePointer(int64 offset,
+                 seek_mode mode = seek_beginning) {
+    mm_mem_io_c::setFilePointer(seek_beginning == mode ? offset - static_cast<int64_t>(m_base) : offset, mode);
+  }
+};
+
+uint32_t
+calculate_ebml_crc32(unsigned char const *buffer,
+                     size_t size) {
+  return mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::crc32_ieee_le, buffer, size, 0xffffffff) ^ 0xffffffff;
+}
+
+}
+
+ebml_crc32_check_t::ebml_crc32_check_t()
+  : present{}
+  , valid{}
+  , start{}
+  , end{}
+  , stored{}
+  , calculated{}
+{
+}
+
+void
+add_ebml_crc32_element(EbmlMaster &master) {
+  if (master.ListSize() && Is<EbmlCrc32>(master[0]))
+    return;
+
+  auto crc = new EbmlCrc32;
+  crc->ForceCrc32(0);
+  master.InsertElement(*crc, 0);
+}
+
+void
+render_with_ebml_crc32(EbmlMaster &master,
+                       mm_io_c &out,
+                       std::function<void(mm_io_c &)> const &renderer) {
+  add_ebml_crc32_element(master);
+
+  auto base = out.getFilePointer();
+  mm_positioned_mem_io_c buffer{base};
+
+  renderer(buffer);
+
+  auto mem        = buffer.get_buffer();
+  auto &crc       = *static_cast<EbmlCrc32 *>(master[0]);
+  auto data_start = crc.GetElementPosition() + crc.ElementSize() - base;
+  auto data_end   = master.GetElementPosition() + master.ElementSize() - base;
+  auto value      = calculate_ebml_crc32(mem + data_start, data_end - data_start);
+
+  crc.ForceCrc32(value);
+  put_uint32_le(mem + crc.GetElementPosition() + crc.HeadSize() - base, value);
+
+  // mm_io_c::get_size() would report the size including the base.
+  out.write(mem, data_end);
+}
+
+ebml_crc32_check_t
+verify_ebml_crc32(mm_io_c &in,
+                  uint64_t position) {
+  auto result = ebml_crc32_check_t{};
+  auto walker = kax_cluster_walker_c{in, TIMECODE_SCALE};
+  kax_cluster_walker_c::element_header_t master, child;
+
+  in.save_pos();
+
+  if (   !walker.read_element_header(position, master)
+      || master.unknown_size
+      || !walker.read_element_header(position + master.head_size, child)
+      || (child.id != EBML_ID_VALUE(EBML_ID(EbmlCrc32)))
+      || (child.size != 4)) {
+    in.restore_pos();
+    return result;
+  }
+
+  unsigned char stored[4];
+  in.setFilePointer(child.position + child.head_size);
+  if (in.read(stored, 4) != 4) {
+    in.restore_pos();
+    return result;
+  }
+
+  result.present = true;
+  result.stored  = get_uint32_le(stored);
+  result.start   = child.position + child.head_size + 4;
+  result.end     = master.position + master.head_size + master.size;
+
+  // Read in chunks so that huge clusters don't have to be kept in
+  // memory completely.
+  auto chunk_size = std::min<uint64_t>(result.end - result.start, 4 * 1024 * 1024);
+  auto chunk      = memory_c::alloc(std::max<uint64_t>(chunk_size, 1));
+  auto worker     = mtx::checksum::for_algorithm(mtx::checksum::algorithm_e::crc32_ieee_le, 0xffffffff);
+  auto remaining  = result.end - result.start;
+
+  while (remaining) {
+    auto to_read = std::min<uint64_t>(remaining, chunk_size);
+    if (in.read(chunk, to_read) != to_read)
+      break;
+
+    worker->add(chunk->get_buffer(), to_read);
+    remaining -= to_read;
+  }
+
+  worker->finish();
+
+  result.calculated = dynamic_cast<mtx::checksum::uint_result_c &>(*worker).get_result_as_uint() ^ 0xffffffff;
+  result.valid      = !remaining && (result.calculated == result.stored);
+
+  in.restore_pos();
+
+  return result;
+}
@@ -0,0 +1,52 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   writing and verifying EBML CRC-32 elements
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_EBML_CRC32_H
+#define MTX_COMMON_EBML_CRC32_H
+
+#include "common/common_pch.h"
+
+#include <ebml/EbmlMaster.h>
+
+using namespace libebml;
+
+struct ebml_crc32_check_t {
+  bool present, valid;
+  // The range of bytes covered by the checksum: all of the master's
+  // content following the EbmlCrc32 element.
+  uint64_t start, end;
+  uint32_t stored, calculated;
+
+  ebml_crc32_check_t();
+};
+
+// Makes sure that the first child of 'master' is an EbmlCrc32
+// element. It stays there so that all later size calculations include
+// it.
+void add_ebml_crc32_element(EbmlMaster &master);
+
+// Renders 'master' with 'renderer' into a memory buffer whose file
+// positions start at the current position of 'out', fills in the
+// EbmlCrc32 element that must be its first child and writes the
+// buffer to 'out'. All positions stored in the elements during
+// rendering (e.g. those of blocks used for cues) are therefore the
+// same as if 'renderer' had written to 'out' directly.
+void render_with_ebml_crc32(EbmlMaster &master, mm_io_c &out, std::function<void(mm_io_c &)> const &renderer);
+
+// Checks the master element at 'position'. If its first child is an
+// EbmlCrc32 element then the checksum over the rest of the master's
+// content is calculated and compared. The file position is restored
+// afterwards.
+ebml_crc32_check_t verify_ebml_crc32(mm_io_c &in, uint64_t position);
+
+#endif  // MTX_COMMON_EBML_CRC32_H
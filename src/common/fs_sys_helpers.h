@@ -19,6 +19,10 @@ namespace mtx { namespace sys {
 
 int64_t get_current_time_millis();
 
+// The most physical memory the process has used so far in bytes. 0 if
+// it cannot be determined.
+uint64_t get_peak_memory_usage();
+
 int system(std::string const &command);
 
 void determine_path_to_current_executable(std::string const &argv0);
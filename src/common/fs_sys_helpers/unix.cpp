@@ -16,6 +16,7 @@
 #if !defined(SYS_WINDOWS)
 
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <sys/time.h>
 
 #if defined(SYS_APPLE)
@@ -38,6 +39,20 @@ get_current_time_millis() {
   return (int64_t)tv.tv_sec * 1000 + (int64_t)tv.tv_usec / 1000;
 }
 
+uint64_t
+get_peak_memory_usage() {
+  struct rusage usage;
+  if (0 != getrusage(RUSAGE_SELF, &usage))
+    return 0;
+
+#if defined(SYS_APPLE)
+  // Reported in bytes on macOS but in kilobytes everywhere else.
+  return usage.ru_maxrss;
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
 bfs::path
 get_application_data_folder() {
   auto home = getenv("HOME");
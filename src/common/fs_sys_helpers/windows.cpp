@@ -17,6 +17,7 @@
 
 #include <io.h>
 #include <windows.h>
+#include <psapi.h>
 #include <winreg.h>
 #include <direct.h>
 #include <shlobj.h>
@@ -37,6 +38,23 @@ get_current_time_millis() {
   return (int64_t)tb.time * 1000 + tb.millitm;
 }
 
+uint64_t
+get_peak_memory_usage() {
+  // GetProcessMemoryInfo() lives in different libraries depending on
+  // the Windows version. Look it up at runtime instead of linking
+  // against psapi.
+  using get_process_memory_info_t = BOOL (WINAPI *)(HANDLE, PPROCESS_MEMORY_COUNTERS, DWORD);
+
+  auto kernel32 = GetModuleHandleW(L"kernel32.dll");
+  auto function = kernel32 ? reinterpret_cast<get_process_memory_info_t>(GetProcAddress(kernel32, "K32GetProcessMemoryInfo")) : nullptr;
+  PROCESS_MEMORY_COUNTERS counters;
+
+  if (!function || !function(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+
+  return counters.PeakWorkingSetSize;
+}
+
 void
 set_environment_variable(const std::string &key,
                          const std::string &value) {
@@ -769,11 +769,20 @@ void
 kax_analyzer_c::overwrite_all_instances(EbmlId id) {
   size_t data_idx;
 
+  m_previous_element_position.reset();
+
   for (data_idx = 0; m_data.size() > data_idx; ++data_idx) {
     // We only have to do work on specific elements. Skip the others.
     if (m_data[data_idx]->m_id != id)
       continue;
 
+    // Remember where the first instance was so that write_element()
+    // can try putting the new one into the same spot.
+    if (!m_previous_element_position) {
+      m_previous_element_position = m_data[data_idx]->m_pos;
+      m_previous_element_end      = m_data[data_idx]->m_pos + m_data[data_idx]->m_size;
+    }
+
     // Overwrite with a void element.
     m_data[data_idx]->m_size = 0;
     handle_void_elements(data_idx);
@@ -848,8 +857,12 @@ kax_analyzer_c::merge_void_elements() {
 /** \brief Finds a suitable spot for an element and writes it to the file
 
     First, a suitable spot for the element is determined by looking at
-    EbmlVoid elements. If none is found in the middle of the file then
-    the element will be appended at the end.
+    EbmlVoid elements. The space the element occupied before including
+    any padding following it is tried first. With the placement
+    strategy \c ps_end this is only done if there was padding behind
+    the old element, e.g. for tags written by mkvmerge with
+    '--header-padding'. Otherwise the element is written to the last
+    EbmlVoid element or appended at the end of the file.
 
     Second, the element is written at the location determined in the
     first step. If EbmlVoid elements are overwritten then a new,
@@ -869,6 +882,9 @@ kax_analyzer_c::write_element(EbmlElement *e,
   e->UpdateSize(write_defaults, true);
   int64_t element_size = e->ElementSize(write_defaults);
 
+  if (write_element_at_previous_position(e, write_defaults, ps_end == strategy))
+    return;
+
   size_t data_idx;
   for (data_idx = (ps_anywhere == strategy ? 0 : m_data.size() - 1); m_data.size() > data_idx; ++data_idx) {
     // We're only interested in EbmlVoid elements. Skip the others.
@@ -880,15 +896,7 @@ kax_analyzer_c::write_element(EbmlElement *e,
       continue;
 
     // We've found our element. Overwrite it.
-    m_file->setFilePointer(m_data[data_idx]->m_pos);
-    e->Render(*m_file, write_defaults, false, true);
-
-    // Update the internal records.
-    m_data[data_idx]->m_id   = EbmlId(*e);
-    m_data[data_idx]->m_size = e->ElementSize(write_defaults);
-
-    // Create a new void element after the element we've just written.
-    handle_void_elements(data_idx);
+    write_element_into_void(e, write_defaults, data_idx);
 
     // We're done.
     return;
@@ -904,6 +912,74 @@ kax_analyzer_c::write_element(EbmlElement *e,
   adjust_segment_size();
 }
 
+/** \brief Writes an element into the space it occupied before
+
+    After \c overwrite_all_instances() and \c merge_void_elements()
+    the old instance's space and any padding following it (e.g. the
+    one reserved by mkvmerge's '--header-padding') form a single
+    EbmlVoid element. Using it keeps the element where it was so that
+    neither the seek heads have to be changed nor the file has to
+    grow.
+
+    If \c require_padding is set then the void element must extend
+    beyond the end of the old element. Elements that are normally
+    kept at the end of the file are only kept in front of it if space
+    has been reserved for them.
+
+    \return \c true if the element was written and \c false if there
+      is no such void element or if it is too small.
+ */
+bool
+kax_analyzer_c::write_element_at_previous_position(EbmlElement *e,
+                                                   bool write_defaults,
+                                                   bool require_padding) {
+  if (!m_previous_element_position)
+    return false;
+
+  auto position        = *m_previous_element_position;
+  auto previous_end    = *m_previous_element_end;
+  int64_t element_size = e->ElementSize(write_defaults);
+
+  m_previous_element_position.reset();
+  m_previous_element_end.reset();
+
+  for (size_t data_idx = 0; m_data.size() > data_idx; ++data_idx) {
+    auto const &data = *m_data[data_idx];
+
+    if ((data.m_pos > position) || ((data.m_pos + data.m_size) <= position))
+      continue;
+
+    if (!Is<EbmlVoid>(data.m_id) || (data.m_size < element_size))
+      return false;
+
+    if (require_padding && ((data.m_pos + data.m_size) <= previous_end))
+      return false;
+
+    mxdebug_if(m_debug, boost::format("write_element_at_previous_position: re-using void at %1% size %2% for element of size %3%\n") % data.m_pos % data.m_size % element_size);
+
+    write_element_into_void(e, write_defaults, data_idx);
+
+    return true;
+  }
+
+  return false;
+}
+
+void
+kax_analyzer_c::write_element_into_void(EbmlElement *e,
+                                        bool write_defaults,
+                                        size_t data_idx) {
+  m_file->setFilePointer(m_data[data_idx]->m_pos);
+  e->Render(*m_file, write_defaults, false, true);
+
+  // Update the internal records.
+  m_data[data_idx]->m_id   = EbmlId(*e);
+  m_data[data_idx]->m_size = e->ElementSize(write_defaults);
+
+  // Create a new void element after the element we've just written.
+  handle_void_elements(data_idx);
+}
+
 int
 kax_analyzer_c::ensure_front_seek_head_links_to(unsigned int seek_head_idx) {
   // It is possible that the seek head at the front has been removed
@@ -102,7 +102,7 @@ private:
   parse_mode_e m_parse_mode{parse_mode_full};
   open_mode m_open_mode{MODE_WRITE};
   bool m_throw_on_error{};
-  boost::optional<uint64_t> m_parser_start_position;
+  boost::optional<uint64_t> m_parser_start_position, m_previous_element_position, m_previous_element_end;
 
 public:                         // Static functions
   static bool probe(std::string file_name);
@@ -173,6 +173,8 @@ protected:
   virtual void overwrite_all_instances(EbmlId id);
   virtual void merge_void_elements();
   virtual void write_element(EbmlElement *e, bool write_defaults, placement_strategy_e strategy);
+  virtual bool write_element_at_previous_position(EbmlElement *e, bool write_defaults, bool require_padding);
+  virtual void write_element_into_void(EbmlElement *e, bool write_defaults, size_t data_idx);
   virtual void add_to_meta_seek(EbmlElement *e);
   virtual std::pair<bool, int> try_adding_to_existing_meta_seek(EbmlElement *e);
   virtual void move_seek_head_to_end_and_create_new_one_at_start(EbmlElement *e, int first_seek_head_idx);
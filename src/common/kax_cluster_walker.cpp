@@ -0,0 +1,440 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   walking clusters by reading block headers only
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <ebml/EbmlCrc32.h>
+#include <ebml/EbmlVoid.h>
+#include <matroska/KaxBlock.h>
+#include <matroska/KaxBlockData.h>
+#include <matroska/KaxCluster.h>
+#include <matroska/KaxClusterData.h>
+#include <matroska/KaxSegment.h>
+
+#include "common/ebml.h"
+#include "common/kax_cluster_walker.h"
+
+using namespace libebml;
+using namespace libmatroska;
+
+namespace {
+
+// Reads an EBML variable length integer from a buffer. For IDs the
+// length marker is kept. Returns the number of bytes used or 0 if
+// the buffer is too small or the value is invalid.
+unsigned int
+parse_vint(unsigned char const *buffer,
+           std::size_t available,
+           bool is_id,
+           uint64_t &value,
+           bool &unknown) {
+  if (!available || !buffer[0])
+    return 0;
+
+  auto length = 1u;
+  auto mask   = 0x80u;
+  while (!(buffer[0] & mask)) {
+    mask >>= 1;
+    ++length;
+  }
+
+  if ((length > available) || (is_id && (length > 4)))
+    return 0;
+
+  value       = is_id ? buffer[0] : buffer[0] & (mask - 1);
+  auto all_ff = value == (mask - 1);
+
+  for (auto idx = 1u; idx < length; ++idx) {
+    value   = (value << 8) | buffer[idx];
+    all_ff &= 0xff == buffer[idx];
+  }
+
+  unknown = !is_id && all_ff;
+
+  return length;
+}
+
+unsigned int
+parse_vint(unsigned char const *buffer,
+           std::size_t available,
+           uint64_t &value) {
+  auto unknown = false;
+  return parse_vint(buffer, available, false, value, unknown);
+}
+
+}
+
+kax_block_header_t::kax_block_header_t()
+  : position{}
+  , data_position{}
+  , track_number{}
+  , timecode{}
+  , num_references{}
+  , is_simple_block{}
+  , keyframe{}
+  , discardable{}
+{
+}
+
+kax_cluster_walker_c::kax_cluster_walker_c(mm_io_c &in,
+                                           int64_t timecode_scale)
+  : m_in(in)
+  , m_file_size{static_cast<uint64_t>(in.get_size())}
+  , m_timecode_scale{timecode_scale}
+  , m_cluster_timecode{}
+  , m_aborted{}
+  , m_debug{"kax_cluster_walker"}
+{
+}
+
+kax_cluster_walker_c &
+kax_cluster_walker_c::set_cluster_handler(cluster_handler_t const &handler) {
+  m_cluster_handler = handler;
+  return *this;
+}
+
+kax_cluster_walker_c &
+kax_cluster_walker_c::set_block_handler(block_handler_t const &handler) {
+  m_block_handler = handler;
+  return *this;
+}
+
+bool
+kax_cluster_walker_c::is_level1_element_id(uint64_t id) {
+  auto const &context = EBML_CLASS_CONTEXT(KaxSegment);
+  for (auto idx = 0u; EBML_CTX_SIZE(context) > idx; ++idx)
+    if (EBML_ID_VALUE(EBML_CTX_IDX_ID(context, idx)) == id)
+      return true;
+
+  return false;
+}
+
+unsigned char const *
+kax_cluster_walker_c::read_bytes(uint64_t position,
+                                 std::size_t size) {
+  if ((position + size) > m_file_size)
+    return nullptr;
+
+  m_buffer.resize(std::max<std::size_t>(size, 1));
+  m_in.setFilePointer(position);
+
+  return m_in.read(&m_buffer[0], size) == size ? &m_buffer[0] : nullptr;
+}
+
+bool
+kax_cluster_walker_c::read_element_header(uint64_t position,
+                                          element_header_t &header) {
+  if (position >= m_file_size)
+    return false;
+
+  auto available = static_cast<std::size_t>(std::min<uint64_t>(12, m_file_size - position));
+  auto buffer    = read_bytes(position, available);
+  if (!buffer)
+    return false;
+
+  auto unknown     = false;
+  auto id_length   = parse_vint(buffer, available, true, header.id, unknown);
+  auto size_length = id_length ? parse_vint(buffer + id_length, available - id_length, false, header.size, header.unknown_size) : 0;
+
+  if (!size_length)
+    return false;
+
+  header.position  = position;
+  header.head_size = id_length + size_length;
+
+  return header.unknown_size || ((position + header.head_size + header.size) <= m_file_size);
+}
+
+boost::optional<uint64_t>
+kax_cluster_walker_c::read_uint(element_header_t const &element) {
+  if (element.size > 8)
+    return {};
+
+  auto buffer = read_bytes(element.position + element.head_size, element.size);
+  if (!buffer)
+    return {};
+
+  auto value = uint64_t{};
+  for (auto idx = 0u; idx < element.size; ++idx)
+    value = (value << 8) | buffer[idx];
+
+  return value;
+}
+
+boost::optional<int64_t>
+kax_cluster_walker_c::read_sint(element_header_t const &element) {
+  auto value = read_uint(element);
+  if (!value)
+    return {};
+
+  if (!element.size)
+    return 0;
+
+  // Sign-extend from the element's size.
+  auto shift = 64 - element.size * 8;
+  return static_cast<int64_t>(*value << shift) >> shift;
+}
+
+bool
+kax_cluster_walker_c::parse_lacing(unsigned char const *buffer,
+                                   std::size_t buffer_size,
+                                   uint64_t data_size,
+                                   unsigned int lacing,
+                                   kax_block_header_t &header,
+                                   std::size_t &lace_header_size) {
+  if (!buffer_size)
+    return false;
+
+  auto num_frames = buffer[0] + 1u;
+  auto pos        = std::size_t{1};
+  auto total      = uint64_t{};
+
+  header.frame_sizes.clear();
+
+  if (0x04 == lacing) {         // fixed-size lacing
+    if ((data_size - 1) % num_frames)
+      mxdebug_if(m_debug, boost::format("fixed-size lacing with %1% frames not matching data size %2%\n") % num_frames % (data_size - 1));
+
+    header.frame_sizes.assign(num_frames, (data_size - 1) / num_frames);
+    lace_header_size = 1;
+
+    return true;
+  }
+
+  for (auto frame = 0u; frame < (num_frames - 1); ++frame) {
+    auto frame_size = uint64_t{};
+
+    if (0x02 == lacing) {       // Xiph lacing
+      unsigned char byte;
+      do {
+        if (pos >= buffer_size)
+          return false;
+        byte        = buffer[pos++];
+        frame_size += byte;
+      } while (0xff == byte);
+
+    } else {                    // EBML lacing
+      auto value  = uint64_t{};
+      auto length = parse_vint(buffer + pos, buffer_size - pos, value);
+      if (!length)
+        return false;
+
+      pos += length;
+
+      if (!frame)
+        frame_size = value;
+      else {
+        auto bias  = (int64_t{1} << (7 * length - 1)) - 1;
+        frame_size = static_cast<uint64_t>(static_cast<int64_t>(header.frame_sizes.back()) + static_cast<int64_t>(value) - bias);
+      }
+    }
+
+    header.frame_sizes.push_back(frame_size);
+    total += frame_size;
+  }
+
+  if ((total + pos) > data_size)
+    return false;
+
+  header.frame_sizes.push_back(data_size - pos - total);
+  lace_header_size = pos;
+
+  return true;
+}
+
+bool
+kax_cluster_walker_c::read_block_header(element_header_t const &block,
+                                        kax_block_header_t &header) {
+  auto data_start = block.position + block.head_size;
+  auto to_read    = static_cast<std::size_t>(std::min<uint64_t>(block.size, 64));
+
+  // Most blocks only need the first four bytes. Laced blocks need the
+  // lace header as well which can be larger; read more in that case.
+  while (true) {
+    auto buffer = read_bytes(data_start, to_read);
+    if (!buffer)
+      return false;
+
+    auto track_number = uint64_t{};
+    auto track_length = parse_vint(buffer, to_read, track_number);
+    if (!track_length || ((track_length + 3) > to_read))
+      return false;
+
+    auto relative_timecode = static_cast<int16_t>((buffer[track_length] << 8) | buffer[track_length + 1]);
+    auto flags             = buffer[track_length + 2];
+    auto lacing            = flags & 0x06u;
+    auto header_size       = std::size_t{track_length + 3u};
+    auto data_size         = block.size - header_size;
+    auto lace_header_size  = std::size_t{};
+
+    if (!lacing)
+      header.frame_sizes.assign(1, data_size);
+
+    else if (!parse_lacing(buffer + header_size, to_read - header_size, data_size, lacing, header, lace_header_size)) {
+      if (to_read >= block.size)
+        return false;
+
+      to_read = static_cast<std::size_t>(std::min<uint64_t>(block.size, to_read * 8));
+      continue;
+    }
+
+    header.position      = block.position;
+    header.data_position = data_start + header_size + lace_header_size;
+    header.track_number  = track_number;
+    header.timecode      = (m_cluster_timecode + relative_timecode) * m_timecode_scale;
+    header.keyframe      = (flags & 0x80) == 0x80;
+    header.discardable   = (flags & 0x01) == 0x01;
+
+    return true;
+  }
+}
+
+bool
+kax_cluster_walker_c::handle_block_group(element_header_t const &group) {
+  auto header      = kax_block_header_t{};
+  auto block_found = false;
+  auto pos         = group.position + group.head_size;
+  auto end         = pos + group.size;
+
+  element_header_t child;
+
+  while (pos < end) {
+    if (!read_element_header(pos, child) || child.unknown_size)
+      return false;
+
+    if (child.id == EBML_ID_VALUE(EBML_ID(KaxBlock))) {
+      if (!read_block_header(child, header))
+        return false;
+      block_found = true;
+
+    } else if (child.id == EBML_ID_VALUE(EBML_ID(KaxBlockDuration))) {
+      auto duration = read_uint(child);
+      if (duration)
+        header.duration = static_cast<int64_t>(*duration * m_timecode_scale);
+
+    } else if (child.id == EBML_ID_VALUE(EBML_ID(KaxReferenceBlock)))
+      ++header.num_references;
+
+    else if (child.id == EBML_ID_VALUE(EBML_ID(KaxDiscardPadding)))
+      header.discard_padding = read_sint(child);
+
+    pos = child.position + child.head_size + child.size;
+  }
+
+  if (!block_found)
+    return true;
+
+  header.keyframe = !header.num_references;
+
+  if (m_block_handler)
+    m_block_handler(header);
+
+  return true;
+}
+
+bool
+kax_cluster_walker_c::walk_cluster(element_header_t const &cluster,
+                                   uint64_t end_pos,
+                                   uint64_t &next_pos) {
+  auto cluster_end = cluster.unknown_size ? end_pos : std::min(end_pos, cluster.position + cluster.head_size + cluster.size);
+  auto pos         = cluster.position + cluster.head_size;
+
+  m_cluster_timecode = 0;
+
+  element_header_t child;
+
+  while (pos < cluster_end) {
+    if (!read_element_header(pos, child))
+      return false;
+
+    // Clusters with an unknown size end where the next level 1
+    // element starts.
+    if (cluster.unknown_size && is_level1_element_id(child.id))
+      break;
+
+    if (child.unknown_size)
+      return false;
+
+    if (child.id == EBML_ID_VALUE(EBML_ID(KaxClusterTimecode))) {
+      auto timecode = read_uint(child);
+      if (!timecode)
+        return false;
+
+      m_cluster_timecode = *timecode;
+
+      if (m_cluster_handler && !m_cluster_handler(cluster.position, m_cluster_timecode * m_timecode_scale)) {
+        m_aborted = true;
+        break;
+      }
+
+    } else if (child.id == EBML_ID_VALUE(EBML_ID(KaxSimpleBlock))) {
+      auto header = kax_block_header_t{};
+      if (!read_block_header(child, header))
+        return false;
+
+      header.is_simple_block = true;
+
+      if (m_block_handler)
+        m_block_handler(header);
+
+    } else if (child.id == EBML_ID_VALUE(EBML_ID(KaxBlockGroup))) {
+      if (!handle_block_group(child))
+        return false;
+    }
+
+    pos = child.position + child.head_size + child.size;
+  }
+
+  next_pos = pos;
+
+  return true;
+}
+
+bool
+kax_cluster_walker_c::walk(uint64_t start_pos,
+                           uint64_t end_pos) {
+  end_pos   = std::min(end_pos, m_file_size);
+  m_aborted = false;
+
+  auto pos = start_pos;
+  element_header_t element;
+
+  while (!m_aborted && (pos < end_pos)) {
+    if (!read_element_header(pos, element)) {
+      mxdebug_if(m_debug, boost::format("invalid element header at %1%\n") % pos);
+      return false;
+    }
+
+    if (element.id == EBML_ID_VALUE(EBML_ID(KaxCluster))) {
+      if (!walk_cluster(element, end_pos, pos)) {
+        mxdebug_if(m_debug, boost::format("invalid cluster structure in cluster at %1%\n") % element.position);
+        return false;
+      }
+
+      continue;
+    }
+
+    auto is_known = is_level1_element_id(element.id)
+                 || (element.id == EBML_ID_VALUE(EBML_ID(EbmlVoid)))
+                 || (element.id == EBML_ID_VALUE(EBML_ID(EbmlCrc32)));
+
+    if (!is_known || element.unknown_size) {
+      mxdebug_if(m_debug, boost::format("unexpected level 1 element 0x%|1$x| at %2%\n") % element.id % pos);
+      return false;
+    }
+
+    pos = element.position + element.head_size + element.size;
+  }
+
+  return true;
+}
@@ -0,0 +1,83 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   walking clusters by reading block headers only
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_KAX_CLUSTER_WALKER_H
+#define MTX_COMMON_KAX_CLUSTER_WALKER_H
+
+#include "common/common_pch.h"
+
+struct kax_block_header_t {
+  uint64_t position, data_position, track_number;
+  int64_t timecode;
+  boost::optional<int64_t> duration, discard_padding;
+  unsigned int num_references;
+  bool is_simple_block, keyframe, discardable;
+  std::vector<uint64_t> frame_sizes;
+
+  kax_block_header_t();
+};
+
+// Walks over the clusters of a segment without reading the blocks'
+// payloads. Only the EBML element headers, the cluster timecodes,
+// the first few bytes of each (Simple)Block (track number, relative
+// timecode, flags and lacing information) and the small BlockGroup
+// children like BlockDuration and ReferenceBlock are read. Everything
+// else is skipped by seeking.
+class kax_cluster_walker_c {
+public:
+  using cluster_handler_t = std::function<bool(uint64_t, int64_t)>;
+  using block_handler_t   = std::function<void(kax_block_header_t const &)>;
+
+  struct element_header_t {
+    uint64_t position, id, size;
+    unsigned int head_size;
+    bool unknown_size;
+  };
+
+protected:
+  mm_io_c &m_in;
+  uint64_t m_file_size;
+  int64_t m_timecode_scale, m_cluster_timecode;
+  cluster_handler_t m_cluster_handler;
+  block_handler_t m_block_handler;
+  std::vector<unsigned char> m_buffer;
+  bool m_aborted;
+  debugging_option_c m_debug;
+
+public:
+  kax_cluster_walker_c(mm_io_c &in, int64_t timecode_scale);
+
+  kax_cluster_walker_c &set_cluster_handler(cluster_handler_t const &handler);
+  kax_cluster_walker_c &set_block_handler(block_handler_t const &handler);
+
+  // Walks all level 1 elements between start_pos and end_pos. The
+  // cluster handler is called with each cluster's position and
+  // timecode in ns; if it returns false then walking stops. Returns
+  // false if a structural error was found.
+  bool walk(uint64_t start_pos, uint64_t end_pos);
+
+  bool read_element_header(uint64_t position, element_header_t &header);
+
+  static bool is_level1_element_id(uint64_t id);
+
+protected:
+  bool walk_cluster(element_header_t const &cluster, uint64_t end_pos, uint64_t &next_pos);
+  bool handle_block_group(element_header_t const &group);
+  bool read_block_header(element_header_t const &block, kax_block_header_t &header);
+  bool parse_lacing(unsigned char const *buffer, std::size_t buffer_size, uint64_t data_size, unsigned int lacing, kax_block_header_t &header, std::size_t &lace_header_size);
+  boost::optional<uint64_t> read_uint(element_header_t const &element);
+  boost::optional<int64_t> read_sint(element_header_t const &element);
+  unsigned char const *read_bytes(uint64_t position, std::size_t size);
+};
+
+#endif  // MTX_COMMON_KAX_CLUSTER_WALKER_H
@@ -27,6 +27,7 @@
 #include "common/memory.h"
 #include "common/mm_io.h"
 #include "common/strings/parsing.h"
+#include "common/strings/utf8.h"
 #ifdef SYS_WINDOWS
 # include "common/fs_sys_helpers.h"
 # include "common/strings/formatting.h"
@@ -38,12 +39,14 @@ std::map<std::string, charset_converter_cptr> charset_converter_c::s_converters;
 
 charset_converter_c::charset_converter_c()
   : m_detect_byte_order_marker(false)
+  , m_ascii_compatible(false)
 {
 }
 
 charset_converter_c::charset_converter_c(const std::string &charset)
   : m_charset(charset)
   , m_detect_byte_order_marker(false)
+  , m_ascii_compatible(false)
 {
 }
 
@@ -116,6 +119,32 @@ charset_converter_c::handle_string_with_bom(const std::string &source,
   return true;
 }
 
+// Most character sets are supersets of ASCII. Strings consisting of
+// ASCII characters only don't have to be converted for them, which is
+// the case for most of the text in subtitles, chapters and tags.
+// Stateful seven bit encodings such as ISO-2022-JP, HZ or UTF-7 pass
+// single ASCII characters through, too, but not the sequences they
+// switch character sets with.
+// Must be called by derived classes once they're able to convert.
+void
+charset_converter_c::detect_ascii_compatibility() {
+  std::string ascii;
+  for (auto c = 1; 0x80 > c; ++c)
+    ascii += static_cast<char>(c);
+
+  std::vector<std::string> probes{ ascii, "\x1b$B\x30\x21\x1b(B", "\x1b$)A\x0e\x30\x21\x0f", "\x1b$)C\x0e\x30\x21\x0f", "~{\x30\x21~}", "+AGE-" };
+
+  m_ascii_compatible = std::all_of(probes.begin(), probes.end(), [this](std::string const &probe) {
+    return (utf8(probe) == probe) && (native(probe) == probe);
+  });
+}
+
+bool
+charset_converter_c::can_skip_conversion(const std::string &source)
+  const {
+  return m_ascii_compatible && is_ascii(source);
+}
+
 // ------------------------------------------------------------
 #if defined(HAVE_ICONV_H)
 
@@ -144,6 +173,9 @@ iconv_charset_converter_c::iconv_charset_converter_c(const std::string &charset)
     mxwarn(boost::format(Y("Could not initialize the iconv library for the conversion from UTF-8 to %1%. "
                            "Some strings cannot be converted from UTF-8 and might be displayed incorrectly (error: %2%, %3%).\n"))
            % charset % errno % strerror(errno));
+
+  if ((s_iconv_t_error_value != m_to_utf8_handle) && (s_iconv_t_error_value != m_from_utf8_handle))
+    detect_ascii_compatibility();
 }
 
 iconv_charset_converter_c::~iconv_charset_converter_c() {
@@ -160,39 +192,58 @@ iconv_charset_converter_c::utf8(const std::string &source) {
   if (handle_string_with_bom(source, recoded))
     return recoded;
 
+  // iconv_charset_converter_c::convert() stops at the first NUL, too.
+  if (!m_is_utf8 && can_skip_conversion(source))
+    return source.c_str();
+
   return m_is_utf8 ? source : iconv_charset_converter_c::convert(m_to_utf8_handle, source);
 }
 
 std::string
 iconv_charset_converter_c::native(const std::string &source) {
+  if (!m_is_utf8 && can_skip_conversion(source))
+    return source.c_str();
+
   return m_is_utf8 ? source : iconv_charset_converter_c::convert(m_from_utf8_handle, source);
 }
 
 std::string
 iconv_charset_converter_c::convert(iconv_t handle,
                                    const std::string &source) {
-  if (s_iconv_t_error_value == handle)
+  if ((s_iconv_t_error_value == handle) || source.empty())
     return source;
 
-  int length        = source.length() * 4;
-  char *destination = (char *)safemalloc(length + 1);
-  memset(destination, 0, length + 1);
-
   iconv(handle, nullptr, 0, nullptr, 0); // Reset the iconv state.
 
-  size_t length_source      = length / 4;
-  size_t length_destination = length;
-  char *source_copy         = safestrdup(source.c_str());
-  char *ptr_source          = source_copy;
-  char *ptr_destination     = destination;
-  iconv(handle, (ICONV_CONST char **)&ptr_source, &length_source, &ptr_destination, &length_destination);
-  iconv(handle, nullptr, nullptr, &ptr_destination, &length_destination);
+  // The whole buffer is converted in one go. The destination only
+  // grows if the initial estimate is too small.
+  std::string destination(source.length() * 4 + 16, '\0');
+  size_t length_source = source.length();
+  char *ptr_source     = const_cast<char *>(source.c_str());
+  size_t converted     = 0;
+  bool flush           = false;
+
+  while (true) {
+    char *ptr_destination     = &destination[converted];
+    size_t length_destination = destination.length() - converted;
+    auto result               = flush ? iconv(handle, nullptr, nullptr, &ptr_destination, &length_destination)
+                              :         iconv(handle, (ICONV_CONST char **)&ptr_source, &length_source, &ptr_destination, &length_destination);
+    converted                 = ptr_destination - destination.c_str();
+
+    if ((static_cast<size_t>(-1) == result) && (E2BIG == errno))
+      destination.resize(destination.length() * 2);
+
+    else if (flush)
+      break;
+
+    else
+      flush = true;
+  }
 
-  safefree(source_copy);
-  std::string result = destination;
-  safefree(destination);
+  // Conversion results have always ended at the first NUL.
+  destination.resize(std::min(converted, destination.find('\0')));
 
-  return result;
+  return destination;
 }
 
 bool
@@ -219,6 +270,8 @@ windows_charset_converter_c::windows_charset_converter_c(const std::string &char
   , m_is_utf8(is_utf8_charset_name(charset))
   , m_code_page(extract_code_page(charset))
 {
+  if (!m_is_utf8)
+    detect_ascii_compatibility();
 }
 
 windows_charset_converter_c::~windows_charset_converter_c() {
@@ -230,11 +283,18 @@ windows_charset_converter_c::utf8(const std::string &source) {
   if (handle_string_with_bom(source, recoded))
     return recoded;
 
+  // windows_charset_converter_c::convert() stops at the first NUL, too.
+  if (!m_is_utf8 && can_skip_conversion(source))
+    return source.c_str();
+
   return m_is_utf8 ? source : windows_charset_converter_c::convert(m_code_page, CP_UTF8, source);
 }
 
 std::string
 windows_charset_converter_c::native(const std::string &source) {
+  if (!m_is_utf8 && can_skip_conversion(source))
+    return source.c_str();
+
   return m_is_utf8 ? source : windows_charset_converter_c::convert(CP_UTF8, m_code_page, source);
 }
 
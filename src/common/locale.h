@@ -24,7 +24,7 @@ using charset_converter_cptr = std::shared_ptr<charset_converter_c>;
 class charset_converter_c {
 protected:
   std::string m_charset;
-  bool m_detect_byte_order_marker;
+  bool m_detect_byte_order_marker, m_ascii_compatible;
 
 public:
   charset_converter_c();
@@ -38,6 +38,8 @@ public:
 
 protected:
   bool handle_string_with_bom(const std::string &source, std::string &recoded);
+  void detect_ascii_compatibility();
+  bool can_skip_conversion(const std::string &source) const;
 
 public:                         // Static members
   static charset_converter_cptr init(const std::string &charset);
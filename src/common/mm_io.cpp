@@ -27,6 +27,7 @@
 #include "common/error.h"
 #include "common/fs_sys_helpers.h"
 #include "common/mm_io.h"
+#include "common/mm_io_statistics.h"
 #include "common/mm_io_x.h"
 #include "common/strings/editing.h"
 #include "common/strings/parsing.h"
@@ -73,6 +74,8 @@ mm_file_io_c::mm_file_io_c(const std::string &path,
 
   if (!m_file)
     throw mtx::mm_io::open_x{mtx::mm_io::make_error_code()};
+
+  enable_statistics("file");
 }
 
 void
@@ -82,10 +85,16 @@ mm_file_io_c::setFilePointer(int64 offset,
              : mode == seek_end       ? SEEK_END
              :                          SEEK_CUR;
 
+  mtx::mm_io::blocked_timer_c timer{m_statistics.get()};
+  auto previous_position = m_current_position;
+
   if (fseeko((FILE *)m_file, offset, whence) != 0)
     throw mtx::mm_io::seek_x{mtx::mm_io::make_error_code()};
 
   m_current_position = ftello((FILE *)m_file);
+
+  if (m_statistics)
+    m_statistics->add_seek(previous_position, m_current_position);
 }
 
 size_t
@@ -189,6 +198,21 @@ mm_file_io_c::open(const std::string &path,
    Abstract base class.
 */
 
+mm_io_c::~mm_io_c() {
+  if (m_statistics && mtx::mm_io::statistics_c::is_debugging_enabled() && !m_statistics->is_empty())
+    mxdebug(m_statistics->format());
+}
+
+void
+mm_io_c::enable_statistics(std::string const &layer) {
+  // Derived classes such as mm_mpls_multi_file_io_c replace the
+  // statistics of their base class.
+  if (m_statistics)
+    mtx::mm_io::statistics_c::discard(m_statistics);
+
+  m_statistics = mtx::mm_io::statistics_c::create(layer, get_file_name());
+}
+
 std::string
 mm_io_c::getline() {
   char c;
@@ -275,7 +299,14 @@ mm_io_c::read(size_t size) {
 uint32_t
 mm_io_c::read(void *buffer,
               size_t size) {
-  return _read(buffer, size);
+  if (!m_statistics)
+    return _read(buffer, size);
+
+  mtx::mm_io::blocked_timer_c timer{m_statistics.get()};
+  auto num_read = _read(buffer, size);
+  m_statistics->add_read(num_read);
+
+  return num_read;
 }
 
 uint32_t
@@ -501,7 +532,14 @@ mm_io_c::write(std::string const &buffer) {
 size_t
 mm_io_c::write(const void *buffer,
                size_t size) {
-  return _write(buffer, size);
+  if (!m_statistics)
+    return _write(buffer, size);
+
+  mtx::mm_io::blocked_timer_c timer{m_statistics.get()};
+  auto num_written = _write(buffer, size);
+  m_statistics->add_write(num_written);
+
+  return num_written;
 }
 
 size_t
@@ -868,6 +906,142 @@ mm_mem_io_c::get_content()
    Class for handling UTF-8/UTF-16/UTF-32 text files.
 */
 
+// 1 byte: 0xxxxxxx,
+// 2 bytes: 110xxxxx 10xxxxxx,
+// 3 bytes: 1110xxxx 10xxxxxx 10xxxxxx
+// 4 bytes: 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+
+static size_t
+utf8_sequence_length(unsigned char lead) {
+  return ((lead & 0x80) == 0x00) ?  1
+       : ((lead & 0xe0) == 0xc0) ?  2
+       : ((lead & 0xf0) == 0xe0) ?  3
+       : ((lead & 0xf8) == 0xf0) ?  4
+       : ((lead & 0xfc) == 0xf8) ?  5
+       : ((lead & 0xfe) == 0xfc) ?  6
+       :                           99;
+}
+
+static int
+put_utf8(char *buffer,
+         uint32_t code) {
+  if (code < 0x80) {
+    buffer[0] = code;
+    return 1;
+  }
+
+  if (code < 0x800) {
+    buffer[0] = 0xc0 | (code >> 6);
+    buffer[1] = 0x80 | (code & 0x3f);
+    return 2;
+  }
+
+  // Code points beyond Unicode's range are replaced by U+FFFD.
+  if (code >= 0x110000)
+    code = 0xfffd;
+
+  if (code < 0x10000) {
+    buffer[0] = 0xe0 |  (code >> 12);
+    buffer[1] = 0x80 | ((code >>  6) & 0x3f);
+    buffer[2] = 0x80 |  (code        & 0x3f);
+    return 3;
+  }
+
+  buffer[0] = 0xf0 |  (code >> 18);
+  buffer[1] = 0x80 | ((code >> 12) & 0x3f);
+  buffer[2] = 0x80 | ((code >>  6) & 0x3f);
+  buffer[3] = 0x80 |  (code        & 0x3f);
+  return 4;
+}
+
+static unsigned int
+get_code_unit_size(byte_order_e byte_order) {
+  return (BO_UTF16_LE == byte_order) || (BO_UTF16_BE == byte_order) ? 2
+       : (BO_UTF32_LE == byte_order) || (BO_UTF32_BE == byte_order) ? 4
+       :                                                              1;
+}
+
+static uint32_t
+get_code_unit(unsigned char const *buffer,
+              byte_order_e byte_order) {
+  return BO_UTF16_LE == byte_order ? get_uint16_le(buffer)
+       : BO_UTF16_BE == byte_order ? get_uint16_be(buffer)
+       : BO_UTF32_LE == byte_order ? get_uint32_le(buffer)
+       : BO_UTF32_BE == byte_order ? get_uint32_be(buffer)
+       :                             buffer[0];
+}
+
+// Returns the first carriage return in [start, end) or, if
+// 'stop_at_newlines' is set, the first newline, whichever comes
+// first. Returns 'end' if there's none.
+static unsigned char const *
+find_line_break(unsigned char const *start,
+                unsigned char const *end,
+                bool stop_at_newlines) {
+  auto stop = end;
+
+  if (stop_at_newlines) {
+    auto newline = static_cast<unsigned char const *>(memchr(start, '\n', end - start));
+    if (newline)
+      stop = newline;
+  }
+
+  auto carriage_return = static_cast<unsigned char const *>(memchr(start, '\r', stop - start));
+
+  return carriage_return ? carriage_return : stop;
+}
+
+// Skips all UTF-8 sequences starting in [start, end). Returns the
+// position after the last one, which may lie beyond 'end' if the last
+// sequence crosses it, or the start of the last sequence if it isn't
+// complete within [start, limit).
+static unsigned char const *
+skip_utf8_sequences(unsigned char const *start,
+                    unsigned char const *end,
+                    unsigned char const *limit) {
+  auto pos = start;
+
+  while (pos < end) {
+    // Skip runs of ASCII characters eight at a time.
+    uint64_t block;
+    while (((pos + 8) <= end) && (memcpy(&block, pos, 8), !(block & 0x8080808080808080ull)))
+      pos += 8;
+
+    if (pos >= end)
+      break;
+
+    if (*pos < 0x80) {
+      ++pos;
+      continue;
+    }
+
+    auto length = utf8_sequence_length(*pos);
+    if (99 == length)
+      throw mtx::mm_io::text::invalid_utf8_char_x(*pos);
+
+    if ((pos + length) > limit)
+      break;
+
+    pos += length;
+  }
+
+  return pos;
+}
+
+static void
+append_without_nul(std::string &line,
+                   unsigned char const *start,
+                   unsigned char const *end) {
+  if (start == end)
+    return;
+
+  auto previous_size = line.size();
+  line.append(reinterpret_cast<char const *>(start), end - start);
+
+  if (memchr(start, 0, end - start))
+    line.erase(std::remove(line.begin() + previous_size, line.end(), '\0'), line.end());
+}
+
 mm_text_io_c::mm_text_io_c(mm_io_c *in,
                            bool delete_in)
   : mm_proxy_io_c(in, delete_in)
@@ -876,6 +1050,9 @@ mm_text_io_c::mm_text_io_c(mm_io_c *in,
   , m_uses_carriage_returns(false)
   , m_uses_newlines(false)
   , m_eol_style_detected(false)
+  , m_buffer(memory_c::alloc(ms_buffer_size))
+  , m_buffer_fill(0)
+  , m_buffer_offset(0)
 {
   in->setFilePointer(0, seek_beginning);
 
@@ -957,10 +1134,6 @@ mm_text_io_c::has_byte_order_marker(const std::string &string) {
   return detect_byte_order_marker(reinterpret_cast<const unsigned char *>(string.c_str()), string.length(), byte_order, bom_length);
 }
 
-// 1 byte: 0xxxxxxx,
-// 2 bytes: 110xxxxx 10xxxxxx,
-// 3 bytes: 1110xxxx 10xxxxxx 10xxxxxx
-
 int
 mm_text_io_c::read_next_char(char *buffer) {
   if (BO_NONE == m_byte_order)
@@ -972,13 +1145,7 @@ mm_text_io_c::read_next_char(char *buffer) {
     if (read(stream, 1) != 1)
       return 0;
 
-    size = ((stream[0] & 0x80) == 0x00) ?  1
-         : ((stream[0] & 0xe0) == 0xc0) ?  2
-         : ((stream[0] & 0xf0) == 0xe0) ?  3
-         : ((stream[0] & 0xf8) == 0xf0) ?  4
-         : ((stream[0] & 0xfc) == 0xf8) ?  5
-         : ((stream[0] & 0xfe) == 0xfc) ?  6
-         :                                99;
+    size = utf8_sequence_length(stream[0]);
 
     if (99 == size)
       throw mtx::mm_io::text::invalid_utf8_char_x(stream[0]);
@@ -989,44 +1156,26 @@ mm_text_io_c::read_next_char(char *buffer) {
     memcpy(buffer, stream, size);
 
     return size;
+  }
 
-  } else if ((BO_UTF16_LE == m_byte_order) || (BO_UTF16_BE == m_byte_order))
-    size = 2;
-  else
-    size = 4;
+  size = get_code_unit_size(m_byte_order);
 
   if (read(stream, size) != size)
     return 0;
 
-  unsigned long data = 0;
-  auto little_endian = ((BO_UTF16_LE == m_byte_order) || (BO_UTF32_LE == m_byte_order));
-  auto shift         = little_endian ? 0 : 8 * (size - 1);
-  for (auto i = 0u; i < size; i++) {
-    data  |= static_cast<unsigned long>(stream[i]) << shift;
-    shift += little_endian ? 8 : -8;
-  }
-
-  if (data < 0x80) {
-    buffer[0] = data;
-    return 1;
-  }
-
-  if (data < 0x800) {
-    buffer[0] = 0xc0 | (data >> 6);
-    buffer[1] = 0x80 | (data & 0x3f);
-    return 2;
-  }
+  auto data = get_code_unit(stream, m_byte_order);
 
-  if (data < 0x10000) {
-    buffer[0] = 0xe0 |  (data >> 12);
-    buffer[1] = 0x80 | ((data >> 6) & 0x3f);
-    buffer[2] = 0x80 |  (data       & 0x3f);
-    return 3;
+  // Combine UTF-16 surrogate pairs. Unpaired surrogates are passed
+  // through.
+  if ((2 == size) && (0xd800 <= data) && (0xdc00 > data) && (read(stream, 2) == 2)) {
+    auto low = get_code_unit(stream, m_byte_order);
+    if ((0xdc00 <= low) && (0xe000 > low))
+      data = 0x10000 + ((data - 0xd800) << 10) + (low - 0xdc00);
+    else
+      setFilePointer(-2, seek_current);
   }
 
-  mxerror(Y("mm_text_io_c: UTF32_* is not supported at the moment.\n"));
-
-  return 0;
+  return put_utf8(buffer, data);
 }
 
 std::string
@@ -1038,50 +1187,253 @@ mm_text_io_c::getline() {
     detect_eol_style();
 
   std::string s;
-  char utf8char[9];
   bool previous_was_carriage_return = false;
 
   while (1) {
-    memset(utf8char, 0, 9);
+    if (!previous_was_carriage_return)
+      append_up_to_line_break(s);
 
-    int len = read_next_char(utf8char);
-    if (0 == len)
+    size_t num_bytes = 0;
+    auto line_break  = peek_line_break(num_bytes);
+
+    if (-1 == line_break)
       return s;
 
-    if ((1 == len) && (utf8char[0] == '\r')) {
-      if (previous_was_carriage_return && !m_uses_newlines) {
-        setFilePointer(-1, seek_current);
+    if ('\r' == line_break) {
+      if (previous_was_carriage_return && !m_uses_newlines)
         return s;
-      }
 
-      previous_was_carriage_return = true;
+      m_buffer_offset              += num_bytes;
+      previous_was_carriage_return  = true;
       continue;
     }
 
-    if ((1 == len) && (utf8char[0] == '\n') && (!m_uses_carriage_returns || previous_was_carriage_return))
-      return s;
+    // Without a preceding carriage return only a newline ends up
+    // here; others are part of the line in files using carriage
+    // returns.
+    if ('\n' == line_break)
+      m_buffer_offset += num_bytes;
 
-    if (previous_was_carriage_return) {
-      setFilePointer(-len, seek_current);
-      return s;
+    return s;
+  }
+}
+
+// Appends everything up to the next character ending a line: a
+// carriage return or, unless the file uses carriage returns, a
+// newline. The buffer is left positioned on that character or at the
+// end of the file.
+void
+mm_text_io_c::append_up_to_line_break(std::string &line) {
+  auto unit_size = get_code_unit_size(m_byte_order);
+
+  while (1) {
+    if ((m_buffer_offset >= m_buffer_fill) && !fill_buffer())
+      return;
+
+    auto buffer = m_buffer->get_buffer();
+    auto start  = buffer + m_buffer_offset;
+    auto end    = buffer + m_buffer_fill;
+
+    if (1 == unit_size) {
+      unsigned char const *pos = start, *stop;
+
+      // Invalid UTF-8 sequences may contain line break bytes. Like
+      // read_next_char() they're part of the sequence then.
+      do {
+        stop = find_line_break(pos, end, !m_uses_carriage_returns);
+        pos  = BO_UTF8 == m_byte_order ? skip_utf8_sequences(pos, stop, end) : stop;
+      } while ((pos > stop) && (pos < end));
+
+      append_without_nul(line, start, pos);
+      m_buffer_offset = pos - buffer;
+
+      if ((pos == stop) && (stop < end))
+        return;
+
+    } else {
+      auto pos           = start;
+      auto at_line_break = false;
+      char utf8[1024];
+      size_t utf8_size   = 0;
+
+      while ((pos + unit_size) <= end) {
+        auto code = get_code_unit(pos, m_byte_order);
+        auto size = unit_size;
+
+        if (('\r' == code) || (('\n' == code) && !m_uses_carriage_returns)) {
+          at_line_break = true;
+          break;
+        }
+
+        if ((2 == unit_size) && (0xd800 <= code) && (0xdc00 > code)) {
+          if ((pos + 4) > end)
+            break;
+
+          auto low = get_code_unit(pos + 2, m_byte_order);
+          if ((0xdc00 <= low) && (0xe000 > low)) {
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+            size = 4;
+          }
+        }
+
+        if (code >= 0x80)
+          utf8_size += put_utf8(&utf8[utf8_size], code);
+        else if (code)
+          utf8[utf8_size++] = code;
+
+        pos += size;
+
+        if (utf8_size > (sizeof(utf8) - 4)) {
+          line.append(utf8, utf8_size);
+          utf8_size = 0;
+        }
+      }
+
+      line.append(utf8, utf8_size);
+      m_buffer_offset = pos - buffer;
+
+      if (at_line_break)
+        return;
+    }
+
+    // An incomplete character at the end of the file is dropped.
+    if ((m_buffer_offset < m_buffer_fill) && !fill_buffer()) {
+      m_buffer_offset = m_buffer_fill;
+      return;
     }
+  }
+}
 
-    previous_was_carriage_return  = false;
-    s                            += utf8char;
+// Returns the character at the current position if it's a carriage
+// return or a newline, 0 for any other character and -1 at the end of
+// the file. 'num_bytes' is set to the character's size in the file.
+int
+mm_text_io_c::peek_line_break(size_t &num_bytes) {
+  num_bytes = get_code_unit_size(m_byte_order);
+
+  while ((m_buffer_fill - m_buffer_offset) < num_bytes)
+    if (!fill_buffer()) {
+      m_buffer_offset = m_buffer_fill;
+      return -1;
+    }
+
+  auto code = get_code_unit(m_buffer->get_buffer() + m_buffer_offset, m_byte_order);
+
+  // An incomplete UTF-8 sequence at the end of the file counts as the
+  // end of the file, too.
+  if ((BO_UTF8 == m_byte_order) && (0x80 <= code)) {
+    auto length = utf8_sequence_length(code);
+
+    while ((99 != length) && ((m_buffer_fill - m_buffer_offset) < length))
+      if (!fill_buffer()) {
+        m_buffer_offset = m_buffer_fill;
+        return -1;
+      }
   }
+
+  return ('\r' == code) || ('\n' == code) ? static_cast<int>(code) : 0;
+}
+
+// Moves the unread part of the buffer to its start and appends data
+// from the proxied file. Returns false if nothing could be read.
+bool
+mm_text_io_c::fill_buffer() {
+  auto buffer    = m_buffer->get_buffer();
+  auto remaining = m_buffer_fill - m_buffer_offset;
+
+  if (remaining && m_buffer_offset)
+    memmove(buffer, buffer + m_buffer_offset, remaining);
+
+  m_buffer_fill   = remaining;
+  m_buffer_offset = 0;
+
+  auto num_read   = m_proxy_io->read(buffer + m_buffer_fill, ms_buffer_size - m_buffer_fill);
+  m_buffer_fill  += num_read;
+
+  return 0 != num_read;
+}
+
+uint32
+mm_text_io_c::_read(void *buffer,
+                    size_t size) {
+  auto dest       = static_cast<unsigned char *>(buffer);
+  size_t num_read = 0;
+
+  while (num_read < size) {
+    auto avail = std::min(size - num_read, m_buffer_fill - m_buffer_offset);
+
+    if (avail) {
+      memcpy(dest + num_read, m_buffer->get_buffer() + m_buffer_offset, avail);
+      num_read        += avail;
+      m_buffer_offset += avail;
+
+    } else if ((size - num_read) >= ms_buffer_size) {
+      // Large requests bypass the buffer.
+      m_buffer_fill = m_buffer_offset = 0;
+      num_read     += m_proxy_io->read(dest + num_read, size - num_read);
+      break;
+
+    } else if (!fill_buffer())
+      break;
+  }
+
+  return num_read;
+}
+
+size_t
+mm_text_io_c::_write(const void *buffer,
+                     size_t size) {
+  if (m_buffer_fill) {
+    auto position = getFilePointer();
+    m_buffer_fill = m_buffer_offset = 0;
+    m_proxy_io->setFilePointer(position, seek_beginning);
+  }
+
+  return mm_proxy_io_c::_write(buffer, size);
+}
+
+uint64
+mm_text_io_c::getFilePointer() {
+  return m_proxy_io->getFilePointer() - (m_buffer_fill - m_buffer_offset);
 }
 
 void
 mm_text_io_c::setFilePointer(int64 offset,
                              seek_mode mode) {
-  mm_proxy_io_c::setFilePointer(((0 == offset) && (seek_beginning == mode)) ? m_bom_len : offset, mode);
+  if ((0 == offset) && (seek_beginning == mode))
+    offset = m_bom_len;
+
+  else if (seek_current == mode) {
+    offset += getFilePointer();
+    mode    = seek_beginning;
+  }
+
+  if (seek_beginning == mode) {
+    auto buffer_end   = static_cast<int64_t>(m_proxy_io->getFilePointer());
+    auto buffer_start = buffer_end - static_cast<int64_t>(m_buffer_fill);
+
+    if ((buffer_start <= offset) && (offset < buffer_end)) {
+      m_buffer_offset = offset - buffer_start;
+      return;
+    }
+  }
+
+  m_buffer_fill = m_buffer_offset = 0;
+  m_proxy_io->setFilePointer(offset, mode);
+}
+
+bool
+mm_text_io_c::eof() {
+  return (m_buffer_offset >= m_buffer_fill) && mm_proxy_io_c::eof();
 }
 
 /*
    Class for reading from stdin & writing to stdout.
 */
 
-mm_stdio_c::mm_stdio_c() {
+mm_stdio_c::mm_stdio_c(bool use_stderr)
+  : m_use_stderr{use_stderr}
+{
 }
 
 uint64
@@ -1106,7 +1458,7 @@ mm_stdio_c::_write(const void *buffer,
                    size_t size) {
   m_cached_size = -1;
 
-  return fwrite(buffer, 1, size, stdout);
+  return fwrite(buffer, 1, size, m_use_stderr ? stderr : stdout);
 }
 #endif // defined(SYS_WINDOWS)
 
@@ -1116,5 +1468,5 @@ mm_stdio_c::close() {
 
 void
 mm_stdio_c::flush() {
-  fflush(stdout);
+  fflush(m_use_stderr ? stderr : stdout);
 }
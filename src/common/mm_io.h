@@ -28,12 +28,17 @@ using mm_io_cptr = std::shared_ptr<mm_io_c>;
 class charset_converter_c;
 using charset_converter_cptr = std::shared_ptr<charset_converter_c>;
 
+namespace mtx { namespace mm_io {
+class statistics_c;
+}}
+
 class mm_io_c: public IOCallback {
 protected:
   bool m_dos_style_newlines, m_bom_written;
   std::stack<int64_t> m_positions;
   int64_t m_current_position, m_cached_size;
   charset_converter_cptr m_string_output_converter;
+  std::shared_ptr<mtx::mm_io::statistics_c> m_statistics;
 
 public:
   mm_io_c()
@@ -43,7 +48,7 @@ public:
     , m_cached_size(-1)
   {
   }
-  virtual ~mm_io_c() { }
+  virtual ~mm_io_c();
 
   virtual uint64 getFilePointer() = 0;
   virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning) = 0;
@@ -83,6 +88,10 @@ public:
   virtual int truncate(int64_t) {
     return 0;
   }
+  // Releases file handles and buffers until the next access. Only
+  // implemented by classes that can re-acquire them transparently.
+  virtual void suspend() {
+  }
 
   virtual std::string get_file_name() const = 0;
 
@@ -114,9 +123,18 @@ public:
   virtual void enable_buffering(bool /* enable */) {
   }
 
+  // nullptr unless statistics are being collected.
+  mtx::mm_io::statistics_c const *get_statistics() const {
+    return m_statistics.get();
+  }
+
 protected:
   virtual uint32 _read(void *buffer, size_t size) = 0;
   virtual size_t _write(const void *buffer, size_t size) = 0;
+
+  // Starts counting reads, writes and seeks if profiling or the
+  // debugging option "io_statistics" is enabled.
+  void enable_statistics(std::string const &layer);
 };
 
 class mm_file_io_c: public mm_io_c {
@@ -189,6 +207,10 @@ public:
     return m_proxy_io->eof();
   }
   virtual void close();
+  virtual void suspend() {
+    if (m_proxy_io)
+      m_proxy_io->suspend();
+  }
   virtual std::string get_file_name() const {
     return m_proxy_io->get_file_name();
   }
@@ -268,10 +290,19 @@ protected:
   unsigned int m_bom_len;
   bool m_uses_carriage_returns, m_uses_newlines, m_eol_style_detected;
 
+  // Data read ahead from the proxied file. The proxied file is
+  // positioned after the last byte in the buffer.
+  memory_cptr m_buffer;
+  size_t m_buffer_fill, m_buffer_offset;
+
+  static size_t const ms_buffer_size = 64 * 1024;
+
 public:
   mm_text_io_c(mm_io_c *in, bool delete_in = true);
 
+  virtual uint64 getFilePointer();
   virtual void setFilePointer(int64 offset, seek_mode mode=seek_beginning);
+  virtual bool eof();
   virtual std::string getline();
   virtual int read_next_char(char *buffer);
   virtual byte_order_e get_byte_order() const {
@@ -287,6 +318,13 @@ public:
 protected:
   virtual void detect_eol_style();
 
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+
+  bool fill_buffer();
+  void append_up_to_line_break(std::string &line);
+  int peek_line_break(size_t &num_bytes);
+
 public:
   static bool has_byte_order_marker(const std::string &string);
   static bool detect_byte_order_marker(const unsigned char *buffer, unsigned int size, byte_order_e &byte_order, unsigned int &bom_length);
@@ -295,8 +333,11 @@ public:
 using mm_text_io_cptr = std::shared_ptr<mm_text_io_c>;
 
 class mm_stdio_c: public mm_io_c {
+protected:
+  bool m_use_stderr;
+
 public:
-  mm_stdio_c();
+  mm_stdio_c(bool use_stderr = false);
 
   virtual uint64 getFilePointer();
   virtual void setFilePointer(int64 offset, seek_mode mode=seek_beginning);
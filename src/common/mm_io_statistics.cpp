@@ -0,0 +1,130 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   counting what the I/O classes do
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/mm_io_statistics.h"
+#include "common/profiling.h"
+
+namespace mtx { namespace mm_io {
+
+std::vector<statistics_cptr> statistics_c::ms_statistics;
+std::mutex statistics_c::ms_mutex;
+
+statistics_c::statistics_c(std::string const &layer,
+                           std::string const &file_name)
+  : m_layer{layer}
+  , m_file_name{file_name}
+  , m_num_reads{}
+  , m_num_bytes_read{}
+  , m_num_writes{}
+  , m_num_bytes_written{}
+  , m_num_seeks{}
+  , m_seek_distance{}
+  , m_num_buffer_hits{}
+  , m_num_buffer_misses{}
+  , m_num_nanoseconds_blocked{}
+{
+}
+
+bool
+statistics_c::is_debugging_enabled() {
+  static debugging_option_c s_debug{"io_statistics"};
+  return s_debug;
+}
+
+statistics_cptr
+statistics_c::create(std::string const &layer,
+                     std::string const &file_name) {
+  if (!g_profiler.is_enabled() && !is_debugging_enabled())
+    return {};
+
+  auto statistics = std::make_shared<statistics_c>(layer, file_name);
+
+  // With debugging only each file's statistics are output when it is
+  // closed. They don't have to be kept around.
+  if (g_profiler.is_enabled()) {
+    std::lock_guard<std::mutex> lock{ms_mutex};
+    ms_statistics.push_back(statistics);
+  }
+
+  return statistics;
+}
+
+void
+statistics_c::discard(statistics_cptr const &statistics) {
+  std::lock_guard<std::mutex> lock{ms_mutex};
+  ms_statistics.erase(std::remove(ms_statistics.begin(), ms_statistics.end(), statistics), ms_statistics.end());
+}
+
+bool
+statistics_c::is_empty()
+  const {
+  return !m_num_reads && !m_num_writes && !m_num_seeks;
+}
+
+std::string
+statistics_c::format()
+  const {
+  auto result = (boost::format("%1% '%2%': %3% reads (%4% bytes), %5% writes (%6% bytes), %7% seeks (distance %8%)")
+                 % m_layer % m_file_name % m_num_reads % m_num_bytes_read % m_num_writes % m_num_bytes_written % m_num_seeks % m_seek_distance).str();
+
+  if (m_num_buffer_hits || m_num_buffer_misses)
+    result += (boost::format(", buffer %1% hits %2% misses") % m_num_buffer_hits % m_num_buffer_misses).str();
+
+  return result + (boost::format(", %|1$.3f|s blocked\n") % (m_num_nanoseconds_blocked / 1000000000.0)).str();
+}
+
+nlohmann::json
+statistics_c::to_json()
+  const {
+  return nlohmann::json{
+    { "layer",               m_layer                   },
+    { "file_name",           m_file_name               },
+    { "reads",               m_num_reads               },
+    { "bytes_read",          m_num_bytes_read          },
+    { "writes",              m_num_writes              },
+    { "bytes_written",       m_num_bytes_written       },
+    { "seeks",               m_num_seeks               },
+    { "seek_distance",       m_seek_distance           },
+    { "buffer_hits",         m_num_buffer_hits         },
+    { "buffer_misses",       m_num_buffer_misses       },
+    { "nanoseconds_blocked", m_num_nanoseconds_blocked },
+  };
+}
+
+std::string
+statistics_c::format_all() {
+  std::lock_guard<std::mutex> lock{ms_mutex};
+  std::string result;
+
+  for (auto const &statistics : ms_statistics)
+    if (!statistics->is_empty())
+      result += statistics->format();
+
+  return result;
+}
+
+nlohmann::json
+statistics_c::all_to_json() {
+  std::lock_guard<std::mutex> lock{ms_mutex};
+  auto result = nlohmann::json::array();
+
+  for (auto const &statistics : ms_statistics)
+    if (!statistics->is_empty())
+      result.push_back(statistics->to_json());
+
+  return result;
+}
+
+}}
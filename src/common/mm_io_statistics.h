@@ -0,0 +1,111 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   counting what the I/O classes do
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_IO_STATISTICS_H
+#define MTX_COMMON_MM_IO_STATISTICS_H
+
+#include "common/common_pch.h"
+
+#include <chrono>
+#include <mutex>
+
+#include "nlohmann-json/src/json.hpp"
+
+namespace mtx { namespace mm_io {
+
+class statistics_c;
+using statistics_cptr = std::shared_ptr<statistics_c>;
+
+// Statistics for one I/O object, e.g. the read buffer on top of an
+// input file or the file itself. Each layer counts the calls made to
+// it, so comparing the layers of one file shows how well the buffers
+// work. The time blocked includes the time spent in the layers
+// below.
+class statistics_c {
+public:
+  std::string const m_layer, m_file_name;
+  uint64_t m_num_reads, m_num_bytes_read, m_num_writes, m_num_bytes_written;
+  uint64_t m_num_seeks, m_seek_distance, m_num_buffer_hits, m_num_buffer_misses;
+  uint64_t m_num_nanoseconds_blocked;
+
+protected:
+  // Only kept for the profile. Files may be opened from worker threads.
+  static std::vector<statistics_cptr> ms_statistics;
+  static std::mutex ms_mutex;
+
+public:
+  statistics_c(std::string const &layer, std::string const &file_name);
+
+  inline void
+  add_read(uint64_t num_bytes) {
+    ++m_num_reads;
+    m_num_bytes_read += num_bytes;
+  }
+
+  inline void
+  add_write(uint64_t num_bytes) {
+    ++m_num_writes;
+    m_num_bytes_written += num_bytes;
+  }
+
+  inline void
+  add_seek(uint64_t from,
+           uint64_t to) {
+    if (from == to)
+      return;
+
+    ++m_num_seeks;
+    m_seek_distance += from < to ? to - from : from - to;
+  }
+
+  bool is_empty() const;
+  std::string format() const;
+  nlohmann::json to_json() const;
+
+  // Returns nullptr unless either profiling or the debugging option
+  // "io_statistics" is enabled.
+  static statistics_cptr create(std::string const &layer, std::string const &file_name);
+  // Removes statistics replaced by a derived class's own layer.
+  static void discard(statistics_cptr const &statistics);
+  static bool is_debugging_enabled();
+
+  // All I/O objects created so far including the ones already closed
+  // but excluding the ones that haven't done anything.
+  static std::string format_all();
+  static nlohmann::json all_to_json();
+};
+
+// Adds the time until it goes out of scope to the statistics'
+// blocked time. Does nothing for nullptr statistics.
+class blocked_timer_c {
+protected:
+  statistics_c *m_statistics;
+  std::chrono::steady_clock::time_point m_start;
+
+public:
+  blocked_timer_c(statistics_c *statistics)
+    : m_statistics{statistics}
+  {
+    if (m_statistics)
+      m_start = std::chrono::steady_clock::now();
+  }
+
+  ~blocked_timer_c() {
+    if (m_statistics)
+      m_statistics->m_num_nanoseconds_blocked += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+  }
+};
+
+}}
+
+#endif  // MTX_COMMON_MM_IO_STATISTICS_H
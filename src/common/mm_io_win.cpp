@@ -29,6 +29,7 @@
 #include "common/error.h"
 #include "common/fs_sys_helpers.h"
 #include "common/mm_io.h"
+#include "common/mm_io_statistics.h"
 #include "common/mm_io_x.h"
 #include "common/strings/editing.h"
 #include "common/strings/parsing.h"
@@ -76,6 +77,8 @@ mm_file_io_c::mm_file_io_c(const std::string &path,
     throw mtx::mm_io::open_x{mtx::mm_io::make_error_code()};
 
   m_dos_style_newlines = true;
+
+  enable_statistics("file");
 }
 
 void
@@ -106,6 +109,10 @@ mm_file_io_c::setFilePointer(int64 offset,
                : seek_end       == mode ? FILE_END
                :                          FILE_BEGIN;
   LONG high    = (LONG)(offset >> 32);
+
+  mtx::mm_io::blocked_timer_c timer{m_statistics.get()};
+  auto previous_position = m_current_position;
+
   DWORD low    = SetFilePointer((HANDLE)m_file, (LONG)(offset & 0xffffffff), &high, method);
 
   if ((INVALID_SET_FILE_POINTER == low) && (GetLastError() != NO_ERROR))
@@ -113,6 +120,9 @@ mm_file_io_c::setFilePointer(int64 offset,
 
   m_eof              = false;
   m_current_position = (int64_t)low + ((int64_t)high << 32);
+
+  if (m_statistics)
+    m_statistics->add_seek(previous_position, m_current_position);
 }
 
 uint32
@@ -209,7 +219,7 @@ static bool s_stdout_binmode_set = false;
 size_t
 mm_stdio_c::_write(const void *buffer,
                    size_t size) {
-  HANDLE h_stdout = GetStdHandle(STD_OUTPUT_HANDLE);
+  HANDLE h_stdout = GetStdHandle(m_use_stderr ? STD_ERROR_HANDLE : STD_OUTPUT_HANDLE);
   if (INVALID_HANDLE_VALUE == h_stdout)
     return 0;
 
@@ -229,6 +239,13 @@ mm_stdio_c::_write(const void *buffer,
     return bytes_written;
   }
 
+  if (m_use_stderr) {
+    size_t bytes_written = fwrite(buffer, 1, size, stderr);
+    fflush(stderr);
+
+    return bytes_written;
+  }
+
   if (!s_stdout_binmode_set) {
     _setmode(1, _O_BINARY);
     s_stdout_binmode_set = true;
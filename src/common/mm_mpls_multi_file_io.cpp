@@ -4,6 +4,7 @@
 
 #include "common/debugging.h"
 #include "common/id_info.h"
+#include "common/mm_io_statistics.h"
 #include "common/mm_mpls_multi_file_io.h"
 #include "common/strings/formatting.h"
 
@@ -18,6 +19,7 @@ mm_mpls_multi_file_io_c::mm_mpls_multi_file_io_c(std::vector<bfs::path> const &f
   , m_mpls_parser{mpls_parser}
   , m_total_size{ boost::accumulate(m_files, 0ull, [](uint64_t accu, bfs::path const &file) { return accu + bfs::file_size(file); }) }
 {
+  enable_statistics("MPLS playlist");
 }
 
 mm_mpls_multi_file_io_c::~mm_mpls_multi_file_io_c() {
@@ -16,6 +16,7 @@
 #include <sstream>
 
 #include "common/id_info.h"
+#include "common/mm_io_statistics.h"
 #include "common/mm_io_x.h"
 #include "common/mm_multi_file_io.h"
 #include "common/output.h"
@@ -46,6 +47,8 @@ mm_multi_file_io_c::mm_multi_file_io_c(const std::vector<bfs::path> &file_names,
 
     m_total_size += file->get_size();
   }
+
+  enable_statistics("multi file");
 }
 
 mm_multi_file_io_c::~mm_multi_file_io_c() {
@@ -68,6 +71,9 @@ mm_multi_file_io_c::setFilePointer(int64 offset,
   if ((0 > new_pos) || (static_cast<int64_t>(m_total_size) < new_pos))
     throw mtx::mm_io::seek_x();
 
+  if (m_statistics)
+    m_statistics->add_seek(m_current_pos, new_pos);
+
   m_current_file = 0;
   for (auto &file : m_files) {
     if ((file.m_global_start + file.m_size) < static_cast<uint64_t>(new_pos)) {
@@ -14,6 +14,7 @@
 
 #include "common/common_pch.h"
 
+#include "common/mm_io_statistics.h"
 #include "common/mm_io_x.h"
 #include "common/mm_read_buffer_io.h"
 
@@ -32,6 +33,7 @@ mm_read_buffer_io_c::mm_read_buffer_io_c(mm_io_c *in,
   , m_debug_seek{"read_buffer_io|read_buffer_io_read"}
   , m_debug_read{"read_buffer_io|read_buffer_io_read"}
 {
+  enable_statistics("read buffer");
   setFilePointer(0, seek_beginning);
 }
 
@@ -52,7 +54,8 @@ mm_read_buffer_io_c::setFilePointer(int64 offset,
     return;
   }
 
-  int64_t new_pos = 0;
+  int64_t new_pos           = 0;
+  int64_t previous_position = m_offset + m_cursor;
   // FIXME int64_t overflow
 
   // No need to actually compute this here; _read() will do just that
@@ -81,6 +84,10 @@ mm_read_buffer_io_c::setFilePointer(int64 offset,
   int64_t in_buf = new_pos - m_offset;
   if ((0 <= in_buf) && (in_buf <= static_cast<int64_t>(m_fill))) {
     m_cursor = in_buf;
+
+    if (m_statistics)
+      m_statistics->add_seek(previous_position, new_pos);
+
     return;
   }
 
@@ -96,6 +103,9 @@ mm_read_buffer_io_c::setFilePointer(int64 offset,
   // "Drop" the buffer content
   m_cursor = m_fill = 0;
 
+  if (m_statistics)
+    m_statistics->add_seek(previous_position, m_offset);
+
   mxdebug_if(m_debug_seek, boost::format("seek on proxy from %1% to %2% relative %3%\n") % previous_pos % m_offset % (m_offset - previous_pos));
 }
 
@@ -110,8 +120,9 @@ mm_read_buffer_io_c::_read(void *buffer,
   if (!m_buffering)
     return m_proxy_io->read(buffer, size);
 
-  char *buf    = static_cast<char *>(buffer);
-  uint32_t res = 0;
+  char *buf     = static_cast<char *>(buffer);
+  uint32_t res  = 0;
+  bool refilled = false;
 
   while (0 < size) {
     // TODO Directly write full blocks into the output buffer when size > m_size
@@ -125,6 +136,11 @@ mm_read_buffer_io_c::_read(void *buffer,
 
     } else {
       // Refill the buffer
+      if (!m_buffer) {
+        m_af_buffer = memory_c::alloc(m_size);
+        m_buffer    = m_af_buffer->get_buffer();
+      }
+
       m_offset += m_cursor;
       m_cursor  = 0;
       m_fill    = 0;
@@ -139,7 +155,12 @@ mm_read_buffer_io_c::_read(void *buffer,
 
       int64_t previous_pos = m_proxy_io->getFilePointer();
 
-      m_fill = m_proxy_io->read(m_buffer, avail);
+      m_fill   = m_proxy_io->read(m_buffer, avail);
+      refilled = true;
+
+      if (m_statistics)
+        ++m_statistics->m_num_buffer_misses;
+
       mxdebug_if(m_debug_read, boost::format("physical read from position %3% for %1% returned %2%\n") % avail % m_fill % previous_pos);
       if (m_fill != avail) {
         m_eof = true;
@@ -149,6 +170,9 @@ mm_read_buffer_io_c::_read(void *buffer,
     }
   }
 
+  if (m_statistics && !refilled)
+    ++m_statistics->m_num_buffer_hits;
+
   return res;
 }
 
@@ -168,3 +192,20 @@ mm_read_buffer_io_c::enable_buffering(bool enable) {
     m_fill   = 0;
   }
 }
+
+void
+mm_read_buffer_io_c::suspend() {
+  if (m_buffering && m_fill) {
+    // Position the proxied file where the reader currently is so that
+    // the buffer's content isn't needed anymore.
+    auto position = m_offset + m_cursor;
+    m_proxy_io->setFilePointer(position, seek_beginning);
+    m_offset = m_proxy_io->getFilePointer();
+    m_cursor = m_fill = 0;
+  }
+
+  m_af_buffer.reset();
+  m_buffer = nullptr;
+
+  mm_proxy_io_c::suspend();
+}
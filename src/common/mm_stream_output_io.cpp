@@ -0,0 +1,128 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class for non-seekable outputs like pipes
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_stream_output_io.h"
+
+mm_stream_output_io_c::mm_stream_output_io_c(mm_io_cptr const &out)
+  : m_out{out}
+  , m_header_buffer{new mm_mem_io_c{nullptr, 0, 128 * 1024}}
+  , m_position{}
+  , m_debug{"stream_output_io"}
+{
+}
+
+mm_stream_output_io_c::~mm_stream_output_io_c() {
+  close();
+}
+
+uint64
+mm_stream_output_io_c::getFilePointer() {
+  return m_header_buffer ? m_header_buffer->getFilePointer() : m_position;
+}
+
+void
+mm_stream_output_io_c::setFilePointer(int64 offset,
+                                      seek_mode mode) {
+  if (m_header_buffer) {
+    m_header_buffer->setFilePointer(offset, mode);
+    return;
+  }
+
+  // Both the current position and the end of the output are the same
+  // once streaming has started.
+  int64_t new_pos = seek_current == mode ? static_cast<int64_t>(m_position) + offset
+                  : seek_end     == mode ? static_cast<int64_t>(m_position) + offset
+                  :                        offset;
+
+  if (new_pos == static_cast<int64_t>(m_position))
+    return;
+
+  mxdebug_if(m_debug, boost::format("seek from %1% to %2% attempted while streaming\n") % m_position % new_pos);
+
+  throw mtx::mm_io::seek_x{};
+}
+
+void
+mm_stream_output_io_c::start_streaming() {
+  if (!m_header_buffer)
+    return;
+
+  m_position = m_header_buffer->get_size();
+
+  mxdebug_if(m_debug, boost::format("start_streaming: flushing %1% bytes of headers\n") % m_position);
+
+  if (m_position && (m_out->write(m_header_buffer->get_buffer(), m_position) != m_position))
+    throw mtx::mm_io::insufficient_space_x{};
+
+  m_header_buffer.reset();
+}
+
+bool
+mm_stream_output_io_c::is_streaming()
+  const {
+  return !m_header_buffer;
+}
+
+void
+mm_stream_output_io_c::flush() {
+  if (!m_header_buffer)
+    m_out->flush();
+}
+
+void
+mm_stream_output_io_c::close() {
+  if (!m_out)
+    return;
+
+  start_streaming();
+
+  m_out->close();
+  m_out.reset();
+}
+
+bool
+mm_stream_output_io_c::eof() {
+  return m_header_buffer ? m_header_buffer->eof() : true;
+}
+
+std::string
+mm_stream_output_io_c::get_file_name()
+  const {
+  return m_out ? m_out->get_file_name() : std::string{};
+}
+
+uint32
+mm_stream_output_io_c::_read(void *buffer,
+                             size_t size) {
+  if (m_header_buffer)
+    return m_header_buffer->read(buffer, size);
+
+  throw mtx::mm_io::wrong_read_write_access_x{};
+}
+
+size_t
+mm_stream_output_io_c::_write(const void *buffer,
+                              size_t size) {
+  m_cached_size = -1;
+
+  if (m_header_buffer)
+    return m_header_buffer->write(buffer, size);
+
+  auto written  = m_out->write(buffer, size);
+  m_position   += written;
+
+  return written;
+}
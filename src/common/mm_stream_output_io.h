@@ -0,0 +1,52 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class for non-seekable outputs like pipes
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_STREAM_OUTPUT_IO_H
+#define MTX_COMMON_MM_STREAM_OUTPUT_IO_H
+
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+
+// Writes to an output that cannot seek, e.g. a pipe, a FIFO or
+// stdout. Until start_streaming() is called everything is kept in
+// memory so that the headers can still be modified freely. Afterwards
+// all data is appended to the real output, and seeking to any other
+// position than the current one throws mtx::mm_io::seek_x.
+class mm_stream_output_io_c: public mm_io_c {
+protected:
+  mm_io_cptr m_out;
+  std::unique_ptr<mm_mem_io_c> m_header_buffer;
+  uint64_t m_position;
+  debugging_option_c m_debug;
+
+public:
+  mm_stream_output_io_c(mm_io_cptr const &out);
+  virtual ~mm_stream_output_io_c();
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+  virtual void flush();
+  virtual void close();
+  virtual bool eof();
+  virtual std::string get_file_name() const;
+
+  virtual void start_streaming();
+  virtual bool is_streaming() const;
+
+protected:
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+};
+
+#endif // MTX_COMMON_MM_STREAM_OUTPUT_IO_H
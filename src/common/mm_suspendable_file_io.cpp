@@ -0,0 +1,109 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class implementation
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_suspendable_file_io.h"
+
+mm_suspendable_file_io_c::mm_suspendable_file_io_c(std::string const &file_name)
+  : m_file_name{file_name}
+  , m_file{new mm_file_io_c{file_name}}
+  , m_suspended_position{}
+  , m_suspended_eof{}
+  , m_debug{"suspendable_file_io"}
+{
+}
+
+mm_suspendable_file_io_c::~mm_suspendable_file_io_c() {
+  close();
+}
+
+bool
+mm_suspendable_file_io_c::is_suspended()
+  const {
+  return !m_file;
+}
+
+mm_file_io_c &
+mm_suspendable_file_io_c::resume() {
+  if (!m_file) {
+    mxdebug_if(m_debug, boost::format("resuming %1% at %2%\n") % m_file_name % m_suspended_position);
+
+    try {
+      m_file.reset(new mm_file_io_c{m_file_name});
+      m_file->setFilePointer(m_suspended_position, seek_beginning);
+
+    } catch (mtx::mm_io::exception &ex) {
+      // Readers often treat I/O exceptions as the end of their file.
+      // Silently truncating the output is worse than aborting.
+      mxerror(boost::format(Y("The file '%1%' could not be opened for reading again: %2%\n")) % m_file_name % ex);
+    }
+  }
+
+  return *m_file;
+}
+
+void
+mm_suspendable_file_io_c::suspend() {
+  if (!m_file)
+    return;
+
+  m_suspended_position = m_file->getFilePointer();
+  m_suspended_eof      = m_file->eof();
+
+  mxdebug_if(m_debug, boost::format("suspending %1% at %2%\n") % m_file_name % m_suspended_position);
+
+  m_file.reset();
+}
+
+uint64
+mm_suspendable_file_io_c::getFilePointer() {
+  return m_file ? m_file->getFilePointer() : m_suspended_position;
+}
+
+void
+mm_suspendable_file_io_c::setFilePointer(int64 offset,
+                                         seek_mode mode) {
+  resume().setFilePointer(offset, mode);
+}
+
+void
+mm_suspendable_file_io_c::close() {
+  m_file.reset();
+}
+
+bool
+mm_suspendable_file_io_c::eof() {
+  return m_file ? m_file->eof() : m_suspended_eof;
+}
+
+void
+mm_suspendable_file_io_c::clear_eof() {
+  if (m_file)
+    m_file->clear_eof();
+  m_suspended_eof = false;
+}
+
+uint32
+mm_suspendable_file_io_c::_read(void *buffer,
+                                size_t size) {
+  return resume().read(buffer, size);
+}
+
+size_t
+mm_suspendable_file_io_c::_write(const void *,
+                                 size_t) {
+  throw mtx::mm_io::wrong_read_write_access_x();
+  return 0;
+}
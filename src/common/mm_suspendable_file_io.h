@@ -0,0 +1,58 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class definitions
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_SUSPENDABLE_FILE_IO_H
+#define MTX_COMMON_MM_SUSPENDABLE_FILE_IO_H
+
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+
+// Reads a file just like mm_file_io_c. However, suspend() closes the
+// file handle while remembering the current position. The file is
+// re-opened at that position on the next access. This keeps the
+// number of open files low if many files are read one after the
+// other. Failing to re-open the file is a fatal error.
+class mm_suspendable_file_io_c: public mm_io_c {
+protected:
+  std::string m_file_name;
+  std::unique_ptr<mm_file_io_c> m_file;
+  uint64_t m_suspended_position;
+  bool m_suspended_eof;
+  debugging_option_c m_debug;
+
+public:
+  mm_suspendable_file_io_c(std::string const &file_name);
+  virtual ~mm_suspendable_file_io_c();
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+  virtual void close();
+  virtual bool eof();
+  virtual void clear_eof();
+  virtual void suspend();
+
+  virtual std::string get_file_name() const {
+    return m_file_name;
+  }
+
+  bool is_suspended() const;
+
+protected:
+  mm_file_io_c &resume();
+
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+};
+
+#endif  // MTX_COMMON_MM_SUSPENDABLE_FILE_IO_H
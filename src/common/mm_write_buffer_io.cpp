@@ -14,8 +14,10 @@
 
 #include "common/common_pch.h"
 
+#include "common/mm_io_statistics.h"
 #include "common/mm_io_x.h"
 #include "common/mm_write_buffer_io.h"
+#include "common/profiling.h"
 
 mm_write_buffer_io_c::mm_write_buffer_io_c(mm_io_c *out,
                                            size_t buffer_size,
@@ -27,7 +29,9 @@ mm_write_buffer_io_c::mm_write_buffer_io_c(mm_io_c *out,
   , m_size(buffer_size)
   , m_debug_seek{ "write_buffer_io|write_buffer_io_read"}
   , m_debug_write{"write_buffer_io|write_buffer_io_write"}
+  , m_profiling_stage{g_profiler.get_stage("writing")}
 {
+  enable_statistics("write buffer");
 }
 
 mm_write_buffer_io_c::~mm_write_buffer_io_c() {
@@ -56,6 +60,12 @@ mm_write_buffer_io_c::setFilePointer(int64 offset,
   if (new_pos == static_cast<int64_t>(getFilePointer()))
     return;
 
+  if (m_statistics)
+    m_statistics->add_seek(getFilePointer(), new_pos);
+
+  if (m_profiling_stage)
+    g_profiler.add_to_counter("output seeks");
+
   flush_buffer();
 
   if (m_debug_seek) {
@@ -91,6 +101,7 @@ mm_write_buffer_io_c::_write(const void *buffer,
   size_t avail;
   const char *buf = static_cast<const char *>(buffer);
   size_t remain   = size;
+  bool written    = false;
 
   // whole blocks
   while (remain >= (avail = m_size - m_fill)) {
@@ -102,15 +113,26 @@ mm_write_buffer_io_c::_write(const void *buffer,
       flush_buffer();
       remain -= avail;
       buf    += avail;
+      written = true;
 
     } else {
       // write whole blocks, skipping the buffer
-      avail = mm_proxy_io_c::_write(buf, m_size);
+      add_to_digest(reinterpret_cast<unsigned char const *>(buf), m_size);
+
+      {
+        mtx::profiling::scoped_timer_c timer{m_profiling_stage};
+        avail = mm_proxy_io_c::_write(buf, m_size);
+      }
+
+      if (m_profiling_stage)
+        m_profiling_stage->add_data(avail);
+
       if (avail != m_size)
         throw mtx::mm_io::insufficient_space_x();
 
       remain -= avail;
       buf    += avail;
+      written = true;
     }
   }
 
@@ -121,6 +143,13 @@ mm_write_buffer_io_c::_write(const void *buffer,
 
   m_cached_size = -1;
 
+  if (m_statistics) {
+    if (written)
+      ++m_statistics->m_num_buffer_misses;
+    else
+      ++m_statistics->m_num_buffer_hits;
+  }
+
   return size;
 }
 
@@ -129,10 +158,22 @@ mm_write_buffer_io_c::flush_buffer() {
   if (!m_fill)
     return;
 
-  size_t written = mm_proxy_io_c::_write(m_buffer, m_fill);
+  add_to_digest(m_buffer, m_fill);
+
+  size_t written;
+  {
+    mtx::profiling::scoped_timer_c timer{m_profiling_stage};
+    written = mm_proxy_io_c::_write(m_buffer, m_fill);
+  }
+
   size_t fill    = m_fill;
   m_fill         = 0;
 
+  if (m_profiling_stage) {
+    m_profiling_stage->add_data(written);
+    g_profiler.add_to_counter("output buffer flushes");
+  }
+
   mxdebug_if(m_debug_write, boost::format("flush_buffer() at %1% for %2% written %3%\n") % (mm_proxy_io_c::getFilePointer() - written) % fill % written);
 
   if (written != fill)
@@ -143,3 +184,34 @@ void
 mm_write_buffer_io_c::discard_buffer() {
   m_fill = 0;
 }
+
+void
+mm_write_buffer_io_c::add_to_digest(unsigned char const *buffer,
+                                    size_t size) {
+  if (m_digest)
+    m_digest->add(mm_proxy_io_c::getFilePointer(), buffer, size);
+}
+
+void
+mm_write_buffer_io_c::enable_digest(mtx::checksum::algorithm_e algorithm) {
+  m_digest.reset(new output_digest_c{algorithm});
+}
+
+std::string
+mm_write_buffer_io_c::finish_digest() {
+  if (!m_digest)
+    return {};
+
+  flush_buffer();
+
+  auto position = mm_proxy_io_c::getFilePointer();
+  auto digest   = m_digest->finish(*m_proxy_io);
+  auto reread   = m_digest->get_num_bytes_reread();
+
+  m_digest.reset();
+
+  if (reread)
+    mm_proxy_io_c::setFilePointer(position);
+
+  return digest;
+}
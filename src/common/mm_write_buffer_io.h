@@ -18,6 +18,11 @@
 #include "common/common_pch.h"
 
 #include "common/mm_io.h"
+#include "common/output_digest.h"
+
+namespace mtx { namespace profiling {
+class stage_c;
+}}
 
 class mm_write_buffer_io_c: public mm_proxy_io_c {
 protected:
@@ -26,6 +31,8 @@ protected:
   size_t m_fill;
   const size_t m_size;
   debugging_option_c m_debug_seek, m_debug_write;
+  std::unique_ptr<output_digest_c> m_digest;
+  mtx::profiling::stage_c *m_profiling_stage;
 
 public:
   mm_write_buffer_io_c(mm_io_c *out, size_t buffer_size, bool delete_out = true);
@@ -37,12 +44,21 @@ public:
   virtual void close();
   virtual void discard_buffer();
 
+  // Calculates the digest of everything written from now on. It must
+  // be enabled before anything has been written.
+  void enable_digest(mtx::checksum::algorithm_e algorithm);
+  // Returns the digest of the whole file and disables its
+  // calculation. The file has to be readable if parts of it must be
+  // read back.
+  std::string finish_digest();
+
   static mm_io_cptr open(const std::string &file_name, size_t buffer_size);
 
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
   virtual void flush_buffer();
+  void add_to_digest(unsigned char const *buffer, size_t size);
 };
 using mm_write_buffer_io_cptr = std::shared_ptr<mm_write_buffer_io_c>;
 
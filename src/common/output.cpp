@@ -13,6 +13,7 @@
 
 #include "common/common_pch.h"
 
+#include <mutex>
 #include <sstream>
 
 #include "common/command_line.h"
@@ -33,8 +34,15 @@ charset_converter_cptr g_cc_stdio = charset_converter_cptr(new charset_converter
 std::shared_ptr<mm_io_c> g_mm_stdio   = std::shared_ptr<mm_io_c>(new mm_stdio_c);
 
 static mxmsg_handler_t s_mxmsg_info_handler, s_mxmsg_warning_handler, s_mxmsg_error_handler;
+static thread_local bool s_errors_as_exceptions = false;
 static std::vector<std::string> s_warnings_emitted, s_errors_emitted;
 
+// Worker threads may output information and warnings while the main
+// thread does the same. Errors aren't covered as worker threads turn
+// them into exceptions (see mtx::errors_as_exceptions_c), and the
+// main thread terminates after outputting them.
+static std::recursive_mutex s_output_mutex;
+
 static nlohmann::json
 to_json_array(std::vector<std::string> const &messages) {
   auto result = nlohmann::json::array();
@@ -47,6 +55,8 @@ to_json_array(std::vector<std::string> const &messages) {
 
 void
 display_json_output(nlohmann::json json) {
+  std::lock_guard<std::recursive_mutex> lock{s_output_mutex};
+
   json["warnings"] = to_json_array(s_warnings_emitted);
   json["errors"]   = to_json_array(s_errors_emitted);
 
@@ -102,6 +112,8 @@ mxmsg(unsigned int level,
       std::string message) {
   static bool s_saw_cr_after_nl = false;
 
+  std::lock_guard<std::recursive_mutex> lock{s_output_mutex};
+
   if (g_suppress_info && (MXMSG_INFO == level))
     return;
 
@@ -143,6 +155,8 @@ default_mxinfo(unsigned int,
 
 void
 mxinfo(std::string const &info) {
+  std::lock_guard<std::recursive_mutex> lock{s_output_mutex};
+
   if (s_mxmsg_info_handler)
     s_mxmsg_info_handler(MXMSG_INFO, info);
 }
@@ -170,6 +184,8 @@ default_mxwarn(unsigned int,
 
 void
 mxwarn(std::string const &warning) {
+  std::lock_guard<std::recursive_mutex> lock{s_output_mutex};
+
   if (s_mxmsg_warning_handler)
     s_mxmsg_warning_handler(MXMSG_WARNING, warning);
 }
@@ -183,10 +199,27 @@ default_mxerror(unsigned int,
 
 void
 mxerror(std::string const &error) {
+  if (s_errors_as_exceptions)
+    throw mtx::error_message_x{error};
+
   if (s_mxmsg_error_handler)
     s_mxmsg_error_handler(MXMSG_ERROR, error);
 }
 
+namespace mtx {
+
+errors_as_exceptions_c::errors_as_exceptions_c()
+  : m_previous{s_errors_as_exceptions}
+{
+  s_errors_as_exceptions = true;
+}
+
+errors_as_exceptions_c::~errors_as_exceptions_c() {
+  s_errors_as_exceptions = m_previous;
+}
+
+}
+
 void
 mxinfo_fn(const std::string &file_name,
           const std::string &info) {
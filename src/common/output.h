@@ -20,6 +20,7 @@
 
 #include <ebml/EbmlElement.h>
 
+#include "common/error.h"
 #include "common/locale.h"
 #include "common/mm_io.h"
 #include "nlohmann-json/src/json.hpp"
@@ -72,6 +73,37 @@ mxerror(const boost::format &error) {
   mxerror(error.str());
 }
 
+namespace mtx {
+
+// Thrown by mxerror() instead of terminating the program in threads in
+// which an errors_as_exceptions_c object exists. Worker threads use it
+// for handing errors to the main thread which then reports them.
+class error_message_x: public exception {
+protected:
+  std::string m_message;
+
+public:
+  error_message_x(std::string const &message)
+    : m_message{message}
+  {
+  }
+
+  virtual const char *what() const throw() {
+    return m_message.c_str();
+  }
+};
+
+class errors_as_exceptions_c {
+protected:
+  bool m_previous;
+
+public:
+  errors_as_exceptions_c();
+  ~errors_as_exceptions_c();
+};
+
+}
+
 #define mxverb(level, message)        \
   if (verbose >= level)               \
     mxinfo(message);
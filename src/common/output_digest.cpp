@@ -0,0 +1,247 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   calculating digests of output files while they're being written
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/checksums/adler32.h"
+#include "common/checksums/base.h"
+#include "common/checksums/crc.h"
+#include "common/mm_io.h"
+#include "common/mm_io_x.h"
+#include "common/output_digest.h"
+#include "common/strings/formatting.h"
+
+output_digest_c::output_digest_c(mtx::checksum::algorithm_e algorithm)
+  : m_algorithm{algorithm}
+  , m_block_size{is_combinable() ? 4 * 1024 * 1024 : std::numeric_limits<uint64_t>::max()}
+  , m_worker_block{}
+  , m_worker_size{}
+  , m_file_size{}
+  , m_num_bytes_reread{}
+  , m_debug{"output_digest"}
+{
+  start_block(0);
+}
+
+output_digest_c::~output_digest_c() {
+}
+
+bool
+output_digest_c::is_combinable()
+  const {
+  return mtx::checksum::algorithm_e::md5 != m_algorithm;
+}
+
+mtx::checksum::base_uptr
+output_digest_c::create_worker()
+  const {
+  return mtx::checksum::for_algorithm(m_algorithm, mtx::checksum::algorithm_e::crc32_ieee_le == m_algorithm ? 0xffffffff : 0);
+}
+
+uint64_t
+output_digest_c::get_worker_value() {
+  m_worker->finish();
+
+  auto value = dynamic_cast<mtx::checksum::uint_result_c &>(*m_worker).get_result_as_uint();
+
+  return mtx::checksum::algorithm_e::crc32_ieee_le == m_algorithm ? value ^ 0xffffffff : value;
+}
+
+void
+output_digest_c::start_block(uint64_t block) {
+  invalidate_block(block);
+
+  m_worker       = create_worker();
+  m_worker_block = block;
+  m_worker_size  = 0;
+}
+
+void
+output_digest_c::finish_block() {
+  if (m_block_sizes.size() <= m_worker_block) {
+    m_block_values.resize(m_worker_block + 1, 0);
+    m_block_sizes.resize(m_worker_block + 1, 0);
+  }
+
+  m_block_values[m_worker_block] = get_worker_value();
+  m_block_sizes[m_worker_block]  = m_worker_size;
+
+  m_worker.reset();
+}
+
+void
+output_digest_c::invalidate_block(uint64_t block) {
+  if (block < m_block_sizes.size())
+    m_block_sizes[block] = 0;
+
+  if (m_worker && (m_worker_block == block))
+    m_worker.reset();
+}
+
+void
+output_digest_c::add(uint64_t position,
+                     unsigned char const *buffer,
+                     uint64_t size) {
+  m_file_size = std::max(m_file_size, position + size);
+
+  while (size) {
+    auto block     = position / m_block_size;
+    auto offset    = position % m_block_size;
+    auto num_bytes = std::min(size, m_block_size - offset);
+
+    auto is_worker_block = m_worker && (m_worker_block == block);
+
+    if (!is_worker_block || (m_worker_size != offset)) {
+      // Data not continuing the block currently being hashed. Hashing
+      // can only start anew at the start of a block following the one
+      // being hashed; otherwise the block has to be read back
+      // later. Patches to other blocks must not affect the block
+      // currently being hashed.
+      if (offset || is_worker_block || (m_worker && (block < m_worker_block)))
+        invalidate_block(block);
+      else
+        start_block(block);
+    }
+
+    if (m_worker && (m_worker_block == block)) {
+      m_worker->add(buffer, num_bytes);
+      m_worker_size += num_bytes;
+
+      if (m_worker_size == m_block_size)
+        finish_block();
+    }
+
+    position += num_bytes;
+    buffer   += num_bytes;
+    size     -= num_bytes;
+  }
+}
+
+void
+output_digest_c::read_back(mm_io_c &file,
+                           mtx::checksum::base_c &worker,
+                           uint64_t position,
+                           uint64_t size) {
+  static uint64_t const s_chunk_size = 1024 * 1024;
+
+  if (!size)
+    return;
+
+  auto chunk = memory_c::alloc(std::min(size, s_chunk_size));
+
+  file.setFilePointer(position);
+  m_num_bytes_reread += size;
+
+  while (size) {
+    auto num_bytes = std::min(size, s_chunk_size);
+    if (file.read(chunk, num_bytes) != num_bytes)
+      throw mtx::mm_io::end_of_file_x{};
+
+    worker.add(chunk->get_buffer(), num_bytes);
+    size -= num_bytes;
+  }
+}
+
+std::string
+output_digest_c::finish(mm_io_c &file) {
+  auto file_size = m_file_size;
+
+  if (!is_combinable()) {
+    if (!m_worker || m_worker_block || (m_worker_size != file_size)) {
+      m_worker = create_worker();
+      read_back(file, *m_worker, 0, file_size);
+    }
+
+    m_worker->finish();
+    auto digest = to_hex(m_worker->get_result(), true);
+
+    mxdebug_if(m_debug, boost::format("output_digest: finished with %1% bytes read back of %2%\n") % m_num_bytes_reread % file_size);
+
+    return digest;
+  }
+
+  // The file's last block is usually not complete.
+  if (m_worker && ((m_worker_block * m_block_size + m_worker_size) == file_size))
+    finish_block();
+
+  auto is_crc32 = mtx::checksum::algorithm_e::crc32_ieee_le == m_algorithm;
+  auto result   = static_cast<uint32_t>(is_crc32 ? 0 : 1);
+
+  for (uint64_t position = 0, block = 0; position < file_size; position += m_block_size, ++block) {
+    auto size  = std::min(m_block_size, file_size - position);
+    auto value = uint64_t{};
+
+    if ((block < m_block_sizes.size()) && (m_block_sizes[block] == size))
+      value = m_block_values[block];
+
+    else {
+      m_worker = create_worker();
+      read_back(file, *m_worker, position, size);
+      value = get_worker_value();
+    }
+
+    result = is_crc32 ? mtx::checksum::combine_crc32_ieee_le(result, value, size) : mtx::checksum::combine_adler32(result, value, size);
+  }
+
+  mxdebug_if(m_debug, boost::format("output_digest: finished with %1% bytes read back of %2%\n") % m_num_bytes_reread % file_size);
+
+  return (boost::format("%|1$08x|") % result).str();
+}
+
+uint64_t
+output_digest_c::get_num_bytes_reread()
+  const {
+  return m_num_bytes_reread;
+}
+
+bool
+output_digest_c::parse_algorithm(std::string const &name,
+                                 mtx::checksum::algorithm_e &algorithm) {
+  auto lower_name = balg::to_lower_copy(name);
+
+  if (lower_name == "md5")
+    algorithm = mtx::checksum::algorithm_e::md5;
+
+  else if (lower_name == "crc32")
+    algorithm = mtx::checksum::algorithm_e::crc32_ieee_le;
+
+  else if (lower_name == "adler32")
+    algorithm = mtx::checksum::algorithm_e::adler32;
+
+  else
+    return false;
+
+  return true;
+}
+
+std::string
+output_digest_c::get_algorithm_name(mtx::checksum::algorithm_e algorithm) {
+  return mtx::checksum::algorithm_e::md5           == algorithm ? "md5"
+       : mtx::checksum::algorithm_e::crc32_ieee_le == algorithm ? "crc32"
+       :                                                          "adler32";
+}
+
+void
+output_digest_c::write_digest_file(std::string const &file_name,
+                                   mtx::checksum::algorithm_e algorithm,
+                                   std::string const &digest) {
+  auto digest_file_name = file_name + "." + get_algorithm_name(algorithm);
+
+  try {
+    mm_file_io_c out{digest_file_name, MODE_CREATE};
+    out.puts(digest + "  " + bfs::path{file_name}.filename().string() + "\n");
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % digest_file_name % ex);
+  }
+}
@@ -0,0 +1,78 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   calculating digests of output files while they're being written
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_OUTPUT_DIGEST_H
+#define MTX_COMMON_OUTPUT_DIGEST_H
+
+#include "common/common_pch.h"
+
+#include "common/checksums/base_fwd.h"
+
+class mm_io_c;
+
+// Calculates the digest of a file from the data written to it. Files
+// aren't written strictly sequentially: headers, seek heads and sizes
+// are patched later on. Therefore the file is split into blocks whose
+// checksums are calculated as long as they're written
+// sequentially. Blocks that are modified afterwards are read back when
+// the digest is finished, and the block checksums are combined.
+//
+// MD5 cannot be combined. It is calculated as long as the file is
+// written sequentially from its start; after a modification of data
+// already hashed the file is read back completely.
+class output_digest_c {
+protected:
+  mtx::checksum::algorithm_e m_algorithm;
+  uint64_t m_block_size;
+  std::vector<uint64_t> m_block_values;
+  // The number of bytes each block's value covers; 0 if the block has
+  // to be read back.
+  std::vector<uint64_t> m_block_sizes;
+  mtx::checksum::base_uptr m_worker;
+  uint64_t m_worker_block, m_worker_size, m_file_size, m_num_bytes_reread;
+  debugging_option_c m_debug;
+
+public:
+  output_digest_c(mtx::checksum::algorithm_e algorithm);
+  ~output_digest_c();
+
+  // Must be called with all data written to the file at 'position'.
+  void add(uint64_t position, unsigned char const *buffer, uint64_t size);
+
+  // Returns the digest as a hex string. The file ends with the last
+  // byte written. Blocks that couldn't be calculated from the written
+  // data are read from 'file'; nothing is read if the file has been
+  // written sequentially so that it may be a pipe.
+  std::string finish(mm_io_c &file);
+
+  uint64_t get_num_bytes_reread() const;
+
+  static bool parse_algorithm(std::string const &name, mtx::checksum::algorithm_e &algorithm);
+  static std::string get_algorithm_name(mtx::checksum::algorithm_e algorithm);
+
+  // Writes the digest to '<file_name>.<algorithm>' in the format used
+  // by tools like md5sum.
+  static void write_digest_file(std::string const &file_name, mtx::checksum::algorithm_e algorithm, std::string const &digest);
+
+protected:
+  bool is_combinable() const;
+  mtx::checksum::base_uptr create_worker() const;
+  uint64_t get_worker_value();
+  void start_block(uint64_t block);
+  void finish_block();
+  void invalidate_block(uint64_t block);
+  void read_back(mm_io_c &file, mtx::checksum::base_c &worker, uint64_t position, uint64_t size);
+};
+using output_digest_cptr = std::shared_ptr<output_digest_c>;
+
+#endif  // MTX_COMMON_OUTPUT_DIGEST_H
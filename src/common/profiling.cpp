@@ -0,0 +1,158 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   measuring where the programs spend their time
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/fs_sys_helpers.h"
+#include "common/profiling.h"
+#include "common/strings/formatting.h"
+
+mtx::profiling::profiler_c g_profiler;
+
+namespace mtx { namespace profiling {
+
+stage_c::stage_c(std::string const &name)
+  : m_name{name}
+  , m_num_calls{}
+  , m_num_nanoseconds{}
+  , m_num_packets{}
+  , m_num_bytes{}
+{
+}
+
+profiler_c::profiler_c()
+  : m_enabled{}
+{
+}
+
+void
+profiler_c::enable() {
+  m_enabled = true;
+  m_start   = std::chrono::steady_clock::now();
+}
+
+stage_c *
+profiler_c::get_stage(std::string const &name) {
+  if (!m_enabled)
+    return nullptr;
+
+  auto &stage = m_stages_by_name[name];
+  if (!stage) {
+    m_stages.emplace_back(new stage_c{name});
+    stage = m_stages.back().get();
+  }
+
+  return stage;
+}
+
+void
+profiler_c::add_to_counter(std::string const &name,
+                           uint64_t value) {
+  if (!m_enabled)
+    return;
+
+  auto counter = brng::find_if(m_counters, [&name](std::pair<std::string, uint64_t> const &c) { return c.first == name; });
+  if (counter != m_counters.end())
+    counter->second += value;
+  else
+    m_counters.emplace_back(name, value);
+}
+
+void
+profiler_c::start(stage_c &stage) {
+  m_frames.push_back(frame_t{ &stage, std::chrono::steady_clock::now(), 0 });
+}
+
+void
+profiler_c::stop() {
+  auto frame       = m_frames.back();
+  auto nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frame.m_start).count());
+
+  m_frames.pop_back();
+
+  ++frame.m_stage->m_num_calls;
+  frame.m_stage->m_num_nanoseconds += nanoseconds - frame.m_num_nanoseconds_in_children;
+
+  if (!m_frames.empty())
+    m_frames.back().m_num_nanoseconds_in_children += nanoseconds;
+}
+
+uint64_t
+profiler_c::get_num_nanoseconds_since_start()
+  const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+std::string
+profiler_c::format_table()
+  const {
+  auto total_ns     = std::max<uint64_t>(get_num_nanoseconds_since_start(), 1);
+  auto accounted_ns = uint64_t{};
+  auto name_width   = std::string{"other"}.size();
+
+  for (auto const &stage : m_stages) {
+    accounted_ns += stage->m_num_nanoseconds;
+    name_width    = std::max(name_width, stage->m_name.size());
+  }
+
+  auto row = [name_width, total_ns](std::string const &name, std::string const &calls, uint64_t nanoseconds, std::string const &packets, std::string const &bytes, std::string const &rate) {
+    return (boost::format("%1% %|2$10| %|3$10.3f| %|4$6.1f| %|5$12| %|6$15| %|7$10|\n")
+            % (name + std::string(name_width - std::min(name_width, name.size()), ' ')) % calls % (nanoseconds / 1000000000.0) % (nanoseconds * 100.0 / total_ns) % packets % bytes % rate).str();
+  };
+
+  auto table = (boost::format("%1% %|2$10| %|3$10| %|4$6| %|5$12| %|6$15| %|7$10|\n")
+                % (std::string{"stage"} + std::string(name_width - 5, ' ')) % "calls" % "time (s)" % "%" % "packets" % "bytes" % "MB/s").str();
+
+  for (auto const &stage : m_stages) {
+    auto rate = !stage->m_num_bytes || !stage->m_num_nanoseconds ? std::string{}
+              : (boost::format("%|1$.1f|") % (stage->m_num_bytes * 1000.0 / stage->m_num_nanoseconds)).str();
+    table    += row(stage->m_name, to_string(stage->m_num_calls), stage->m_num_nanoseconds, to_string(stage->m_num_packets), to_string(stage->m_num_bytes), rate);
+  }
+
+  table += row("other", "", total_ns - std::min(total_ns, accounted_ns), "", "", "");
+
+  for (auto const &counter : m_counters)
+    table += (boost::format("%1%: %2%\n") % counter.first % counter.second).str();
+
+  table += (boost::format("peak memory usage: %1% bytes\n") % mtx::sys::get_peak_memory_usage()).str();
+
+  return table;
+}
+
+nlohmann::json
+profiler_c::to_json()
+  const {
+  auto stages   = nlohmann::json::array();
+  auto counters = nlohmann::json::object();
+
+  for (auto const &stage : m_stages)
+    stages.push_back(nlohmann::json{
+      { "name",        stage->m_name            },
+      { "calls",       stage->m_num_calls       },
+      { "nanoseconds", stage->m_num_nanoseconds },
+      { "packets",     stage->m_num_packets     },
+      { "bytes",       stage->m_num_bytes       },
+    });
+
+  for (auto const &counter : m_counters)
+    counters[counter.first] = counter.second;
+
+  return nlohmann::json{
+    { "total_nanoseconds", get_num_nanoseconds_since_start() },
+    { "stages",            stages                            },
+    { "counters",          counters                          },
+    { "peak_memory_usage", mtx::sys::get_peak_memory_usage() },
+  };
+}
+
+}}
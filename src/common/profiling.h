@@ -0,0 +1,114 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   measuring where the programs spend their time
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_PROFILING_H
+#define MTX_COMMON_PROFILING_H
+
+#include "common/common_pch.h"
+
+#include <chrono>
+#include <unordered_map>
+
+#include "nlohmann-json/src/json.hpp"
+
+namespace mtx { namespace profiling {
+
+// A stage is a named piece of work such as reading from one file or
+// packetizing for one codec. Its time excludes the time spent in
+// other stages started while it was running, e.g. the packetizer
+// called by a reader.
+class stage_c {
+public:
+  std::string const m_name;
+  uint64_t m_num_calls, m_num_nanoseconds, m_num_packets, m_num_bytes;
+
+public:
+  stage_c(std::string const &name);
+
+  inline void
+  add_data(uint64_t num_bytes,
+           uint64_t num_packets = 1) {
+    m_num_bytes   += num_bytes;
+    m_num_packets += num_packets;
+  }
+};
+
+class profiler_c {
+protected:
+  struct frame_t {
+    stage_c *m_stage;
+    std::chrono::steady_clock::time_point m_start;
+    uint64_t m_num_nanoseconds_in_children;
+  };
+
+  bool m_enabled;
+  std::chrono::steady_clock::time_point m_start;
+  std::vector<std::unique_ptr<stage_c>> m_stages;
+  std::unordered_map<std::string, stage_c *> m_stages_by_name;
+  std::vector<std::pair<std::string, uint64_t>> m_counters;
+  std::vector<frame_t> m_frames;
+
+public:
+  profiler_c();
+
+  void enable();
+  inline bool
+  is_enabled()
+    const {
+    return m_enabled;
+  }
+
+  // Returns nullptr if profiling isn't enabled. Stages are created on
+  // first use and reported in that order.
+  stage_c *get_stage(std::string const &name);
+  void add_to_counter(std::string const &name, uint64_t value = 1);
+
+  void start(stage_c &stage);
+  void stop();
+
+  std::string format_table() const;
+  nlohmann::json to_json() const;
+
+protected:
+  uint64_t get_num_nanoseconds_since_start() const;
+};
+
+}}
+
+extern mtx::profiling::profiler_c g_profiler;
+
+namespace mtx { namespace profiling {
+
+// Measures the time until it goes out of scope. Does nothing for
+// nullptr stages, which is what disabled profiling results in.
+class scoped_timer_c {
+protected:
+  stage_c *m_stage;
+
+public:
+  scoped_timer_c(stage_c *stage)
+    : m_stage{stage}
+  {
+    if (m_stage)
+      g_profiler.start(*m_stage);
+  }
+
+  ~scoped_timer_c() {
+    if (m_stage)
+      g_profiler.stop();
+  }
+};
+
+}}
+
+#endif  // MTX_COMMON_PROFILING_H
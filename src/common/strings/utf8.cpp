@@ -18,15 +18,71 @@
 
 #include "common/common_pch.h"
 
+#if defined(__GNUC__) && defined(__SSE2__)
+# define MTX_UTF8_SSE2
+# include <emmintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+# define MTX_UTF8_NEON
+# include <arm_neon.h>
+#endif
+
 #include <utf8.h>
 
 #include "common/strings/utf8.h"
 
+namespace {
+
+// Returns the length of the run of ASCII characters 'buffer' starts
+// with.
+size_t
+skip_ascii(char const *buffer,
+           size_t size) {
+  auto p   = reinterpret_cast<unsigned char const *>(buffer);
+  auto end = p + size;
+
+#if defined(MTX_UTF8_SSE2)
+  for (; (p + 16) <= end; p += 16) {
+    auto mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(p)));
+    if (mask)
+      return p - reinterpret_cast<unsigned char const *>(buffer) + __builtin_ctz(mask);
+  }
+
+#elif defined(MTX_UTF8_NEON)
+  for (; (p + 16) <= end; p += 16)
+    if (vmaxvq_u8(vld1q_u8(p)) & 0x80)
+      break;
+
+#else
+  for (; (p + 8) <= end; p += 8) {
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+    if (word & 0x8080808080808080ull)
+      break;
+  }
+#endif
+
+  while ((p < end) && !(*p & 0x80))
+    ++p;
+
+  return p - reinterpret_cast<unsigned char const *>(buffer);
+}
+
+}
+
+bool
+is_ascii(char const *buffer,
+         size_t size) {
+  return skip_ascii(buffer, size) == size;
+}
+
 std::wstring
 to_wide(const std::string &source) {
   std::wstring destination;
 
-  ::utf8::utf8to32(source.begin(), source.end(), back_inserter(destination));
+  auto num_ascii = skip_ascii(source.data(), source.size());
+  destination.assign(source.begin(), source.begin() + num_ascii);
+
+  ::utf8::utf8to32(source.begin() + num_ascii, source.end(), back_inserter(destination));
 
   return destination;
 }
@@ -35,7 +91,11 @@ std::string
 to_utf8(const std::wstring &source) {
   std::string destination;
 
-  ::utf8::utf32to8(source.begin(), source.end(), back_inserter(destination));
+  auto ascii_end = std::find_if(source.begin(), source.end(), [](wchar_t c) { return 0x7f < static_cast<uint32_t>(c); });
+  destination.reserve(source.size());
+  destination.assign(source.begin(), ascii_end);
+
+  ::utf8::utf32to8(ascii_end, source.end(), back_inserter(destination));
 
   return destination;
 }
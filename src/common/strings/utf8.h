@@ -84,6 +84,14 @@ to_utf8(::libebml::UTFstring const &source) {
   return source.GetUTF8();
 }
 
+// Uses vector instructions for runs of ASCII characters.
+bool is_ascii(char const *buffer, size_t size);
+
+inline bool
+is_ascii(std::string const &source) {
+  return is_ascii(source.data(), source.size());
+}
+
 size_t get_width_in_em(wchar_t c);
 size_t get_width_in_em(const std::wstring &s);
 
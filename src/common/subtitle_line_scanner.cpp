@@ -0,0 +1,279 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   recognizing lines in text subtitle files
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/subtitle_line_scanner.h"
+
+namespace mtx { namespace subtitles {
+
+namespace {
+
+// What "\s" and "\d" match in the "C" locale.
+inline bool
+is_space(char c) {
+  return (' ' == c) || (('\t' <= c) && ('\r' >= c));
+}
+
+inline bool
+is_digit(char c) {
+  return ('0' <= c) && ('9' >= c);
+}
+
+// Characters after which '^' and before which '$' match.
+inline bool
+is_separator(char c) {
+  return ('\n' == c) || ('\r' == c) || ('\f' == c);
+}
+
+inline char const *
+skip_spaces(char const *p,
+            char const *end) {
+  while ((p < end) && is_space(*p))
+    ++p;
+  return p;
+}
+
+inline char const *
+skip_digits(char const *p,
+            char const *end) {
+  while ((p < end) && is_digit(*p))
+    ++p;
+  return p;
+}
+
+// Where '$' matches: at the end and before a separator, but not
+// between '\r' and '\n'.
+inline bool
+is_line_end(char const *p,
+            char const *begin,
+            char const *end) {
+  return (p == end)
+      || (is_separator(*p) && !((p > begin) && ('\r' == p[-1]) && ('\n' == *p)));
+}
+
+// Calls 'matcher' with each position '^' matches at until it returns
+// true: the start and after each separator, but not between '\r' and
+// '\n'.
+template<typename MatcherT>
+bool
+match_at_line_starts(std::string const &line,
+                     MatcherT const &matcher) {
+  auto begin = line.data();
+  auto end   = begin + line.size();
+
+  if (matcher(begin, end))
+    return true;
+
+  for (auto p = begin; p < end; ++p)
+    if (   is_separator(*p)
+        && !(('\r' == *p) && ((p + 1) < end) && ('\n' == p[1]))
+        && matcher(p + 1, end))
+      return true;
+
+  return false;
+}
+
+// Like boost::lexical_cast<int>(): values that don't fit result in 0
+// as parse_number() leaves the value untouched then.
+int
+digits_to_int(char const *p,
+              char const *end) {
+  int64_t value = 0;
+
+  for (; p < end; ++p) {
+    value = value * 10 + (*p - '0');
+    if (value > std::numeric_limits<int>::max())
+      return 0;
+  }
+
+  return value;
+}
+
+// "\s*(-?)\s*(\d+):\s*(-?)\s*(\d+):\s*(-?)\s*(\d+)[,\.:]\s*(-?)\s*(\d+)"
+char const *
+scan_srt_timestamp(char const *p,
+                   char const *end,
+                   srt_timestamp_t &timestamp) {
+  char const *digits[4][2];
+  auto num_minus_signs = 0u;
+
+  for (auto idx = 0u; idx < 4; ++idx) {
+    p = skip_spaces(p, end);
+
+    if ((p < end) && ('-' == *p)) {
+      ++num_minus_signs;
+      p = skip_spaces(p + 1, end);
+    }
+
+    digits[idx][0] = p;
+    p              = skip_digits(p, end);
+    digits[idx][1] = p;
+
+    if (digits[idx][0] == p)
+      return nullptr;
+
+    if (3 == idx)
+      break;
+
+    if ((p == end) || ((':' != *p) && ((2 != idx) || ((',' != *p) && ('.' != *p)))))
+      return nullptr;
+
+    ++p;
+  }
+
+  timestamp.negative    = num_minus_signs % 2;
+  timestamp.hours       = digits_to_int(digits[0][0], digits[0][1]);
+  timestamp.minutes     = digits_to_int(digits[1][0], digits[1][1]);
+  timestamp.seconds     = digits_to_int(digits[2][0], digits[2][1]);
+  timestamp.nanoseconds = 0;
+
+  auto fraction = digits[3][0];
+  for (auto idx = 0u; idx < 9; ++idx)
+    timestamp.nanoseconds = timestamp.nanoseconds * 10 + (fraction < digits[3][1] ? *fraction++ - '0' : 0);
+
+  return p;
+}
+
+}
+
+srt_timestamp_t::srt_timestamp_t()
+  : negative{}
+  , hours{}
+  , minutes{}
+  , seconds{}
+  , nanoseconds{}
+{
+}
+
+bool
+is_srt_number(std::string const &line) {
+  auto begin = line.data();
+  auto end   = begin + line.size();
+
+  return (begin != end) && (skip_digits(begin, end) == end);
+}
+
+bool
+parse_srt_timestamp_line(std::string const &line,
+                         srt_timestamp_t &start,
+                         srt_timestamp_t &end) {
+  return match_at_line_starts(line, [&start, &end](char const *p, char const *line_end) -> bool {
+    srt_timestamp_t start_timestamp, end_timestamp;
+
+    p = scan_srt_timestamp(p, line_end, start_timestamp);
+    if (!p)
+      return false;
+
+    // "\s*[\-\s]+>"
+    auto arrow = p;
+    while ((arrow < line_end) && (is_space(*arrow) || ('-' == *arrow)))
+      ++arrow;
+
+    if ((arrow == p) || (arrow == line_end) || ('>' != *arrow))
+      return false;
+
+    if (!scan_srt_timestamp(arrow + 1, line_end, end_timestamp))
+      return false;
+
+    start = start_timestamp;
+    end   = end_timestamp;
+
+    return true;
+  });
+}
+
+bool
+has_srt_coordinates(std::string const &line) {
+  auto begin = line.data();
+  auto end   = begin + line.size();
+
+  for (auto candidate = begin; candidate < end; ++candidate) {
+    if (('X' != *candidate) && ('Y' != *candidate))
+      continue;
+
+    auto p = candidate;
+
+    for (auto idx = 0u; p && (idx < 4); ++idx) {
+      if ((p == end) || (('X' != *p) && ('Y' != *p)))
+        p = nullptr;
+
+      else {
+        auto digits = p + 1;
+        p           = skip_digits(digits, end);
+
+        if ((p == digits) || (p == end) || (':' != *p))
+          p = nullptr;
+
+        else {
+          digits = p + 1;
+          p      = skip_digits(digits, end);
+          p      = p == digits ? nullptr : idx < 3 ? skip_spaces(p, end) : p;
+        }
+      }
+    }
+
+    if (!p)
+      continue;
+
+    // "\s*$" may match before any separator within the trailing spaces.
+    for (auto spaces_end = skip_spaces(p, end); p <= spaces_end; ++p)
+      if (is_line_end(p, begin, end))
+        return true;
+  }
+
+  return false;
+}
+
+bool
+is_ssa_section_header(std::string const &line,
+                      char const *header) {
+  return match_at_line_starts(line, [header](char const *p, char const *end) -> bool {
+    p = skip_spaces(p, end);
+
+    for (auto h = header; *h; ++h) {
+      if (' ' == *h) {
+        if ((p == end) || !is_space(*p))
+          return false;
+        p = skip_spaces(p, end);
+
+      } else if ((p == end) || (std::tolower(static_cast<unsigned char>(*p)) != *h))
+        return false;
+
+      else
+        ++p;
+    }
+
+    return true;
+  });
+}
+
+bool
+is_ssa_comment_or_empty(std::string const &line) {
+  auto begin = line.data();
+
+  return match_at_line_starts(line, [begin](char const *p, char const *end) -> bool {
+    auto spaces_end = skip_spaces(p, end);
+
+    if ((spaces_end < end) && (('!' == *spaces_end) || (';' == *spaces_end)))
+      return true;
+
+    for (; p <= spaces_end; ++p)
+      if (is_line_end(p, begin, end))
+        return true;
+
+    return false;
+  });
+}
+
+}}
@@ -0,0 +1,57 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   recognizing lines in text subtitle files
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_SUBTITLE_LINE_SCANNER_H
+#define MTX_COMMON_SUBTITLE_LINE_SCANNER_H
+
+#include "common/common_pch.h"
+
+// Hand-written replacements for the regular expressions the SRT and
+// SSA/ASS parsers used to match each line against. They accept
+// exactly what the corresponding Perl-style regular expressions
+// matched with boost::regex_search() (or boost::regex_match() where
+// noted), including the quirks of '^' and '$' matching at embedded
+// '\n', '\r' and '\f'.
+
+namespace mtx { namespace subtitles {
+
+struct srt_timestamp_t {
+  // Set if an odd number of the four components carries a minus sign.
+  bool negative;
+  int hours, minutes, seconds;
+  // The fraction's first nine digits padded with zeros.
+  int64_t nanoseconds;
+
+  srt_timestamp_t();
+};
+
+// "^\d+$" with regex_match()
+bool is_srt_number(std::string const &line);
+
+// "^T\s*[\-\s]+>\s*T\s*" with T being a timestamp
+// "\s*(-?)\s*(\d+):\s*(-?)\s*(\d+):\s*(-?)\s*(\d+)[,\.:]\s*(-?)\s*(\d+)"
+bool parse_srt_timestamp_line(std::string const &line, srt_timestamp_t &start, srt_timestamp_t &end);
+
+// "([XY]\d+:\d+\s*){4}\s*$"
+bool has_srt_coordinates(std::string const &line);
+
+// "^\s*" followed by 'header' matched case-insensitively with each
+// space in 'header' standing for "\s+", e.g. "[script info]"
+bool is_ssa_section_header(std::string const &line, char const *header);
+
+// "^\s*$|^\s*[!;]"
+bool is_ssa_comment_or_empty(std::string const &line);
+
+}}
+
+#endif  // MTX_COMMON_SUBTITLE_LINE_SCANNER_H
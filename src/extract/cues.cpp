@@ -12,15 +12,14 @@
 
 #include "common/common_pch.h"
 
-#include <ebml/EbmlStream.h>
 #include <matroska/KaxCluster.h>
 #include <matroska/KaxCues.h>
 #include <matroska/KaxCuesData.h>
-#include <matroska/KaxSegment.h>
 #include <matroska/KaxTracks.h>
 
 #include "common/ebml.h"
 #include "common/kax_analyzer.h"
+#include "common/kax_cluster_walker.h"
 #include "common/mm_io_x.h"
 #include "common/strings/formatting.h"
 #include "extract/mkvextract.h"
@@ -154,23 +153,34 @@ static void
 determine_cluster_data_start_positions(mm_io_c &file,
                                        uint64_t segment_data_start_pos,
                                        std::unordered_map<int64_t, std::vector<cue_point_t> > &cue_points) {
-  auto es           = std::make_shared<EbmlStream>(file);
-  auto upper_lvl_el = 0;
+  // Only the clusters' header sizes are needed. Read the element
+  // headers directly instead of having libebml parse them, and only
+  // once per cluster even if several tracks' cue points refer to it.
+  auto walker            = kax_cluster_walker_c{file, TIMECODE_SCALE};
+  auto head_sizes_by_pos = std::unordered_map<uint64_t, unsigned int>{};
 
   for (auto &track_cue_points_pair : cue_points) {
     for (auto &cue_point : track_cue_points_pair.second) {
       if (!cue_point.cluster_position || !cue_point.relative_position)
         continue;
 
-      try {
-        file.setFilePointer(segment_data_start_pos + cue_point.cluster_position.get());
-        auto elt = std::shared_ptr<EbmlElement>(es->FindNextElement(EBML_CLASS_CONTEXT(KaxSegment), upper_lvl_el, std::numeric_limits<int64_t>::max(), true));
+      auto position = segment_data_start_pos + cue_point.cluster_position.get();
+      auto itr      = head_sizes_by_pos.find(position);
 
-        if (elt && Is<KaxCluster>(*elt))
-          cue_point.relative_position = cue_point.relative_position.get() + elt->HeadSize();
+      if (head_sizes_by_pos.end() == itr) {
+        kax_cluster_walker_c::element_header_t header;
+        auto head_size = 0u;
 
-      } catch (mtx::mm_io::exception &) {
+        try {
+          if (walker.read_element_header(position, header) && (EBML_ID_VALUE(EBML_ID(KaxCluster)) == header.id))
+            head_size = header.head_size;
+        } catch (mtx::mm_io::exception &) {
+        }
+
+        itr = head_sizes_by_pos.insert({ position, head_size }).first;
       }
+
+      cue_point.relative_position = cue_point.relative_position.get() + itr->second;
     }
   }
 }
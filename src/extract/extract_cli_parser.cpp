@@ -14,6 +14,7 @@
 #include "common/common_pch.h"
 
 #include "common/ebml.h"
+#include "common/output_digest.h"
 #include "common/strings/formatting.h"
 #include "common/strings/parsing.h"
 #include "common/translation.h"
@@ -58,17 +59,23 @@ extract_cli_parser_c::init_parser() {
                      "All other options depend on the mode."));
 
   add_section_header(YT("Global options"));
-  OPT("f|parse-fully",    set_parse_fully,      YT("Parse the whole file instead of relying on the index."));
+  OPT("f|parse-fully",           set_parse_fully,   YT("Parse the whole file instead of relying on the index."));
+  OPT("start=timestamp",         set_start,         YT("Only extract frames with timestamps at or after this timestamp. Video may therefore start "
+                                                   "with a frame that isn't a key frame (only valid for track and timecode extraction)."));
+  OPT("end=timestamp",           set_end,           YT("Only extract data before this timestamp (only valid for track and timecode extraction)."));
 
   add_common_options();
 
   add_section_header(YT("Track extraction"));
   add_information(YT("The first mode extracts some tracks to external files."));
-  OPT("c=charset",      set_charset,  YT("Convert text subtitles to this charset (default: UTF-8)."));
-  OPT("cuesheet",       set_cuesheet, YT("Also try to extract the CUE sheet from the chapter information and tags for this track."));
-  OPT("blockadd=level", set_blockadd, YT("Keep only the BlockAdditions up to this level (default: keep all levels)"));
-  OPT("raw",            set_raw,      YT("Extract the data to a raw file."));
-  OPT("fullraw",        set_fullraw,  YT("Extract the data to a raw file including the CodecPrivate as a header."));
+  OPT("c=charset",               set_charset,       YT("Convert text subtitles to this charset (default: UTF-8)."));
+  OPT("cuesheet",                set_cuesheet,      YT("Also try to extract the CUE sheet from the chapter information and tags for this track."));
+  OPT("blockadd=level",          set_blockadd,      YT("Keep only the BlockAdditions up to this level (default: keep all levels)"));
+  OPT("raw",                     set_raw,           YT("Extract the data to a raw file."));
+  OPT("fullraw",                 set_fullraw,       YT("Extract the data to a raw file including the CodecPrivate as a header."));
+  OPT("verify-crc32",            set_verify_crc32,  YT("Verify the CRC-32 elements of all clusters and headers read and report the byte ranges that are damaged."));
+  OPT("output-digest=algorithm", set_output_digest, YT("Calculate the digest of each output file while writing it and store it in a file next to it "
+                                                       "(algorithm: 'md5', 'crc32' or 'adler32')."));
   add_informational_option("TID:out", YT("Write track with the ID TID to the file 'out'."));
 
   add_section_header(YT("Example"));
@@ -145,6 +152,34 @@ extract_cli_parser_c::set_parse_fully() {
   m_options.m_parse_mode = kax_analyzer_c::parse_mode_full;
 }
 
+void
+extract_cli_parser_c::assert_time_range_mode() {
+  if (   (options_c::em_tracks       != m_options.m_extraction_mode)
+      && (options_c::em_timecodes_v2 != m_options.m_extraction_mode))
+    mxerror(boost::format(Y("'%1%' is only allowed when extracting tracks or timecodes.\n")) % m_current_arg);
+}
+
+timestamp_c
+extract_cli_parser_c::parse_time_range_timestamp() {
+  assert_time_range_mode();
+
+  int64_t timestamp;
+  if (!parse_timecode(m_next_arg, timestamp))
+    mxerror(boost::format(Y("Invalid timestamp '%1%' in '%2% %1%': %3%\n")) % m_next_arg % m_current_arg % timecode_parser_error);
+
+  return timestamp_c::ns(timestamp);
+}
+
+void
+extract_cli_parser_c::set_start() {
+  m_options.m_time_range.m_start = parse_time_range_timestamp();
+}
+
+void
+extract_cli_parser_c::set_end() {
+  m_options.m_time_range.m_end = parse_time_range_timestamp();
+}
+
 void
 extract_cli_parser_c::set_charset() {
   assert_mode(options_c::em_tracks);
@@ -176,6 +211,23 @@ extract_cli_parser_c::set_fullraw() {
   m_target_mode = track_spec_t::tm_full_raw;
 }
 
+void
+extract_cli_parser_c::set_verify_crc32() {
+  assert_mode(options_c::em_tracks);
+  m_options.m_verify_crc32 = true;
+}
+
+void
+extract_cli_parser_c::set_output_digest() {
+  assert_mode(options_c::em_tracks);
+
+  auto algorithm = mtx::checksum::algorithm_e::md5;
+  if (!output_digest_c::parse_algorithm(m_next_arg, algorithm))
+    mxerror(boost::format(Y("Invalid digest algorithm in '--output-digest %1%'.\n")) % m_next_arg);
+
+  m_options.m_output_digest = algorithm;
+}
+
 void
 extract_cli_parser_c::set_simple() {
   assert_mode(options_c::em_chapters);
@@ -275,5 +327,12 @@ extract_cli_parser_c::run() {
 
   parse_args();
 
+  auto const &range = m_options.m_time_range;
+  if (range.m_start.valid() && range.m_end.valid() && (range.m_start >= range.m_end))
+    mxerror(Y("The start timestamp must be smaller than the end timestamp.\n"));
+
+  for (auto &track : m_options.m_tracks)
+    track.output_digest = m_options.m_output_digest;
+
   return m_options;
 }
@@ -41,13 +41,19 @@ protected:
   void set_default_values();
 
   void assert_mode(options_c::extraction_mode_e mode);
+  void assert_time_range_mode();
+  timestamp_c parse_time_range_timestamp();
 
   void set_parse_fully();
+  void set_start();
+  void set_end();
   void set_charset();
   void set_cuesheet();
   void set_blockadd();
   void set_raw();
   void set_fullraw();
+  void set_verify_crc32();
+  void set_output_digest();
   void set_simple();
   void set_mode_or_extraction_spec();
   void set_extraction_mode();
@@ -0,0 +1,147 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   worker threads processing frames for extractors
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/output.h"
+#include "extract/extraction_worker.h"
+#include "extract/mkvextract.h"
+
+extraction_worker_c::extraction_worker_c(std::string const &file_name,
+                                         std::size_t max_queued_jobs,
+                                         std::size_t max_queued_bytes)
+  : m_file_name{file_name}
+  , m_max_queued_jobs{max_queued_jobs}
+  , m_max_queued_bytes{max_queued_bytes}
+{
+  m_thread = std::thread{[this]() { run(); }};
+}
+
+extraction_worker_c::~extraction_worker_c() {
+  // Normally finish() has been called already. If not then the
+  // program is terminating due to an error, and processing the
+  // remaining jobs makes no sense anymore. Only the job currently
+  // running is waited for as it still uses this object.
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_aborting = true;
+  }
+
+  m_jobs_available.notify_one();
+
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+void
+extraction_worker_c::add_job(std::function<void()> const &job,
+                             std::size_t num_bytes) {
+  std::unique_lock<std::mutex> lock{m_mutex};
+
+  // Always accept at least one job even if it alone exceeds the byte
+  // limit.
+  m_space_available.wait(lock, [this]() {
+    return m_exception
+        || m_jobs.empty()
+        || ((m_jobs.size() < m_max_queued_jobs) && (m_queued_bytes < m_max_queued_bytes));
+  });
+
+  if (m_exception) {
+    // Reporting the error may terminate the program which destroys
+    // this object. The lock must not be held at that point.
+    lock.unlock();
+    rethrow_exception_if_any();
+  }
+
+  m_jobs.emplace_back(job, num_bytes);
+  m_queued_bytes += num_bytes;
+
+  lock.unlock();
+  m_jobs_available.notify_one();
+}
+
+void
+extraction_worker_c::finish() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_finishing = true;
+  }
+
+  m_jobs_available.notify_one();
+
+  if (m_thread.joinable())
+    m_thread.join();
+
+  rethrow_exception_if_any();
+}
+
+void
+extraction_worker_c::rethrow_exception_if_any() {
+  if (!m_exception)
+    return;
+
+  try {
+    std::rethrow_exception(m_exception);
+
+  } catch (mtx::error_message_x &ex) {
+    mxerror(ex.what());
+
+  } catch (mtx::mm_io::exception &ex) {
+    show_error(boost::format(Y("The file '%1%' could not be written: %2%.\n")) % m_file_name % ex);
+
+  } catch (mtx::exception &ex) {
+    show_error(boost::format(Y("An error occurred while writing the file '%1%': %2%.\n")) % m_file_name % ex.error());
+
+  } catch (...) {
+    show_error(Y("Caught exception"));
+  }
+}
+
+void
+extraction_worker_c::run() {
+  mtx::errors_as_exceptions_c errors_as_exceptions;
+
+  while (true) {
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    m_jobs_available.wait(lock, [this]() { return m_aborting || m_finishing || !m_jobs.empty(); });
+
+    if (m_aborting || m_jobs.empty())
+      return;
+
+    auto job = std::move(m_jobs.front());
+    m_jobs.pop_front();
+
+    lock.unlock();
+
+    try {
+      job.first();
+
+    } catch (...) {
+      lock.lock();
+      m_exception = std::current_exception();
+      m_jobs.clear();
+      m_queued_bytes = 0;
+      lock.unlock();
+
+      m_space_available.notify_one();
+
+      return;
+    }
+
+    lock.lock();
+    m_queued_bytes -= job.second;
+    lock.unlock();
+
+    m_space_available.notify_one();
+  }
+}
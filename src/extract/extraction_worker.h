@@ -0,0 +1,59 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   worker threads processing frames for extractors
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_EXTRACT_EXTRACTION_WORKER_H
+#define MTX_EXTRACT_EXTRACTION_WORKER_H
+
+#include "common/common_pch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+// A worker runs all jobs for one output file in its own thread. Jobs
+// are queued by the thread parsing the clusters. The queue is bounded
+// both by the number of jobs and by the number of bytes they
+// reference so that a slow output cannot make the memory usage
+// explode.
+//
+// Errors reported via mxerror() in a job don't terminate the program
+// from the worker thread. They're handed to the thread queuing jobs
+// instead and reported there by the next call to add_job() or
+// finish(). The same applies to I/O and other exceptions which are
+// reported for the output file the worker writes to.
+class extraction_worker_c {
+protected:
+  std::string m_file_name;
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_jobs_available, m_space_available;
+  std::deque<std::pair<std::function<void()>, std::size_t> > m_jobs;
+  std::size_t m_queued_bytes{}, m_max_queued_jobs, m_max_queued_bytes;
+  bool m_finishing{}, m_aborting{};
+  std::exception_ptr m_exception;
+
+public:
+  extraction_worker_c(std::string const &file_name, std::size_t max_queued_jobs = 1024, std::size_t max_queued_bytes = 32 * 1024 * 1024);
+  ~extraction_worker_c();
+
+  void add_job(std::function<void()> const &job, std::size_t num_bytes);
+  void finish();
+
+protected:
+  void run();
+  void rethrow_exception_if_any();
+};
+using extraction_worker_cptr = std::shared_ptr<extraction_worker_c>;
+
+#endif // MTX_EXTRACT_EXTRACTION_WORKER_H
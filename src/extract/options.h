@@ -13,6 +13,8 @@
 
 #include "common/common_pch.h"
 
+#include "extract/time_range.h"
+
 class options_c {
 public:
   enum extraction_mode_e {
@@ -27,12 +29,16 @@ public:
   };
 
   std::string m_file_name;
-  bool m_simple_chapter_format;
+  bool m_simple_chapter_format, m_verify_crc32;
   kax_analyzer_c::parse_mode_e m_parse_mode;
   extraction_mode_e m_extraction_mode;
 
   std::vector<track_spec_t> m_tracks;
 
+  boost::optional<mtx::checksum::algorithm_e> m_output_digest;
+
+  time_range_c m_time_range;
+
 public:
   options_c();
 };
@@ -0,0 +1,128 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   restricting extraction to a range of timestamps
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <matroska/KaxCluster.h>
+#include <matroska/KaxCues.h>
+#include <matroska/KaxCuesData.h>
+
+#include "common/ebml.h"
+#include "common/strings/formatting.h"
+#include "extract/time_range.h"
+
+using namespace libmatroska;
+
+bool
+time_range_c::is_set()
+  const {
+  return m_start.valid() || m_end.valid();
+}
+
+bool
+time_range_c::includes(int64_t timestamp)
+  const {
+  // The cue point is only used for seeking. Filtering always uses
+  // the start given by the user so that the same frames are selected
+  // no matter whether or not the file contains cues.
+  if (m_start.valid() && (timestamp < m_start.to_ns()))
+    return false;
+
+  return !is_past_end(timestamp);
+}
+
+bool
+time_range_c::is_past_end(int64_t timestamp)
+  const {
+  return m_end.valid() && (timestamp >= m_end.to_ns());
+}
+
+boost::optional<uint64_t>
+time_range_c::determine_start_position(kax_analyzer_c &analyzer,
+                                       uint64_t timecode_scale) {
+  if (!m_start.valid())
+    return {};
+
+  auto cues_m = analyzer.read_all(EBML_INFO(KaxCues));
+  auto cues   = dynamic_cast<KaxCues *>(cues_m.get());
+
+  if (!cues) {
+    mxinfo(Y("The file does not contain cues. The whole file will be read in order to find the start position.\n"));
+    return {};
+  }
+
+  auto start_tc         = m_start.to_ns() / static_cast<int64_t>(timecode_scale);
+  auto best_tc          = boost::optional<uint64_t>{};
+  auto cluster_position = boost::optional<uint64_t>{};
+
+  for (auto const &elt : *cues) {
+    auto kcue_point = dynamic_cast<KaxCuePoint *>(elt);
+    if (!kcue_point)
+      continue;
+
+    auto ktime = FindChild<KaxCueTime>(*kcue_point);
+    if (!ktime || (ktime->GetValue() > static_cast<uint64_t>(start_tc)) || (best_tc && (ktime->GetValue() < *best_tc)))
+      continue;
+
+    // A cue point may reference several tracks. Use the earliest
+    // cluster so that no track's data is skipped.
+    auto position = boost::optional<uint64_t>{};
+
+    for (auto const &pos_elt : *kcue_point) {
+      auto ktrack_pos = dynamic_cast<KaxCueTrackPositions *>(pos_elt);
+      auto kcluster   = ktrack_pos ? FindChild<KaxCueClusterPosition>(*ktrack_pos) : nullptr;
+
+      if (kcluster && (!position || (kcluster->GetValue() < *position)))
+        position.reset(kcluster->GetValue());
+    }
+
+    if (!position)
+      continue;
+
+    if (!best_tc || (ktime->GetValue() > *best_tc) || (*position < *cluster_position)) {
+      best_tc          = ktime->GetValue();
+      cluster_position = position;
+    }
+  }
+
+  if (!cluster_position) {
+    mxdebug_if(m_debug, boost::format("no cue point found at or before %1%\n") % format_timestamp(m_start));
+    return {};
+  }
+
+  auto file_pos = analyzer.get_segment_data_start_pos() + *cluster_position;
+
+  mxdebug_if(m_debug,
+             boost::format("start %1%: using cue point at %2% with cluster at file position %3%\n")
+             % format_timestamp(m_start) % format_timestamp(timestamp_c::ns(*best_tc * timecode_scale)) % file_pos);
+
+  return file_pos;
+}
+
+boost::optional<uint64_t>
+time_range_c::determine_first_cluster_to_read(kax_analyzer_c &analyzer,
+                                              uint64_t timecode_scale) {
+  auto position = determine_start_position(analyzer, timecode_scale);
+  return position ? position : find_first_cluster_position(analyzer);
+}
+
+boost::optional<uint64_t>
+time_range_c::find_first_cluster_position(kax_analyzer_c &analyzer) {
+  auto position = boost::optional<uint64_t>{};
+
+  analyzer.with_elements(EBML_ID(KaxCluster), [&position](kax_analyzer_data_c const &data) {
+    if (!position || (data.m_pos < *position))
+      position = data.m_pos;
+  });
+
+  return position;
+}
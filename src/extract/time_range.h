@@ -0,0 +1,46 @@
+/*
+   mkvextract -- extract tracks from Matroska files into other files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   restricting extraction to a range of timestamps
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_EXTRACT_TIME_RANGE_H
+#define MTX_EXTRACT_TIME_RANGE_H
+
+#include "common/common_pch.h"
+
+#include "common/kax_analyzer.h"
+#include "common/timestamp.h"
+
+class time_range_c {
+public:
+  timestamp_c m_start, m_end;
+  debugging_option_c m_debug{"time_range"};
+
+public:
+  bool is_set() const;
+  bool includes(int64_t timestamp) const;
+  bool is_past_end(int64_t timestamp) const;
+
+  // Uses the file's cues for finding the position of the cluster
+  // containing the last cue point at or before the start
+  // timestamp. Returns nothing if no start was given or if no usable
+  // cue point exists. In that case the caller has to read the file
+  // from the beginning.
+  boost::optional<uint64_t> determine_start_position(kax_analyzer_c &analyzer, uint64_t timecode_scale);
+
+  // Returns the position of the first cluster to read: the one found
+  // via the cues as above or, if there's none, the file's first
+  // cluster. Returns nothing only if the file contains no clusters.
+  boost::optional<uint64_t> determine_first_cluster_to_read(kax_analyzer_c &analyzer, uint64_t timecode_scale);
+
+  static boost::optional<uint64_t> find_first_cluster_position(kax_analyzer_c &analyzer);
+};
+
+#endif // MTX_EXTRACT_TIME_RANGE_H
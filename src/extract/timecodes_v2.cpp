@@ -15,23 +15,14 @@
 #include <cassert>
 #include <algorithm>
 
-#include <ebml/EbmlHead.h>
-#include <ebml/EbmlSubHead.h>
-#include <ebml/EbmlStream.h>
-#include <ebml/EbmlVersion.h>
-#include <ebml/EbmlVoid.h>
-
-#include <matroska/KaxBlock.h>
-#include <matroska/KaxBlockData.h>
 #include <matroska/KaxCluster.h>
-#include <matroska/KaxClusterData.h>
 #include <matroska/KaxInfo.h>
 #include <matroska/KaxInfoData.h>
-#include <matroska/KaxSegment.h>
 #include <matroska/KaxTracks.h>
 #include <matroska/KaxTrackEntryData.h>
 
 #include "common/ebml.h"
+#include "common/kax_cluster_walker.h"
 #include "common/mm_io_x.h"
 #include "common/mm_write_buffer_io.h"
 #include "common/strings/formatting.h"
@@ -136,242 +127,90 @@ find_extractor_by_track_number(unsigned int track_number) {
 }
 
 static void
-handle_blockgroup(KaxBlockGroup &blockgroup,
-                  KaxCluster &cluster,
-                  int64_t tc_scale) {
-  // Only continue if this block group actually contains a block.
-  KaxBlock *block = FindChild<KaxBlock>(&blockgroup);
-  if (!block)
-    return;
-  block->SetParent(cluster);
-
-  // Do we need this block group?
-  std::vector<timecode_extractor_t>::iterator extractor = find_extractor_by_track_number(block->TrackNum());
+handle_block(kax_block_header_t const &block,
+             time_range_c const &time_range) {
+  auto extractor = find_extractor_by_track_number(block.track_number);
   if (timecode_extractors.end() == extractor)
     return;
 
-  // Next find the block duration if there is one.
-  KaxBlockDuration *kduration = FindChild<KaxBlockDuration>(&blockgroup);
-  int64_t duration            = !kduration ? extractor->m_default_duration * block->NumberFrames() : kduration->GetValue() * tc_scale;
-
-  // Pass the block to the extractor.
-  size_t i;
-  for (i = 0; block->NumberFrames() > i; ++i)
-    extractor->m_timecodes.push_back(timecode_t(block->GlobalTimecode() + i * duration / block->NumberFrames(), duration / block->NumberFrames()));
-}
-
-static void
-handle_simpleblock(KaxSimpleBlock &simpleblock,
-                   KaxCluster &cluster) {
-  if (0 == simpleblock.NumberFrames())
+  auto num_frames = block.frame_sizes.size();
+  if (!num_frames)
     return;
 
-  simpleblock.SetParent(cluster);
+  // Only block groups can contain a duration; fall back to the track's
+  // default duration for everything else.
+  auto duration   = block.duration ? *block.duration : extractor->m_default_duration * static_cast<int64_t>(num_frames);
 
-  std::vector<timecode_extractor_t>::iterator extractor = find_extractor_by_track_number(simpleblock.TrackNum());
-  if (timecode_extractors.end() == extractor)
-    return;
-
-  // Pass the block to the extractor.
-  size_t i;
-  for (i = 0; simpleblock.NumberFrames() > i; ++i)
-    extractor->m_timecodes.push_back(timecode_t(simpleblock.GlobalTimecode() + i * extractor->m_default_duration, extractor->m_default_duration));
+  for (auto i = 0u; num_frames > i; ++i) {
+    auto timecode = block.timecode + i * duration / static_cast<int64_t>(num_frames);
+    if (time_range.includes(timecode))
+      extractor->m_timecodes.push_back(timecode_t(timecode, duration / static_cast<int64_t>(num_frames)));
+  }
 }
 
 void
 extract_timecodes(const std::string &file_name,
                   std::vector<track_spec_t> &tspecs,
-                  int version) {
+                  int version,
+                  kax_analyzer_c::parse_mode_e parse_mode,
+                  time_range_c time_range) {
   if (tspecs.empty())
     mxerror(Y("Nothing to do.\n"));
 
-  // open input file
-  mm_io_c *in;
-  try {
-    in = new mm_file_io_c(file_name, MODE_READ);
-  } catch (mtx::mm_io::exception &ex) {
-    show_error(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % file_name % ex);
+  auto analyzer = open_and_analyze(file_name, parse_mode, false);
+  if (!analyzer)
     return;
-  }
 
-  try {
-    int64_t file_size = in->get_size();
-    EbmlStream *es    = new EbmlStream(*in);
-
-    // Find the EbmlHead element. Must be the first one.
-    EbmlElement *l0 = es->FindNextID(EBML_INFO(EbmlHead), 0xFFFFFFFFL);
-    if (!l0) {
-      show_error(Y("Error: No EBML head found."));
-      delete es;
+  uint64_t tc_scale = TIMECODE_SCALE;
+  auto af_master    = ebml_master_cptr{ analyzer->read_all(EBML_INFO(KaxInfo)) };
+  auto info         = dynamic_cast<KaxInfo *>(af_master.get());
+  if (info)
+    tc_scale = FindChildValue<KaxTimecodeScale>(info, TIMECODE_SCALE);
 
-      return;
-    }
+  af_master   = ebml_master_cptr{ analyzer->read_all(EBML_INFO(KaxTracks)) };
+  auto tracks = dynamic_cast<KaxTracks *>(af_master.get());
+  if (!tracks) {
+    show_error(Y("No track information found."));
+    return;
+  }
 
-    // Don't verify its data for now.
-    l0->SkipData(*es, EBML_CONTEXT(l0));
-    delete l0;
-
-    while (1) {
-      // Next element must be a segment
-      l0 = es->FindNextID(EBML_INFO(KaxSegment), 0xFFFFFFFFFFFFFFFFLL);
-      if (!l0) {
-        show_error(Y("No segment/level 0 element found."));
-        return;
-      }
-      if (Is<KaxSegment>(l0)) {
-        show_element(l0, 0, Y("Segment"));
-        break;
-      }
-
-      l0->SkipData(*es, EBML_CONTEXT(l0));
-      delete l0;
-    }
+  find_and_verify_track_uids(*tracks, tspecs);
+  create_timecode_files(*tracks, tspecs, version);
 
-    bool tracks_found = false;
-    int upper_lvl_el  = 0;
-    uint64_t tc_scale = TIMECODE_SCALE;
-
-    // We've got our segment, so let's find the tracks
-    EbmlElement *l1   = es->FindNextElement(EBML_CONTEXT(l0), upper_lvl_el, 0xFFFFFFFFL, true, 1);
-    EbmlElement *l2   = nullptr;
-    EbmlElement *l3   = nullptr;
-
-    while (l1 && (0 >= upper_lvl_el)) {
-      if (Is<KaxInfo>(l1)) {
-        // General info about this Matroska file
-        show_element(l1, 1, Y("Segment information"));
-
-        upper_lvl_el = 0;
-        l2           = es->FindNextElement(EBML_CONTEXT(l1), upper_lvl_el, 0xFFFFFFFFL, true, 1);
-        while (l2 && (0 >= upper_lvl_el)) {
-          if (Is<KaxTimecodeScale>(l2)) {
-            KaxTimecodeScale &ktc_scale = *static_cast<KaxTimecodeScale *>(l2);
-            ktc_scale.ReadData(es->I_O());
-            tc_scale = ktc_scale.GetValue();
-            show_element(l2, 2, boost::format(Y("Timecode scale: %1%")) % tc_scale);
-          } else
-            l2->SkipData(*es, EBML_CONTEXT(l2));
-
-          if (!in_parent(l1)) {
-            delete l2;
-            break;
-          }
-
-          if (0 > upper_lvl_el) {
-            upper_lvl_el++;
-            if (0 > upper_lvl_el)
-              break;
-
-          }
-
-          l2->SkipData(*es, EBML_CONTEXT(l2));
-          delete l2;
-          l2 = es->FindNextElement(EBML_CONTEXT(l1), upper_lvl_el, 0xFFFFFFFFL, true);
-        }
-
-      } else if ((Is<KaxTracks>(l1)) && !tracks_found) {
-
-        // Yep, we've found our KaxTracks element. Now find all tracks
-        // contained in this segment.
-        show_element(l1, 1, Y("Segment tracks"));
-
-        tracks_found = true;
-        l1->Read(*es, EBML_CLASS_CONTEXT(KaxTracks), upper_lvl_el, l2, true);
-        find_and_verify_track_uids(*dynamic_cast<KaxTracks *>(l1), tspecs);
-        create_timecode_files(*dynamic_cast<KaxTracks *>(l1), tspecs, version);
-
-      } else if (Is<KaxCluster>(l1)) {
-        show_element(l1, 1, Y("Cluster"));
-        KaxCluster *cluster = (KaxCluster *)l1;
-        uint64_t cluster_tc = 0;
+  // Without usable cues the clusters are walked from the first one
+  // on, and the frames before the start are filtered out.
+  auto start_position = time_range.determine_first_cluster_to_read(*analyzer, tc_scale);
+  if (!start_position) {
+    close_timecode_files();
+    return;
+  }
 
+  try {
+    // Only the block headers are needed. Walk the clusters directly
+    // and seek over all frame payloads instead of letting libebml read
+    // each cluster completely.
+    auto &in       = analyzer->get_file();
+    auto walker    = kax_cluster_walker_c{in, static_cast<int64_t>(tc_scale)};
+    auto file_size = static_cast<uint64_t>(in.get_size());
+    auto end_pos   = file_size;
+
+    kax_cluster_walker_c::element_header_t segment;
+    if (walker.read_element_header(analyzer->get_segment_pos(), segment) && !segment.unknown_size)
+      end_pos = std::min(end_pos, segment.position + segment.head_size + segment.size);
+
+    walker
+      .set_cluster_handler([&](uint64_t position, int64_t timecode) -> bool {
         if (0 == verbose)
-          mxinfo(boost::format(Y("Progress: %1%%%%2%")) % (int)(in->getFilePointer() * 100 / file_size) % "\r");
-
-        upper_lvl_el = 0;
-        l2           = es->FindNextElement(EBML_CONTEXT(l1), upper_lvl_el, 0xFFFFFFFFL, true, 1);
-        while (l2 && (0 >= upper_lvl_el)) {
-
-          if (Is<KaxClusterTimecode>(l2)) {
-            KaxClusterTimecode &ctc = *static_cast<KaxClusterTimecode *>(l2);
-            ctc.ReadData(es->I_O());
-            cluster_tc = ctc.GetValue();
-            show_element(l2, 2, boost::format(Y("Cluster timecode: %|1$.3f|s")) % ((float)cluster_tc * (float)tc_scale / 1000000000.0));
-            cluster->InitTimecode(cluster_tc, tc_scale);
-
-          } else if (Is<KaxBlockGroup>(l2)) {
-            show_element(l2, 2, Y("Block group"));
-
-            l2->Read(*es, EBML_CLASS_CONTEXT(KaxBlockGroup), upper_lvl_el, l3, true);
-            handle_blockgroup(*static_cast<KaxBlockGroup *>(l2), *cluster, tc_scale);
-
-          } else if (Is<KaxSimpleBlock>(l2)) {
-            show_element(l2, 2, Y("Simple block"));
-
-            l2->Read(*es, EBML_CLASS_CONTEXT(KaxSimpleBlock), upper_lvl_el, l3, true);
-            handle_simpleblock(*static_cast<KaxSimpleBlock *>(l2), *cluster);
-
-          } else
-            l2->SkipData(*es, EBML_CONTEXT(l2));
-
-          if (!in_parent(l1)) {
-            delete l2;
-            break;
-          }
-
-          if (0 < upper_lvl_el) {
-            upper_lvl_el--;
-            if (0 < upper_lvl_el)
-              break;
-            delete l2;
-            l2 = l3;
-            continue;
-
-          } else if (0 > upper_lvl_el) {
-            upper_lvl_el++;
-            if (0 > upper_lvl_el)
-              break;
-
-          }
-
-          l2->SkipData(*es, EBML_CONTEXT(l2));
-          delete l2;
-          l2 = es->FindNextElement(EBML_CONTEXT(l1), upper_lvl_el, 0xFFFFFFFFL, true);
-
-        } // while (l2)
-
-      } else
-        l1->SkipData(*es, EBML_CONTEXT(l1));
-
-      if (!in_parent(l0)) {
-        delete l1;
-        break;
-      }
-
-      if (0 < upper_lvl_el) {
-        upper_lvl_el--;
-        if (0 < upper_lvl_el)
-          break;
-        delete l1;
-        l1 = l2;
-        continue;
-
-      } else if (0 > upper_lvl_el) {
-        upper_lvl_el++;
-        if (0 > upper_lvl_el)
-          break;
-
-      }
-
-      l1->SkipData(*es, EBML_CONTEXT(l1));
-      delete l1;
-      l1 = es->FindNextElement(EBML_CONTEXT(l0), upper_lvl_el, 0xFFFFFFFFL, true);
+          mxinfo(boost::format(Y("Progress: %1%%%%2%")) % (position * 100 / std::max<uint64_t>(file_size, 1)) % "\r");
 
-    } // while (l1)
+        return !time_range.is_past_end(timecode);
+      })
+      .set_block_handler([&time_range](kax_block_header_t const &block) {
+        handle_block(block, time_range);
+      });
 
-    delete l0;
-    delete es;
-    delete in;
+    if (!walker.walk(*start_position, end_pos))
+      mxwarn(boost::format(Y("The file '%1%' contains invalid data after the last cluster that could be parsed.\n")) % file_name);
 
     close_timecode_files();
 
@@ -380,7 +219,6 @@ extract_timecodes(const std::string &file_name,
 
   } catch (...) {
     show_error(Y("Caught exception"));
-    delete in;
 
     close_timecode_files();
   }
@@ -15,6 +15,8 @@
 
 #include "common/common_pch.h"
 
+#include "common/checksums/base_fwd.h"
+
 struct track_spec_t {
   enum target_mode_e {
     tm_normal,
@@ -31,6 +33,8 @@ struct track_spec_t {
   target_mode_e target_mode;
   int extract_blockadd_level;
 
+  boost::optional<mtx::checksum::algorithm_e> output_digest;
+
   bool done;
 
   track_spec_t();
@@ -13,6 +13,7 @@
 #include "common/common_pch.h"
 
 #include <cassert>
+#include <unordered_set>
 
 #include <ebml/EbmlHead.h>
 #include <ebml/EbmlSubHead.h>
@@ -33,9 +34,12 @@
 #include <matroska/KaxTrackVideo.h>
 
 #include "common/ebml.h"
+#include "common/ebml_crc32.h"
 #include "common/kax_file.h"
 #include "common/mm_io_x.h"
 #include "common/mm_write_buffer_io.h"
+#include "common/strings/formatting.h"
+#include "extract/extraction_worker.h"
 #include "extract/mkvextract.h"
 #include "extract/xtr_base.h"
 
@@ -43,8 +47,50 @@ using namespace libmatroska;
 
 static std::vector<xtr_base_c *> extractors;
 
+// Decoding, converting and writing is done in one worker thread per
+// output file. Extractors writing to the same file (e.g. several
+// VobSub tracks) share their master's worker.
+static std::vector<extraction_worker_cptr> workers;
+static std::unordered_map<xtr_base_c *, extraction_worker_cptr> workers_by_extractor;
+
+// Video tracks for which no frame has been extracted yet. With a
+// start timestamp extraction may begin in the middle of a GOP which
+// the user is warned about.
+static std::unordered_set<xtr_base_c *> video_extractors_without_frames;
+
 // ------------------------------------------------------------------------
 
+static void
+create_workers() {
+  for (auto extractor : extractors) {
+    auto master = extractor->m_master ? extractor->m_master : extractor;
+    auto &worker = workers_by_extractor[master];
+
+    if (!worker) {
+      worker = std::make_shared<extraction_worker_c>(master->get_file_name().string());
+      workers.push_back(worker);
+    }
+
+    workers_by_extractor[extractor] = worker;
+  }
+}
+
+static void
+finish_workers() {
+  for (auto const &worker : workers)
+    worker->finish();
+
+  workers.clear();
+  workers_by_extractor.clear();
+}
+
+static void
+queue_job(xtr_base_c *extractor,
+          std::function<void()> const &job,
+          std::size_t num_bytes) {
+  workers_by_extractor[extractor]->add_job(job, num_bytes);
+}
+
 static void
 create_extractors(KaxTracks &kax_tracks,
                   std::vector<track_spec_t> &tracks) {
@@ -111,6 +157,10 @@ create_extractors(KaxTracks &kax_tracks,
     // We're done.
     extractors.push_back(extractor);
 
+    auto ktrack_type = FindChild<KaxTrackType>(track);
+    if (ktrack_type && (track_video == ktrack_type->GetValue()))
+      video_extractors_without_frames.insert(extractor);
+
     mxinfo(boost::format(Y("Extracting track %1% with the CodecID '%2%' to the file '%3%'. Container format: %4%\n"))
            % track_id % codec_id % extractor->get_file_name().string() % extractor->get_container_name());
   }
@@ -118,12 +168,28 @@ create_extractors(KaxTracks &kax_tracks,
   // Signal that all headers have been taken care of.
   for (i = 0; i < extractors.size(); i++)
     extractors[i]->headers_done();
+
+  create_workers();
+}
+
+static void
+check_first_video_frame(xtr_base_c *extractor,
+                        time_range_c const &time_range,
+                        int64_t timecode,
+                        bool keyframe) {
+  if (!video_extractors_without_frames.erase(extractor) || keyframe || !time_range.m_start.valid())
+    return;
+
+  mxwarn(boost::format(Y("The first frame extracted from track %1% at %2% is not a key frame. "
+                         "The output may not be decodable until the next key frame.\n"))
+         % extractor->m_tid % format_timestamp(timecode));
 }
 
 static int64_t
 handle_blockgroup(KaxBlockGroup &blockgroup,
                   KaxCluster &cluster,
-                  int64_t tc_scale) {
+                  int64_t tc_scale,
+                  time_range_c const &time_range) {
   // Only continue if this block group actually contains a block.
   KaxBlock *block = FindChild<KaxBlock>(&blockgroup);
   if (!block || (0 == block->NumberFrames()))
@@ -159,16 +225,18 @@ handle_blockgroup(KaxBlockGroup &blockgroup,
     kreference = FindNextChild<KaxReferenceBlock>(&blockgroup, kreference);
   }
 
-  // Any block additions present?
+  // Any block additions present? They're owned by the cluster which
+  // is gone by the time the worker processes the frames.
   KaxBlockAdditions *kadditions = FindChild<KaxBlockAdditions>(&blockgroup);
+  auto additions                = std::shared_ptr<KaxBlockAdditions>{ kadditions ? static_cast<KaxBlockAdditions *>(kadditions->Clone()) : nullptr };
 
   if (0 > duration)
     duration = extractor->m_default_duration * block->NumberFrames();
 
   KaxCodecState *kcstate = FindChild<KaxCodecState>(&blockgroup);
   if (kcstate) {
-    memory_cptr codec_state(new memory_c(kcstate->GetBuffer(), kcstate->GetSize(), false));
-    extractor->handle_codec_state(codec_state);
+    auto codec_state = memory_c::clone(kcstate->GetBuffer(), kcstate->GetSize());
+    queue_job(extractor, [extractor, codec_state]() mutable { extractor->handle_codec_state(codec_state); }, codec_state->get_size());
   }
 
   for (i = 0; i < block->NumberFrames(); i++) {
@@ -183,17 +251,25 @@ handle_blockgroup(KaxBlockGroup &blockgroup,
       this_duration = duration / block->NumberFrames();
     }
 
+    max_timecode = std::max(max_timecode, this_timecode);
+
+    if (!time_range.includes(this_timecode))
+      continue;
+
     auto discard_padding  = timestamp_c::ns(0);
     auto kdiscard_padding = FindChild<KaxDiscardPadding>(blockgroup);
     if (kdiscard_padding)
       discard_padding = timestamp_c::ns(kdiscard_padding->GetValue());
 
+    check_first_video_frame(extractor, time_range, this_timecode, !bref && !fref);
+
     auto &data = block->GetBuffer(i);
-    auto frame = std::make_shared<memory_c>(data.Buffer(), data.Size(), false);
-    auto f     = xtr_frame_t{frame, kadditions, this_timecode, this_duration, bref, fref, false, false, true, discard_padding};
-    extractor->decode_and_handle_frame(f);
+    auto frame = memory_c::clone(data.Buffer(), data.Size());
 
-    max_timecode = std::max(max_timecode, this_timecode);
+    queue_job(extractor, [=]() mutable {
+      auto f = xtr_frame_t{frame, additions.get(), this_timecode, this_duration, bref, fref, false, false, true, discard_padding};
+      extractor->decode_and_handle_frame(f);
+    }, frame->get_size());
   }
 
   return max_timecode;
@@ -201,7 +277,8 @@ handle_blockgroup(KaxBlockGroup &blockgroup,
 
 static int64_t
 handle_simpleblock(KaxSimpleBlock &simpleblock,
-                   KaxCluster &cluster) {
+                   KaxCluster &cluster,
+                   time_range_c const &time_range) {
   if (0 == simpleblock.NumberFrames())
     return - 1;
 
@@ -233,12 +310,22 @@ handle_simpleblock(KaxSimpleBlock &simpleblock,
       this_duration = duration / simpleblock.NumberFrames();
     }
 
-    auto &data = simpleblock.GetBuffer(i);
-    auto frame = std::make_shared<memory_c>(data.Buffer(), data.Size(), false);
-    auto f     = xtr_frame_t{frame, nullptr, this_timecode, this_duration, -1, -1, simpleblock.IsKeyframe(), simpleblock.IsDiscardable(), false, timestamp_c::ns(0)};
-    extractor->decode_and_handle_frame(f);
-
     max_timecode = std::max(max_timecode, this_timecode);
+
+    if (!time_range.includes(this_timecode))
+      continue;
+
+    auto &data       = simpleblock.GetBuffer(i);
+    auto frame       = memory_c::clone(data.Buffer(), data.Size());
+    auto keyframe    = simpleblock.IsKeyframe();
+    auto discardable = simpleblock.IsDiscardable();
+
+    check_first_video_frame(extractor, time_range, this_timecode, keyframe);
+
+    queue_job(extractor, [=]() mutable {
+      auto f = xtr_frame_t{frame, nullptr, this_timecode, this_duration, -1, -1, keyframe, discardable, false, timestamp_c::ns(0)};
+      extractor->decode_and_handle_frame(f);
+    }, frame->get_size());
   }
 
   return max_timecode;
@@ -248,6 +335,8 @@ static void
 close_extractors() {
   size_t i;
 
+  finish_workers();
+
   for (i = 0; i < extractors.size(); i++)
     extractors[i]->finish_track();
 
@@ -256,12 +345,40 @@ close_extractors() {
       extractors[i]->finish_file();
 
   for (i = 0; i < extractors.size(); i++) {
-    if (!extractors[i]->m_master)
+    if (!extractors[i]->m_master) {
       extractors[i]->finish_file();
+      extractors[i]->finish_output_digest();
+    }
     delete extractors[i];
   }
 
   extractors.clear();
+  video_extractors_without_frames.clear();
+}
+
+static void
+collect_chapters(KaxChapters &chapters,
+                 KaxChapters &all_chapters) {
+  while (chapters.ListSize() > 0) {
+    if (Is<KaxEditionEntry>(chapters[0])) {
+      KaxEditionEntry &entry = *static_cast<KaxEditionEntry *>(chapters[0]);
+      while (entry.ListSize() > 0) {
+        if (Is<KaxChapterAtom>(entry[0]))
+          all_chapters.PushElement(*entry[0]);
+        entry.Remove(0);
+      }
+    }
+    chapters.Remove(0);
+  }
+}
+
+static void
+collect_tags(KaxTags &tags,
+             KaxTags &all_tags) {
+  while (tags.ListSize() > 0) {
+    all_tags.PushElement(*tags[0]);
+    tags.Remove(0);
+  }
 }
 
 static void
@@ -344,7 +461,9 @@ handle_segment_info(EbmlMaster *info,
 bool
 extract_tracks(const std::string &file_name,
                std::vector<track_spec_t> &tspecs,
-               kax_analyzer_c::parse_mode_e parse_mode) {
+               kax_analyzer_c::parse_mode_e parse_mode,
+               time_range_c time_range,
+               bool verify_crc32) {
   if (tspecs.empty())
     mxerror(Y("Nothing to do.\n"));
 
@@ -361,7 +480,11 @@ extract_tracks(const std::string &file_name,
 
   int64_t file_size = in->get_size();
   uint64_t tc_scale = TIMECODE_SCALE;
-  bool segment_info_found = false, tracks_found = false;
+  bool segment_info_found = false, tracks_found = false, chapters_and_tags_read = false;
+  auto start_position     = boost::optional<uint64_t>{};
+
+  KaxChapters all_chapters;
+  KaxTags all_tags;
 
   // open input file
   auto analyzer = open_and_analyze(file_name, parse_mode, false);
@@ -380,6 +503,25 @@ extract_tracks(const std::string &file_name,
       find_and_verify_track_uids(*tracks, tspecs);
       create_extractors(*tracks, tspecs);
     }
+
+    // When only a part of the file is read the chapters and tags
+    // needed for the CUE sheets might be located in parts that are
+    // skipped. Get them from the analyzer instead.
+    if (time_range.is_set()) {
+      start_position = time_range.determine_start_position(*analyzer, tc_scale);
+
+      af_master     = ebml_master_cptr{ analyzer->read_all(EBML_INFO(KaxChapters)) };
+      auto chapters = dynamic_cast<KaxChapters *>(af_master.get());
+      if (chapters)
+        collect_chapters(*chapters, all_chapters);
+
+      af_master = ebml_master_cptr{ analyzer->read_all(EBML_INFO(KaxTags)) };
+      auto tags = dynamic_cast<KaxTags *>(af_master.get());
+      if (tags)
+        collect_tags(*tags, all_tags);
+
+      chapters_and_tags_read = true;
+    }
   }
 
   try {
@@ -417,12 +559,21 @@ extract_tracks(const std::string &file_name,
       delete l0;
     }
 
-    EbmlElement *l1   = nullptr;
+    // Skip directly to the cluster containing the start timestamp.
+    if (start_position)
+      in->setFilePointer(*start_position);
 
-    KaxChapters all_chapters;
-    KaxTags all_tags;
+    EbmlElement *l1   = nullptr;
 
     while ((l1 = file->read_next_level1_element())) {
+      if (verify_crc32) {
+        auto check = verify_ebml_crc32(*in, l1->GetElementPosition());
+        if (check.present && !check.valid)
+          mxwarn(boost::format(Y("The CRC-32 of the level 1 element at position %1% does not match (stored: 0x%|2$08x|, calculated: 0x%|3$08x|). "
+                                 "The bytes %4% to %5% are damaged.\n"))
+                 % l1->GetElementPosition() % check.stored % check.calculated % check.start % (check.end - 1));
+      }
+
       if (Is<KaxInfo>(l1) && !segment_info_found) {
         segment_info_found = true;
         handle_segment_info(static_cast<EbmlMaster *>(l1), file.get(), tc_scale);
@@ -447,6 +598,11 @@ extract_tracks(const std::string &file_name,
         } else
           cluster->InitTimecode(0, tc_scale);
 
+        if (time_range.is_past_end(cluster->GlobalTimecode())) {
+          delete l1;
+          break;
+        }
+
         size_t i;
         int64_t max_timecode = -1;
 
@@ -456,11 +612,11 @@ extract_tracks(const std::string &file_name,
 
           if (Is<KaxBlockGroup>(el)) {
             show_element(el, 2, Y("Block group"));
-            max_bg_timecode = handle_blockgroup(*static_cast<KaxBlockGroup *>(el), *cluster, tc_scale);
+            max_bg_timecode = handle_blockgroup(*static_cast<KaxBlockGroup *>(el), *cluster, tc_scale, time_range);
 
           } else if (Is<KaxSimpleBlock>(el)) {
             show_element(el, 2, Y("SimpleBlock"));
-            max_bg_timecode = handle_simpleblock(*static_cast<KaxSimpleBlock *>(el), *cluster);
+            max_bg_timecode = handle_simpleblock(*static_cast<KaxSimpleBlock *>(el), *cluster, time_range);
           }
 
           max_timecode = std::max(max_timecode, max_bg_timecode);
@@ -469,28 +625,11 @@ extract_tracks(const std::string &file_name,
         if (-1 != max_timecode)
           file->set_last_timecode(max_timecode);
 
-      } else if (Is<KaxChapters>(l1)) {
-        KaxChapters &chapters = *static_cast<KaxChapters *>(l1);
-
-        while (chapters.ListSize() > 0) {
-          if (Is<KaxEditionEntry>(chapters[0])) {
-            KaxEditionEntry &entry = *static_cast<KaxEditionEntry *>(chapters[0]);
-            while (entry.ListSize() > 0) {
-              if (Is<KaxChapterAtom>(entry[0]))
-                all_chapters.PushElement(*entry[0]);
-              entry.Remove(0);
-            }
-          }
-          chapters.Remove(0);
-        }
-
-      } else if (Is<KaxTags>(l1)) {
-        KaxTags &tags = *static_cast<KaxTags *>(l1);
+      } else if (Is<KaxChapters>(l1) && !chapters_and_tags_read) {
+        collect_chapters(*static_cast<KaxChapters *>(l1), all_chapters);
 
-        while (tags.ListSize() > 0) {
-          all_tags.PushElement(*tags[0]);
-          tags.Remove(0);
-        }
+      } else if (Is<KaxTags>(l1) && !chapters_and_tags_read) {
+        collect_tags(*static_cast<KaxTags *>(l1), all_tags);
 
       }
 
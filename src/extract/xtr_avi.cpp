@@ -60,6 +60,11 @@ xtr_avi_c::create_file(xtr_base_c *master,
   if (!m_avi)
     mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % m_file_name % AVI_strerror());
 
+  // avilib truncates the file on closing, something mm_write_buffer_io_c
+  // doesn't support.
+  if (m_output_digest)
+    mxwarn(boost::format(Y("Calculating the digest is not supported for AVI files. No digest will be written for the file '%1%'.\n")) % m_file_name);
+
   std::string writing_app = "mkvextract";
   if (!hack_engaged(ENGAGE_NO_VARIABLE_DATA))
     writing_app += (boost::format(" %1%") % PACKAGE_VERSION).str();
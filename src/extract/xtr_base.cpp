@@ -21,6 +21,7 @@
 #include "common/ebml.h"
 #include "common/mm_io_x.h"
 #include "common/mm_write_buffer_io.h"
+#include "common/output_digest.h"
 #include "common/strings/editing.h"
 #include "extract/xtr_aac.h"
 #include "extract/xtr_alac.h"
@@ -54,6 +55,7 @@ xtr_base_c::xtr_base_c(const std::string &codec_id,
   , m_bytes_written(0)
   , m_content_decoder_initialized(false)
   , m_debug{}
+  , m_output_digest{tspec.output_digest}
 {
 }
 
@@ -77,6 +79,8 @@ xtr_base_c::create_file(xtr_base_c *master,
     mxerror(boost::format(Y("Failed to create the file '%1%': %2% (%3%)\n")) % actual_file_name % errno % ex);
   }
 
+  enable_output_digest();
+
   m_default_duration = kt_get_default_duration(track);
 }
 
@@ -104,6 +108,41 @@ void
 xtr_base_c::headers_done() {
 }
 
+void
+xtr_base_c::enable_output_digest() {
+  if (m_out)
+    enable_output_digest(*m_out);
+}
+
+void
+xtr_base_c::enable_output_digest(mm_io_c &out) {
+  auto buffered_out = dynamic_cast<mm_write_buffer_io_c *>(&out);
+  if (m_output_digest && buffered_out)
+    buffered_out->enable_digest(*m_output_digest);
+}
+
+void
+xtr_base_c::finish_output_digest() {
+  if (m_out)
+    finish_output_digest(*m_out);
+}
+
+void
+xtr_base_c::finish_output_digest(mm_io_c &out) {
+  auto buffered_out = dynamic_cast<mm_write_buffer_io_c *>(&out);
+  if (!m_output_digest || !buffered_out)
+    return;
+
+  auto digest = buffered_out->finish_digest();
+  if (digest.empty())
+    return;
+
+  auto file_name = out.get_file_name();
+  output_digest_c::write_digest_file(file_name, *m_output_digest, digest);
+
+  mxinfo(boost::format(Y("The %1% digest of the file '%2%' is %3%.\n")) % output_digest_c::get_algorithm_name(*m_output_digest) % file_name % digest);
+}
+
 memory_cptr
 xtr_base_c::decode_codec_private(KaxCodecPrivate *priv) {
   memory_cptr mpriv(new memory_c(priv->GetBuffer(), priv->GetSize()));
@@ -47,6 +47,8 @@ public:
 
   bool m_debug;
 
+  boost::optional<mtx::checksum::algorithm_e> m_output_digest;
+
 public:
   xtr_base_c(const std::string &codec_id, int64_t tid, track_spec_t &tspec, const char *container_name = nullptr);
   virtual ~xtr_base_c();
@@ -62,6 +64,13 @@ public:
 
   virtual void headers_done();
 
+  // Only files written via mm_write_buffer_io_c can have their digest
+  // calculated. The variants without an argument work on m_out.
+  virtual void enable_output_digest();
+  virtual void enable_output_digest(mm_io_c &out);
+  virtual void finish_output_digest();
+  virtual void finish_output_digest(mm_io_c &out);
+
   virtual bfs::path get_file_name() const {
     return m_file_name;
   }
@@ -17,6 +17,7 @@
 #include "common/codec.h"
 #include "common/ebml.h"
 #include "common/mm_io_x.h"
+#include "common/mm_write_buffer_io.h"
 #include "common/strings/editing.h"
 #include "common/strings/formatting.h"
 #include "common/strings/parsing.h"
@@ -310,9 +311,11 @@ xtr_usf_c::create_file(xtr_base_c *master,
 
   } else {
     try {
-      m_out = mm_file_io_c::open(m_file_name, MODE_CREATE);
+      m_out = mm_write_buffer_io_c::open(m_file_name, 128 * 1024);
       m_doc = std::make_shared<pugi::xml_document>();
 
+      enable_output_digest();
+
       std::stringstream codec_private{m_codec_private};
       auto result = m_doc->load(codec_private, pugi::parse_default | pugi::parse_declaration | pugi::parse_doctype | pugi::parse_pi | pugi::parse_comments);
       if (!result)
@@ -74,6 +74,8 @@ xtr_tta_c::finish_file() {
     mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % m_file_name % ex);
   }
 
+  enable_output_digest();
+
   tta_file_header_t tta_header;
   memcpy(tta_header.signature, "TTA1", 4);
   if (3 != m_bps)
@@ -111,6 +113,8 @@ xtr_tta_c::finish_file() {
     m_out->write(buffer, nread);
   } while (nread == 128000);
 
+  finish_output_digest();
+
   m_out.reset();
   unlink(m_temp_file_name.c_str());
 }
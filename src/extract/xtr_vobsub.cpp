@@ -76,6 +76,8 @@ xtr_vobsub_c::create_file(xtr_base_c *master,
       mxerror(boost::format(Y("Failed to create the VobSub data file '%1%': %2%\n")) % m_sub_file_name.string() % ex);
     }
 
+    enable_output_digest();
+
   } else {
     xtr_vobsub_c *vmaster = dynamic_cast<xtr_vobsub_c *>(m_master);
 
@@ -200,9 +202,12 @@ xtr_vobsub_c::finish_file() {
   try {
     static const char *header_line = "# VobSub index file, v7 (do not modify this line!)\n";
 
+    finish_output_digest();
     m_out.reset();
 
     mm_write_buffer_io_c idx(new mm_file_io_c(m_idx_file_name.string(), MODE_CREATE), 128 * 1024);
+    enable_output_digest(idx);
+
     mxinfo(boost::format(Y("Writing the VobSub index file '%1%'.\n")) % m_idx_file_name.string());
 
     if ((25 > m_private_data->get_size()) || strncasecmp((char *)m_private_data->get_buffer(), header_line, 25))
@@ -214,6 +219,8 @@ xtr_vobsub_c::finish_file() {
     for (slave = 0; slave < m_slaves.size(); slave++)
       m_slaves[slave]->write_idx(idx, slave + 1);
 
+    finish_output_digest(idx);
+
   } catch (mtx::mm_io::exception &ex) {
     mxerror(boost::format(Y("Failed to create the file '%1%': %2%\n")) % m_idx_file_name.string() % ex);
   }
@@ -40,6 +40,8 @@ info_cli_parser_c::init_parser() {
   OPT("c|checksum",     set_checksum,     YT("Calculate and display checksums of frame contents."));
   OPT("C|check-mode",   set_check_mode,   YT("Calculate and display checksums and use verbosity level 4."));
   OPT("s|summary",      set_summary,      YT("Only show summaries of the contents, not each element."));
+  OPT("fast-summary",   set_fast_summary, YT("Like --summary but only reads the block headers and skips the frame contents. No checksums are shown."));
+  OPT("headers-only",   set_headers_only, YT("Only show the level 1 elements other than clusters. Elements after the first cluster are located via the seek heads."));
   OPT("t|track-info",   set_track_info,   YT("Show statistics for each track in verbose mode."));
   OPT("x|hexdump",      set_hexdump,      YT("Show the first 16 bytes of each frame as a hex dump."));
   OPT("X|full-hexdump", set_full_hexdump, YT("Show all bytes of each frame as a hex dump."));
@@ -77,6 +79,17 @@ info_cli_parser_c::set_summary() {
   m_options.m_show_summary   = true;
 }
 
+void
+info_cli_parser_c::set_fast_summary() {
+  m_options.m_show_summary = true;
+  m_options.m_fast_summary = true;
+}
+
+
+void
+info_cli_parser_c::set_headers_only() {
+  m_options.m_headers_only = true;
+}
 
 void
 info_cli_parser_c::set_hexdump() {
@@ -114,6 +127,16 @@ info_cli_parser_c::run() {
   init_parser();
   parse_args();
 
+  if (m_options.m_headers_only && m_options.m_show_summary)
+    mxerror(Y("'--headers-only' cannot be used together with '--summary' or '--fast-summary'.\n"));
+
+  if (m_options.m_fast_summary && m_options.m_show_hexdump)
+    mxerror(Y("'--fast-summary' cannot be used together with '--hexdump' or '--full-hexdump'.\n"));
+
+  // The fast summary never reads the frame contents.
+  if (m_options.m_fast_summary)
+    m_options.m_calc_checksums = false;
+
   m_options.m_verbose = verbose;
   verbose             = 0;
 
@@ -33,6 +33,8 @@ protected:
   void set_checksum();
   void set_check_mode();
   void set_summary();
+  void set_fast_summary();
+  void set_headers_only();
   void set_hexdump();
   void set_full_hexdump();
   void set_size();
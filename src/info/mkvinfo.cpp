@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <set>
 #include <typeinfo>
 
 #include <ebml/EbmlHead.h>
@@ -56,9 +57,11 @@
 #include "common/codec.h"
 #include "common/command_line.h"
 #include "common/ebml.h"
+#include "common/ebml_crc32.h"
 #include "common/endian.h"
 #include "common/fourcc.h"
 #include "common/hevc.h"
+#include "common/kax_cluster_walker.h"
 #include "common/kax_file.h"
 #include "common/mm_io.h"
 #include "common/mm_io_x.h"
@@ -127,6 +130,8 @@ std::map<unsigned int, kax_track_cptr> s_tracks_by_number;
 std::map<unsigned int, track_info_t> s_track_info;
 options_c g_options;
 static uint64_t s_tc_scale = TIMECODE_SCALE;
+static uint64_t s_segment_data_start_pos = 0;
+static std::set<uint64_t> s_seek_head_positions;
 std::vector<boost::format> g_common_boost_formats;
 size_t s_mkvmerge_track_id = 0;
 
@@ -169,6 +174,8 @@ size_t s_mkvmerge_track_id = 0;
 #define BF_AT                                BF_DO(31)
 #define BF_SIZE                              BF_DO(32)
 #define BF_BLOCK_GROUP_DISCARD_PADDING       BF_DO(33)
+#define BF_FAST_SUMMARY_WITH_DURATION        BF_DO(34)
+#define BF_FAST_SUMMARY_NO_DURATION          BF_DO(35)
 
 void
 init_common_boost_formats() {
@@ -207,6 +214,8 @@ init_common_boost_formats() {
   BF_ADD(Y(" at %1%"));                                                                                         // 31 -- BF_AT
   BF_ADD(Y(" size %1%"));                                                                                       // 32 -- BF_SIZE
   BF_ADD(Y("Discard padding: %|1$.3f|ms (%2%ns)"));                                                             // 33 -- BF_BLOCK_GROUP_DISCARD_PADDING
+  BF_ADD(Y("%1% frame, track %2%, timecode %3% (%4%), duration %|5$.3f|, size %6%%7%\n"));                       // 34 -- BF_FAST_SUMMARY_WITH_DURATION
+  BF_ADD(Y("%1% frame, track %2%, timecode %3% (%4%), size %5%%6%\n"));                                         // 35 -- BF_FAST_SUMMARY_NO_DURATION
 }
 
 std::string
@@ -949,18 +958,37 @@ void
 handle_seek_head(EbmlStream *&es,
                  int &upper_lvl_el,
                  EbmlElement *&l1) {
-  if ((g_options.m_verbose < 2) && !g_options.m_use_gui) {
+  auto show_entries = (g_options.m_verbose >= 2) || g_options.m_use_gui;
+
+  if (!show_entries && !g_options.m_headers_only) {
     show_element(l1, 1, Y("Seek head (subentries will be skipped)"));
     return;
   }
 
-  show_element(l1, 1, Y("Seek head"));
+  show_element(l1, 1, show_entries ? Y("Seek head") : Y("Seek head (subentries will be skipped)"));
 
   upper_lvl_el               = 0;
   EbmlElement *element_found = nullptr;
   auto m1                    = static_cast<EbmlMaster *>(l1);
   read_master(m1, es, EBML_CONTEXT(l1), upper_lvl_el, element_found);
 
+  // Remember where the indexed level 1 elements are located so that
+  // --headers-only can jump to them instead of reading the clusters.
+  if (g_options.m_headers_only)
+    for (auto l2 : *m1) {
+      auto seek = dynamic_cast<KaxSeek *>(l2);
+      if (!seek)
+        continue;
+
+      auto seek_id  = FindChild<KaxSeekID>(seek);
+      auto position = FindChild<KaxSeekPosition>(seek);
+      if (seek_id && position && !Is<KaxCluster>(EbmlId(seek_id->GetBuffer(), seek_id->GetSize())))
+        s_seek_head_positions.insert(s_segment_data_start_pos + position->GetValue());
+    }
+
+  if (!show_entries)
+    return;
+
   for (auto l2 : *m1)
     if (Is<KaxSeek>(l2)) {
       show_element(l2, 2, Y("Seek entry"));
@@ -1447,6 +1475,82 @@ handle_cluster(EbmlStream *&es,
       show_unknown_element(l2, 2);
 }
 
+void
+handle_block_header_summary(kax_block_header_t const &block) {
+  auto frame_type  = block.is_simple_block ? (block.keyframe ? 'I' : block.discardable ? 'B' : 'P')
+                   :                         (block.num_references >= 2 ? 'B' : block.num_references == 1 ? 'P' : 'I');
+  auto timecode_ms = std::llround(static_cast<double>(block.timecode) / 1000000.0);
+  auto frame_pos   = block.data_position;
+
+  for (auto frame_size : block.frame_sizes) {
+    std::string position;
+    if (1 <= g_options.m_verbose)
+      position = (BF_BLOCK_GROUP_SUMMARY_POSITION % frame_pos).str();
+    frame_pos += frame_size;
+
+    if (block.duration)
+      mxinfo(BF_FAST_SUMMARY_WITH_DURATION
+             % frame_type
+             % block.track_number
+             % timecode_ms
+             % format_timestamp(block.timecode, 3)
+             % (static_cast<double>(*block.duration) / 1000000.0)
+             % frame_size
+             % position);
+    else
+      mxinfo(BF_FAST_SUMMARY_NO_DURATION
+             % frame_type
+             % block.track_number
+             % timecode_ms
+             % format_timestamp(block.timecode, 3)
+             % frame_size
+             % position);
+  }
+
+  auto num_frames     = static_cast<int64_t>(block.frame_sizes.size());
+  auto ref_idx        = block.is_simple_block ? (block.keyframe ? 0 : block.discardable ? 2 : 1) : std::min(block.num_references, 2u);
+  track_info_t &tinfo = s_track_info[block.track_number];
+
+  tinfo.m_blocks                     += num_frames;
+  tinfo.m_blocks_by_ref_num[ref_idx] += num_frames;
+  tinfo.m_min_timecode                = std::min(tinfo.m_min_timecode, block.timecode);
+  tinfo.m_size                       += boost::accumulate(block.frame_sizes, uint64_t{});
+
+  if (!tinfo.max_timecode_unset() && (tinfo.m_max_timecode >= block.timecode))
+    return;
+
+  tinfo.m_max_timecode               = block.timecode;
+  tinfo.m_add_duration_for_n_packets = num_frames;
+
+  if (block.duration) {
+    tinfo.m_max_timecode               += *block.duration;
+    tinfo.m_add_duration_for_n_packets  = 0;
+  }
+}
+
+// Used for --fast-summary: walks over all remaining clusters of the
+// segment reading only the block headers and seeking over the frames'
+// contents. The time needed therefore depends on the number of blocks
+// and not on the file's size.
+void
+handle_clusters_fast(mm_io_c &in,
+                     uint64_t first_cluster_pos,
+                     uint64_t segment_end) {
+  auto file_size = std::max<uint64_t>(in.get_size(), 1);
+  auto walker    = kax_cluster_walker_c{in, static_cast<int64_t>(s_tc_scale)};
+
+  walker
+    .set_cluster_handler([file_size](uint64_t position, int64_t) -> bool {
+      if (g_options.m_use_gui)
+        ui_show_progress(100 * position / file_size, Y("Parsing file"));
+      return true;
+    })
+    .set_block_handler(handle_block_header_summary);
+
+  if (!walker.walk(first_cluster_pos, segment_end))
+    show_error(Y("The file contains invalid data after the last cluster that could be parsed."));
+}
+
 void
 handle_elements_rec(EbmlStream *es,
                     int level,
@@ -1560,6 +1664,87 @@ handle_ebml_head(EbmlElement *l0,
   }
 }
 
+void
+handle_level1_element(EbmlStream *&es,
+                      int &upper_lvl_el,
+                      EbmlElement *&l1) {
+  if (Is<KaxInfo>(l1))
+    handle_info(es, upper_lvl_el, l1);
+
+  else if (Is<KaxTracks>(l1))
+    handle_tracks(es, upper_lvl_el, l1);
+
+  else if (Is<KaxSeekHead>(l1))
+    handle_seek_head(es, upper_lvl_el, l1);
+
+  else if (Is<KaxCues>(l1))
+    handle_cues(es, upper_lvl_el, l1);
+
+  // Weee! Attachments!
+  else if (Is<KaxAttachments>(l1))
+    handle_attachments(es, upper_lvl_el, l1);
+
+  else if (Is<KaxChapters>(l1))
+    handle_chapters(es, upper_lvl_el, l1);
+
+  // Let's handle some TAGS.
+  else if (Is<KaxTags>(l1))
+    handle_tags(es, upper_lvl_el, l1);
+
+  else if (!is_global(es, l1, 1))
+    show_unknown_element(l1, 1);
+}
+
+// Used for --headers-only once the first cluster has been reached:
+// all level 1 elements behind it are only read if a seek head refers
+// to them. Seek heads found this way may add further positions.
+void
+handle_level1_elements_via_seek_heads(EbmlStream *es,
+                                      kax_file_c &kax_file,
+                                      mm_io_c &in,
+                                      uint64_t first_cluster_pos) {
+  std::set<uint64_t> handled;
+  auto upper_lvl_el = 0;
+
+  while (true) {
+    auto itr = brng::find_if(s_seek_head_positions, [&handled, first_cluster_pos](uint64_t position) {
+      return (position > first_cluster_pos) && !handled.count(position);
+    });
+
+    if (s_seek_head_positions.end() == itr)
+      break;
+
+    auto position = *itr;
+    handled.insert(position);
+
+    if (!in.setFilePointer2(position))
+      continue;
+
+    auto l1 = kax_file.read_next_level1_element();
+    if (!l1)
+      continue;
+
+    std::shared_ptr<EbmlElement> af_l1(l1);
+
+    if ((l1->GetElementPosition() == position) && !Is<KaxCluster>(l1))
+      handle_level1_element(es, upper_lvl_el, l1);
+  }
+}
+
+// Level 1 elements starting with an EbmlCrc32 element are checked
+// directly on the file's bytes, not on the parsed elements. Clusters
+// only reach this with -v or -s and are read a second time for it.
+void
+verify_level1_crc32(mm_io_c &in,
+                    EbmlElement *l1) {
+  auto check = verify_ebml_crc32(in, l1->GetElementPosition());
+  if (!check.present || check.valid)
+    return;
+
+  show_warning(2, boost::format(Y("CRC-32 mismatch, the bytes %1%-%2% are damaged (stored: 0x%|3$08x|, calculated: 0x%|4$08x|)"))
+               % check.start % (check.end - 1) % check.stored % check.calculated);
+}
+
 void
 handle_segment(EbmlElement *l0,
                mm_io_cptr &in,
@@ -1568,9 +1753,13 @@ handle_segment(EbmlElement *l0,
   auto l1                = static_cast<EbmlElement *>(nullptr);
   auto upper_lvl_el      = 0;
   kax_file_cptr kax_file = kax_file_cptr(new kax_file_c(in));
+  auto walker            = kax_cluster_walker_c{*in, TIMECODE_SCALE};
 
   kax_file->set_segment_end(*l0);
 
+  s_segment_data_start_pos = l0->GetElementPosition() + l0->HeadSize();
+  s_seek_head_positions.clear();
+
   if (!l0->IsFiniteSize())
     show_element(l0, 0, Y("Segment, size unknown"));
   else
@@ -1579,40 +1768,41 @@ handle_segment(EbmlElement *l0,
   // Prevent reporting "first timecode after resync":
   kax_file->set_timecode_scale(-1);
 
-  while ((l1 = kax_file->read_next_level1_element())) {
-    std::shared_ptr<EbmlElement> af_l1(l1);
+  while (true) {
+    // Don't even read the first cluster's header with libebml in
+    // header-only mode as that would read the whole cluster.
+    if (g_options.m_headers_only) {
+      kax_cluster_walker_c::element_header_t header;
+      auto position = in->getFilePointer();
 
-    if (Is<KaxInfo>(l1))
-      handle_info(es, upper_lvl_el, l1);
+      if (walker.read_element_header(position, header) && (EBML_ID_VALUE(EBML_ID(KaxCluster)) == header.id)) {
+        handle_level1_elements_via_seek_heads(es, *kax_file, *in, position);
+        return;
+      }
+    }
 
-    else if (Is<KaxTracks>(l1))
-      handle_tracks(es, upper_lvl_el, l1);
+    l1 = kax_file->read_next_level1_element();
+    if (!l1)
+      break;
 
-    else if (Is<KaxSeekHead>(l1))
-      handle_seek_head(es, upper_lvl_el, l1);
+    std::shared_ptr<EbmlElement> af_l1(l1);
 
-    else if (Is<KaxCluster>(l1)) {
+    if (Is<KaxCluster>(l1)) {
       show_element(l1, 1, Y("Cluster"));
       if ((g_options.m_verbose == 0) && !g_options.m_show_summary)
         return;
-      handle_cluster(es, upper_lvl_el, l1, file_size);
-
-    } else if (Is<KaxCues>(l1))
-      handle_cues(es, upper_lvl_el, l1);
 
-    // Weee! Attachments!
-    else if (Is<KaxAttachments>(l1))
-      handle_attachments(es, upper_lvl_el, l1);
+      if (g_options.m_fast_summary) {
+        handle_clusters_fast(*in, l1->GetElementPosition(), kax_file->get_segment_end());
+        return;
+      }
 
-    else if (Is<KaxChapters>(l1))
-      handle_chapters(es, upper_lvl_el, l1);
+      handle_cluster(es, upper_lvl_el, l1, file_size);
 
-    // Let's handle some TAGS.
-    else if (Is<KaxTags>(l1))
-      handle_tags(es, upper_lvl_el, l1);
+    } else
+      handle_level1_element(es, upper_lvl_el, l1);
 
-    else if (!is_global(es, l1, 1))
-      show_unknown_element(l1, 1);
+    verify_level1_crc32(*in, l1);
 
     if (!in->setFilePointer2(l1->GetElementPosition() + kax_file->get_element_size(l1)))
       break;
@@ -1695,7 +1885,7 @@ process_file(const std::string &file_name) {
 
       l0->SkipData(*es, EBML_CONTEXT(l0));
 
-      if ((g_options.m_verbose == 0) && !g_options.m_show_summary)
+      if ((g_options.m_verbose == 0) && !g_options.m_show_summary && !g_options.m_headers_only)
         break;
     }
 
@@ -17,6 +17,8 @@ options_c::options_c()
   : m_use_gui(false)
   , m_calc_checksums(false)
   , m_show_summary(false)
+  , m_fast_summary(false)
+  , m_headers_only(false)
   , m_show_hexdump(false)
   , m_show_size(false)
   , m_show_track_info(false)
@@ -38,6 +38,27 @@ struct PACKED_STRUCTURE mvhd_atom_t {
   uint32_t next_track_id;
 };
 
+// 'Movie header' atom, 64bit version
+struct PACKED_STRUCTURE mvhd64_atom_t {
+  uint8_t  version;              // == 1
+  uint8_t  flags[3];
+  uint64_t creation_time;
+  uint64_t modification_time;
+  uint32_t time_scale;
+  uint64_t duration;
+  uint32_t preferred_rate;
+  uint16_t preferred_volume;
+  uint8_t  reserved[10];
+  uint8_t  matrix_structure[36];
+  uint32_t preview_time;
+  uint32_t preview_duration;
+  uint32_t poster_time;
+  uint32_t selection_time;
+  uint32_t selection_duration;
+  uint32_t current_time;
+  uint32_t next_track_id;
+};
+
 // 'Track header' atom
 struct PACKED_STRUCTURE tkhd_atom_t {
   uint8_t  version;
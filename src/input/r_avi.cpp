@@ -774,9 +774,10 @@ avi_reader_c::read_audio(avi_demuxer_t &demuxer) {
     if (0 >= size)
       continue;
 
-    PTZR(demuxer.m_ptzr)->process(new packet_t(chunk));
+    PTZR(demuxer.m_ptzr)->process(new packet_t(chunk, demuxer.m_timecode_after_skip));
 
-    m_bytes_processed += size;
+    demuxer.m_timecode_after_skip  = -1;
+    m_bytes_processed             += size;
 
     return AVI_get_audio_position_index(m_avi) < AVI_max_audio_chunk(m_avi) ? FILE_STATUS_MOREDATA : flush_packetizer(demuxer.m_ptzr);
   }
@@ -807,6 +808,115 @@ avi_reader_c::read(generic_packetizer_c *ptzr,
   return flush_packetizers();
 }
 
+/** \brief The timestamp of an audio chunk as given by the stream header
+
+   For streams with a fixed sample size it is derived from the number
+   of bytes in front of the chunk. Otherwise each chunk contains one
+   block lasting dwScale/dwRate seconds.
+*/
+timestamp_c
+avi_reader_c::get_audio_chunk_timecode(avi_demuxer_t const &demuxer,
+                                       long chunk) {
+  auto stream_header  = &m_avi->stream_headers[demuxer.m_aid];
+  auto dw_scale       = static_cast<int64_t>(get_uint32_le(&stream_header->dw_scale));
+  auto dw_rate        = static_cast<int64_t>(get_uint32_le(&stream_header->dw_rate));
+  auto dw_sample_size = static_cast<int64_t>(get_uint32_le(&stream_header->dw_sample_size));
+
+  if (!dw_scale || !dw_rate)
+    return {};
+
+  auto blocks = dw_sample_size ? m_avi->track[demuxer.m_aid].audio_index[chunk].tot / dw_sample_size : static_cast<int64_t>(chunk);
+
+  return timestamp_c::ns(std::llround(static_cast<double>(blocks) * dw_scale * 1000000000.0 / dw_rate));
+}
+
+/** \brief Start reading at the last video key frame before a timestamp
+
+   The key frame is looked up in the video index (idx1 or OpenDML
+   index). Each audio track starts at the last chunk beginning at or
+   before that key frame; its first packet carries the chunk's
+   timestamp so that the audio packetizers continue from there. If no
+   video track is demuxed the audio tracks are positioned at the
+   timestamp itself. Vorbis tracks cannot take over timestamps that
+   way and prevent skipping.
+*/
+bool
+avi_reader_c::skip_to_timestamp(int64_t timestamp) {
+  static auto s_debug = debugging_option_c{"avi_reader_skip_to_timestamp"};
+
+  if (m_appending || !m_avi->video_index)
+    return false;
+
+  auto frame         = 0u;
+  auto start         = timestamp;
+  auto bytes_skipped = int64_t{};
+
+  if ((-1 != m_vptzr) && (0 < m_fps)) {
+    frame = std::min<unsigned int>(static_cast<unsigned int>(timestamp * m_fps / 1000000000ll), m_max_video_frames ? m_max_video_frames - 1 : 0);
+    while ((0 < frame) && (!m_avi->video_index[frame].len || (0x10 != m_avi->video_index[frame].key)))
+      --frame;
+
+    start = static_cast<int64_t>(static_cast<int64_t>(frame) * 1000000000ll / m_fps);
+  }
+
+  auto audio_chunks = std::vector<long>{};
+
+  for (auto const &demuxer : m_audio_demuxers) {
+    if (-1 == demuxer.m_ptzr)
+      continue;
+
+    if (demuxer.m_codec.is(codec_c::type_e::A_VORBIS))
+      return false;
+
+    AVI_set_audio_track(m_avi, demuxer.m_aid);
+
+    auto num_chunks = AVI_audio_chunks(m_avi);
+    auto chunk      = 0l;
+
+    if (!num_chunks)
+      return false;
+
+    while (((chunk + 1) < num_chunks) && (get_audio_chunk_timecode(demuxer, chunk + 1) <= timestamp_c::ns(start)))
+      ++chunk;
+
+    if (!get_audio_chunk_timecode(demuxer, chunk).valid())
+      return false;
+
+    audio_chunks.push_back(chunk);
+  }
+
+  if (!frame && std::all_of(audio_chunks.begin(), audio_chunks.end(), [](long chunk) { return 0 == chunk; }))
+    return false;
+
+  m_video_frames_read = frame;
+  AVI_set_video_position(m_avi, frame);
+
+  for (auto idx = 0u; idx < frame; ++idx)
+    bytes_skipped += m_avi->video_index[idx].len;
+
+  auto chunk_idx = 0u;
+  for (auto &demuxer : m_audio_demuxers) {
+    if (-1 == demuxer.m_ptzr)
+      continue;
+
+    auto chunk = audio_chunks[chunk_idx++];
+
+    AVI_set_audio_track(m_avi, demuxer.m_aid);
+    AVI_set_audio_position_index(m_avi, chunk);
+
+    demuxer.m_timecode_after_skip  = get_audio_chunk_timecode(demuxer, chunk).to_ns();
+    bytes_skipped                 += m_avi->track[demuxer.m_aid].audio_index[chunk].tot;
+
+    mxdebug_if(s_debug, boost::format("skip_to_timestamp: audio track %1% chunk %2% timestamp %3%\n") % (demuxer.m_aid + 1) % chunk % format_timestamp(demuxer.m_timecode_after_skip));
+  }
+
+  m_bytes_processed += bytes_skipped;
+
+  mxdebug_if(s_debug, boost::format("skip_to_timestamp: timestamp %1% video frame %2% start %3%\n") % format_timestamp(timestamp) % frame % format_timestamp(start));
+
+  return true;
+}
+
 int
 avi_reader_c::get_progress() {
   return 0 == m_bytes_to_process ? 0 : 100 * m_bytes_processed / m_bytes_to_process;
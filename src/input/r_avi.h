@@ -30,7 +30,7 @@ class info_c;
 struct avi_demuxer_t {
   int m_ptzr;
   int m_channels, m_bits_per_sample, m_samples_per_second, m_aid;
-  int64_t m_bytes_processed;
+  int64_t m_bytes_processed, m_timecode_after_skip;
   codec_c m_codec;
 
   avi_demuxer_t()
@@ -40,6 +40,7 @@ struct avi_demuxer_t {
     , m_samples_per_second(0)
     , m_aid(0)
     , m_bytes_processed(0)
+    , m_timecode_after_skip(-1)
   {
   }
 };
@@ -91,6 +92,7 @@ public:
 
   virtual void read_headers();
   virtual file_status_e read(generic_packetizer_c *ptzr, bool force = false);
+  virtual bool skip_to_timestamp(int64_t timestamp);
   virtual int get_progress();
   virtual void identify();
   virtual void create_packetizers();
@@ -104,6 +106,7 @@ protected:
   virtual file_status_e read_video();
   virtual file_status_e read_audio(avi_demuxer_t &demuxer);
   virtual file_status_e read_subtitles(avi_subs_demuxer_t &demuxer);
+  virtual timestamp_c get_audio_chunk_timecode(avi_demuxer_t const &demuxer, long chunk);
 
   virtual generic_packetizer_c *create_aac_packetizer(int aid, avi_demuxer_t &demuxer);
   virtual generic_packetizer_c *create_dts_packetizer(int aid);
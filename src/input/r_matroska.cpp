@@ -31,6 +31,8 @@
 #include <matroska/KaxCluster.h>
 #include <matroska/KaxClusterData.h>
 #include <matroska/KaxContexts.h>
+#include <matroska/KaxCues.h>
+#include <matroska/KaxCuesData.h>
 #include <matroska/KaxInfo.h>
 #include <matroska/KaxInfoData.h>
 #include <matroska/KaxSeekHead.h>
@@ -245,6 +247,7 @@ kax_reader_c::kax_reader_c(const track_info_c &ti,
   , m_segment_duration(0)
   , m_last_timecode(0)
   , m_first_timecode(-1)
+  , m_segment_data_start_pos(0)
   , m_writing_app_ver(-1)
   , m_attachment_id(0)
   , m_file_status(FILE_STATUS_MOREDATA)
@@ -819,6 +822,94 @@ kax_reader_c::handle_tags(mm_io_c *io,
   }
 }
 
+/** \brief Find the cluster to start reading at for a timestamp
+
+   The cues are only read when needed. Only cue points for video
+   tracks are used if a video track is demuxed as the output can only
+   start at a video key frame. Returns the absolute position of the
+   cluster belonging to the last such cue point at or before the
+   timestamp.
+*/
+boost::optional<int64_t>
+kax_reader_c::find_cluster_position_before(int64_t timestamp) {
+  auto have_video = brng::find_if(m_tracks, [](kax_track_cptr const &t) { return ('v' == t->type) && (-1 != t->ptzr); }) != m_tracks.end();
+  auto start_tc   = static_cast<uint64_t>(timestamp / m_tc_scale);
+  auto best_tc    = boost::optional<uint64_t>{};
+  auto best_pos   = boost::optional<uint64_t>{};
+
+  for (auto cues_pos : m_deferred_l1_positions[dl1t_cues]) {
+    m_in->save_pos(cues_pos);
+    at_scope_exit_c restore([this]() { m_in->restore_pos(); });
+
+    int upper_lvl_el = 0;
+    std::shared_ptr<EbmlElement> l1(m_es->FindNextElement(EBML_CLASS_CONTEXT(KaxSegment), upper_lvl_el, 0xFFFFFFFFL, true));
+    auto cues = dynamic_cast<KaxCues *>(l1.get());
+
+    if (!cues)
+      continue;
+
+    EbmlElement *l2 = nullptr;
+    upper_lvl_el    = 0;
+
+    cues->Read(*m_es, EBML_CLASS_CONTEXT(KaxCues), upper_lvl_el, l2, true);
+
+    for (auto const &elt : *cues) {
+      auto kcue_point = dynamic_cast<KaxCuePoint *>(elt);
+      if (!kcue_point)
+        continue;
+
+      auto ktime = FindChild<KaxCueTime>(*kcue_point);
+      if (!ktime || (ktime->GetValue() > start_tc) || (best_tc && (ktime->GetValue() < *best_tc)))
+        continue;
+
+      for (auto const &pos_elt : *kcue_point) {
+        auto ktrack_pos = dynamic_cast<KaxCueTrackPositions *>(pos_elt);
+        auto kcluster   = ktrack_pos ? FindChild<KaxCueClusterPosition>(*ktrack_pos) : nullptr;
+        auto track      = ktrack_pos ? find_track_by_num(FindChildValue<KaxCueTrack>(*ktrack_pos)) : nullptr;
+
+        if (!kcluster || !track || (-1 == track->ptzr) || (have_video && ('v' != track->type)))
+          continue;
+
+        if (!best_tc || (ktime->GetValue() > *best_tc) || (kcluster->GetValue() < *best_pos)) {
+          best_tc  = ktime->GetValue();
+          best_pos = kcluster->GetValue();
+        }
+      }
+    }
+  }
+
+  if (!best_pos)
+    return {};
+
+  return m_segment_data_start_pos + *best_pos;
+}
+
+bool
+kax_reader_c::skip_to_timestamp(int64_t timestamp) {
+  static auto s_debug = debugging_option_c{"kax_reader_skip_to_timestamp"};
+
+  if (m_appending)
+    return false;
+
+  auto cluster_pos = boost::optional<int64_t>{};
+
+  try {
+    cluster_pos = find_cluster_position_before(timestamp);
+  } catch (...) {
+  }
+
+  mxdebug_if(s_debug,
+             boost::format("skip_to_timestamp: timestamp %1% cluster position %2%\n")
+             % format_timestamp(timestamp) % (cluster_pos ? *cluster_pos : -1));
+
+  if (!cluster_pos)
+    return false;
+
+  m_in->setFilePointer(*cluster_pos);
+
+  return true;
+}
+
 void
 kax_reader_c::discard_track_statistics_tags() {
   for (auto const &track : m_tracks)
@@ -1142,6 +1233,7 @@ kax_reader_c::handle_seek_head(mm_io_c *io,
         :                       Is<KaxTracks>(id)      ? dl1t_tracks
         :                       Is<KaxSeekHead>(id)    ? dl1t_seek_head
         :                       Is<KaxInfo>(id)        ? dl1t_info
+        :                       Is<KaxCues>(id)        ? dl1t_cues
         :                                                dl1t_unknown;
 
       if (dl1t_unknown == type)
@@ -1189,6 +1281,7 @@ kax_reader_c::find_level1_elements_via_analyzer() {
     analyzer->with_elements(EBML_ID(KaxAttachments), [this](kax_analyzer_data_c const &data) { m_deferred_l1_positions[dl1t_attachments].push_back(data.m_pos); });
     analyzer->with_elements(EBML_ID(KaxChapters),    [this](kax_analyzer_data_c const &data) { m_deferred_l1_positions[dl1t_chapters   ].push_back(data.m_pos); });
     analyzer->with_elements(EBML_ID(KaxTags),        [this](kax_analyzer_data_c const &data) { m_deferred_l1_positions[dl1t_tags       ].push_back(data.m_pos); });
+    analyzer->with_elements(EBML_ID(KaxCues),        [this](kax_analyzer_data_c const &data) { m_deferred_l1_positions[dl1t_cues       ].push_back(data.m_pos); });
 
   } catch (...) {
   }
@@ -1255,6 +1348,7 @@ kax_reader_c::read_headers_internal() {
     }
 
     m_in_file->set_segment_end(*l0);
+    m_segment_data_start_pos = l0->GetElementPosition() + l0->HeadSize();
 
     // We've got our segment, so let's find the m_tracks
     int upper_lvl_el = 0;
@@ -1285,6 +1379,9 @@ kax_reader_c::read_headers_internal() {
       else if (Is<KaxTags>(l1))
         m_deferred_l1_positions[dl1t_tags].push_back(l1->GetElementPosition());
 
+      else if (Is<KaxCues>(l1))
+        m_deferred_l1_positions[dl1t_cues].push_back(l1->GetElementPosition());
+
       else if (Is<KaxSeekHead>(l1))
         handle_seek_head(m_in.get(), l0, l1->GetElementPosition());
 
@@ -176,6 +176,7 @@ private:
     dl1t_tracks,
     dl1t_seek_head,
     dl1t_info,
+    dl1t_cues,
   };
 
   std::vector<kax_track_cptr> m_tracks;
@@ -187,7 +188,7 @@ private:
 
   std::shared_ptr<EbmlStream> m_es;
 
-  int64_t m_segment_duration, m_last_timecode, m_first_timecode;
+  int64_t m_segment_duration, m_last_timecode, m_first_timecode, m_segment_data_start_pos;
   std::string m_title;
 
   using deferred_positions_t = std::map<deferred_l1_type_e, std::vector<int64_t> >;
@@ -216,6 +217,7 @@ public:
 
   virtual void read_headers();
   virtual file_status_e read(generic_packetizer_c *ptzr, bool force = false);
+  virtual bool skip_to_timestamp(int64_t timestamp);
 
   virtual int get_progress();
   virtual void set_headers();
@@ -255,6 +257,7 @@ protected:
   virtual void handle_chapters(mm_io_c *io, EbmlElement *l0, int64_t pos);
   virtual void handle_seek_head(mm_io_c *io, EbmlElement *l0, int64_t pos);
   virtual void handle_tags(mm_io_c *io, EbmlElement *l0, int64_t pos);
+  virtual boost::optional<int64_t> find_cluster_position_before(int64_t timestamp);
   virtual void process_global_tags();
   virtual void discard_track_statistics_tags();
 
@@ -654,6 +654,7 @@ mpeg_ts_reader_c::mpeg_ts_reader_c(const track_info_c &ti,
   , m_debug_aac{              "mpeg_ts|mpeg_aac"}
   , m_debug_timecode_wrapping{"mpeg_ts|mpeg_ts_timecode_wrapping"}
   , m_debug_clpi{             "clpi"}
+  , m_debug_skip{             "mpeg_ts|mpeg_ts_skip_to_timestamp"}
   , m_detected_packet_size{}
   , m_num_pat_crc_errors{}
   , m_num_pmt_crc_errors{}
@@ -1637,6 +1638,220 @@ mpeg_ts_reader_c::read(generic_packetizer_c *requested_ptzr,
   }
 }
 
+/** \brief Find the PTS of the first PES packet for a PID after a position
+
+   At most a couple of megabytes are searched. \c packet_position is
+   set to the position of the TS packet containing the PES header.
+*/
+timestamp_c
+mpeg_ts_reader_c::find_pes_timestamp_after(int64_t position,
+                                           uint16_t pid,
+                                           int64_t &packet_position) {
+  static auto const s_max_bytes_to_search = 4 * 1024 * 1024;
+
+  unsigned char buf[TS_MAX_PACKET_SIZE + 1];
+
+  if (!resync(position))
+    return {};
+
+  while (m_in->getFilePointer() < static_cast<uint64_t>(position + s_max_bytes_to_search)) {
+    auto current_position = m_in->getFilePointer();
+
+    if (m_in->read(buf, m_detected_packet_size) != static_cast<unsigned int>(m_detected_packet_size))
+      return {};
+
+    if (buf[0] != 0x47) {
+      if (resync(current_position))
+        continue;
+      return {};
+    }
+
+    auto pts = get_pes_timestamp(buf, pid, false);
+    if (!pts.valid())
+      continue;
+
+    packet_position = current_position;
+
+    return pts;
+  }
+
+  return {};
+}
+
+/** \brief Find the last random access point for a PID before a position
+
+   Searches backwards packet by packet starting at \c position which
+   must be the start of a TS packet. A random access point is the start
+   of a PES packet whose TS packet has the random access indicator set
+   and whose PTS is not bigger than \c max_timestamp. At most a couple
+   of megabytes are searched.
+
+   \return The position of the TS packet or -1 if none was found. In
+     that case the caller must not start reading in the middle of the
+     file as the video packetizers would have to start decoding with a
+     frame that isn't a key frame.
+*/
+int64_t
+mpeg_ts_reader_c::find_random_access_point_before(int64_t position,
+                                                  uint16_t pid,
+                                                  timestamp_c const &max_timestamp,
+                                                  timestamp_c &timestamp) {
+  static auto const s_max_bytes_to_search = 32 * 1024 * 1024;
+
+  unsigned char buf[TS_MAX_PACKET_SIZE + 1];
+
+  for (auto current_position = position; (current_position >= 0) && ((position - current_position) < s_max_bytes_to_search); current_position -= m_detected_packet_size) {
+    m_in->setFilePointer(current_position);
+
+    if ((m_in->read(buf, m_detected_packet_size) != static_cast<unsigned int>(m_detected_packet_size)) || (buf[0] != 0x47))
+      return -1;
+
+    auto pts = get_pes_timestamp(buf, pid, true);
+    if (pts.valid() && (pts <= max_timestamp)) {
+      timestamp = pts;
+      return current_position;
+    }
+  }
+
+  return -1;
+}
+
+/** \brief Return the PTS of a PES packet starting in a TS packet
+
+   Returns an invalid timestamp if the TS packet doesn't belong to \c
+   pid, doesn't start a PES packet with a PTS or, if \c
+   require_random_access_indicator is set, if its adaptation field
+   doesn't mark a random access point.
+*/
+timestamp_c
+mpeg_ts_reader_c::get_pes_timestamp(unsigned char *buf,
+                                    uint16_t pid,
+                                    bool require_random_access_indicator) {
+  auto hdr = reinterpret_cast<mpeg_ts_packet_header_t *>(buf);
+
+  if (   (hdr->get_pid() != pid)
+      || !hdr->get_payload_unit_start_indicator()
+      || hdr->get_transport_error_indicator()
+      || !(hdr->get_adaptation_field_control() & 0x01))
+    return {};
+
+  auto ts_payload       = buf + sizeof(mpeg_ts_packet_header_t);
+  auto random_access    = false;
+
+  if (hdr->get_adaptation_field_control() & 0x02) {
+    auto adaptation_field = reinterpret_cast<mpeg_ts_adaptation_field_t *>(ts_payload);
+    random_access         = (0 < adaptation_field->length) && adaptation_field->get_random_access_indicator();
+    ts_payload           += static_cast<unsigned int>(adaptation_field->length) + 1;
+  }
+
+  if (require_random_access_indicator && !random_access)
+    return {};
+
+  // The PTS occupies five bytes starting at pts_dts.
+  if ((ts_payload + sizeof(mpeg_ts_pes_header_t) + 4) > (buf + TS_PACKET_SIZE))
+    return {};
+
+  auto pes_data = reinterpret_cast<mpeg_ts_pes_header_t *>(ts_payload);
+  if (   (get_uint24_be(pes_data->packet_start_code) != 0x000001)
+      || ((pes_data->get_pts_dts_flags() & 0x02) != 0x02))
+    return {};
+
+  return read_timecode(&pes_data->pts_dts);
+}
+
+/** \brief Start reading at a random access point before a timestamp
+
+   Bisects the file by the PTS of the first demuxed video track (or
+   the first demuxed audio track if there's no video track). For video
+   reading starts at the last TS packet before the timestamp whose
+   random access indicator is set. If there's none nearby the file is
+   read from the start. Files whose timestamps wrap around and
+   playlists are always read from the start.
+*/
+bool
+mpeg_ts_reader_c::skip_to_timestamp(int64_t timestamp) {
+  static auto const s_min_bisection_window = 1024 * 1024;
+
+  if (   m_appending
+      || !m_global_timecode_offset.valid()
+      || dynamic_cast<mm_mpls_multi_file_io_c *>(get_underlying_input()))
+    return false;
+
+  auto is_demuxed = [](mpeg_ts_pid_type_e type) {
+    return [type](mpeg_ts_track_ptr const &track) { return (-1 != track->ptzr) && (type == track->type); };
+  };
+
+  auto reference = brng::find_if(tracks, is_demuxed(ES_VIDEO_TYPE));
+  if (reference == tracks.end())
+    reference = brng::find_if(tracks, is_demuxed(ES_AUDIO_TYPE));
+
+  auto target = m_global_timecode_offset + timestamp_c::ns(timestamp);
+
+  if ((reference == tracks.end()) || (target <= m_global_timecode_offset))
+    return false;
+
+  auto pid            = (*reference)->pid;
+  auto previous_pos   = m_in->getFilePointer();
+  auto lower          = int64_t{};
+  auto upper          = static_cast<int64_t>(m_size);
+  auto best_position  = int64_t{-1};
+  auto best_timestamp = timestamp_c{};
+
+  while ((upper - lower) > s_min_bisection_window) {
+    auto middle          = lower + (upper - lower) / 2;
+    auto packet_position = int64_t{};
+    auto pts             = find_pes_timestamp_after(middle, pid, packet_position);
+
+    mxdebug_if(m_debug_skip, boost::format("mpeg_ts_reader_c::skip_to_timestamp: window %1%-%2% PTS after %3% is %4% at %5%\n") % lower % upper % middle % pts % packet_position);
+
+    if (pts.valid() && (pts < m_global_timecode_offset)) {
+      // Timestamps wrap around; bisecting isn't possible.
+      best_position = -1;
+      break;
+    }
+
+    if (pts.valid() && (pts <= target)) {
+      lower          = middle;
+      best_position  = packet_position;
+      best_timestamp = pts;
+
+    } else
+      upper = middle;
+  }
+
+  // Every audio frame can be decoded on its own, but video has to
+  // start at a key frame.
+  if ((-1 != best_position) && (ES_VIDEO_TYPE == (*reference)->type)) {
+    m_in->clear_eof();
+    best_position = find_random_access_point_before(best_position, pid, target, best_timestamp);
+  }
+
+  m_in->clear_eof();
+
+  mxdebug_if(m_debug_skip, boost::format("mpeg_ts_reader_c::skip_to_timestamp: timestamp %1% target PTS %2% PID %3% result position %4% PTS %5%\n")
+             % format_timestamp(timestamp) % target % pid % best_position % best_timestamp);
+
+  if (-1 == best_position) {
+    m_in->setFilePointer(previous_pos);
+    return false;
+  }
+
+  m_in->setFilePointer(best_position);
+  m_stream_timecode = best_timestamp;
+
+  for (auto &track : tracks) {
+    track->pes_payload->remove(track->pes_payload->get_size());
+    track->processed                 = false;
+    track->data_ready                = false;
+    track->pes_payload_size          = 0;
+    track->m_timecode.reset();
+    track->m_previous_timecode.reset();
+    track->m_previous_valid_timecode = best_timestamp;
+  }
+
+  return true;
+}
+
 bfs::path
 mpeg_ts_reader_c::find_clip_info_file() {
   auto mpls_multi_in = dynamic_cast<mm_mpls_multi_file_io_c *>(get_underlying_input());
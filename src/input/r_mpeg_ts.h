@@ -115,6 +115,10 @@ struct PACKED_STRUCTURE mpeg_ts_adaptation_field_t {
   unsigned char get_discontinuity_indicator() {
     return (flags & 80) >> 7;
   }
+
+  unsigned char get_random_access_indicator() {
+    return (flags & 0x40) >> 6;
+  }
 };
 
 // PAT header
@@ -405,7 +409,7 @@ protected:
 
   std::vector<timestamp_c> m_chapter_timecodes;
 
-  debugging_option_c m_dont_use_audio_pts, m_debug_resync, m_debug_pat_pmt, m_debug_headers, m_debug_packet, m_debug_aac, m_debug_timecode_wrapping, m_debug_clpi;
+  debugging_option_c m_dont_use_audio_pts, m_debug_resync, m_debug_pat_pmt, m_debug_headers, m_debug_packet, m_debug_aac, m_debug_timecode_wrapping, m_debug_clpi, m_debug_skip;
 
   unsigned int m_detected_packet_size, m_num_pat_crc_errors, m_num_pmt_crc_errors;
   bool m_validate_pat_crc, m_validate_pmt_crc;
@@ -425,6 +429,7 @@ public:
 
   virtual void read_headers();
   virtual file_status_e read(generic_packetizer_c *requested_ptzr, bool force = false);
+  virtual bool skip_to_timestamp(int64_t timestamp);
   virtual void identify();
   virtual void create_packetizer(int64_t tid);
   virtual void create_packetizers();
@@ -460,6 +465,9 @@ private:
   void process_chapter_entries();
 
   bool resync(int64_t start_at);
+  timestamp_c find_pes_timestamp_after(int64_t position, uint16_t pid, int64_t &packet_position);
+  int64_t find_random_access_point_before(int64_t position, uint16_t pid, timestamp_c const &max_timestamp, timestamp_c &timestamp);
+  timestamp_c get_pes_timestamp(unsigned char *buf, uint16_t pid, bool require_random_access_indicator);
 
   uint32_t calculate_crc(void const *buffer, size_t size) const;
 
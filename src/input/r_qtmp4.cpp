@@ -778,14 +778,33 @@ qtmp4_reader_c::handle_trun_atom(qt_atom_t,
 void
 qtmp4_reader_c::handle_mvhd_atom(qt_atom_t atom,
                                  int level) {
-  mvhd_atom_t mvhd;
-
-  if (sizeof(mvhd_atom_t) > (atom.size - atom.hsize))
+  if (1 > (atom.size - atom.hsize))
     print_atom_too_small_error("mvhd", mvhd_atom_t);
-  if (m_in->read(&mvhd, sizeof(mvhd_atom_t)) != sizeof(mvhd_atom_t))
-    throw mtx::input::header_parsing_x();
 
-  m_time_scale = get_uint32_be(&mvhd.time_scale);
+  int version = m_in->read_uint8();
+
+  // Version 1 uses 64-bit values for the times and the duration. All
+  // other versions are read with the version 0 layout.
+  if (1 == version) {
+    mvhd64_atom_t mvhd;
+
+    if (sizeof(mvhd64_atom_t) > (atom.size - atom.hsize))
+      print_atom_too_small_error("mvhd", mvhd64_atom_t);
+    if (m_in->read(&mvhd.flags, sizeof(mvhd64_atom_t) - 1) != (sizeof(mvhd64_atom_t) - 1))
+      throw mtx::input::header_parsing_x();
+
+    m_time_scale = get_uint32_be(&mvhd.time_scale);
+
+  } else {
+    mvhd_atom_t mvhd;
+
+    if (sizeof(mvhd_atom_t) > (atom.size - atom.hsize))
+      print_atom_too_small_error("mvhd", mvhd_atom_t);
+    if (m_in->read(&mvhd.flags, sizeof(mvhd_atom_t) - 1) != (sizeof(mvhd_atom_t) - 1))
+      throw mtx::input::header_parsing_x();
+
+    m_time_scale = get_uint32_be(&mvhd.time_scale);
+  }
 
   mxdebug_if(m_debug_headers, boost::format("%1%Time scale: %2%\n") % space(level * 2 + 1) % m_time_scale);
 }
@@ -1413,6 +1432,37 @@ qtmp4_reader_c::read(generic_packetizer_c *ptzr,
   return flush_packetizers();
 }
 
+bool
+qtmp4_reader_c::skip_to_timestamp(int64_t timestamp) {
+  for (auto const &dmx : m_demuxers)
+    if (   (-1 != dmx->ptzr)
+        && dmx->is_video()
+        && dmx->codec.is(codec_c::type_e::V_MPEG4_P2)
+        && dmx->esds_parsed
+        && dmx->esds.decoder_config)
+      return false;
+
+  // Video tracks start at their last key frame before the timestamp,
+  // all other tracks at their last frame before it.
+  for (auto &dmx : m_demuxers) {
+    if (-1 == dmx->ptzr)
+      continue;
+
+    auto new_pos = 0u;
+    for (auto idx = 0u; idx < dmx->m_index.size(); ++idx) {
+      auto const &index = dmx->m_index[idx];
+      if ((index.timecode <= timestamp) && (!dmx->is_video() || index.is_keyframe))
+        new_pos = idx;
+    }
+
+    mxdebug_if(m_debug_headers, boost::format("skip_to_timestamp: track %1% timestamp %2% new index position %3%/%4%\n") % dmx->id % format_timestamp(timestamp) % new_pos % dmx->m_index.size());
+
+    dmx->pos = new_pos;
+  }
+
+  return true;
+}
+
 memory_cptr
 qtmp4_reader_c::create_bitmap_info_header(qtmp4_demuxer_cptr &dmx,
                                           const char *fourcc,
@@ -447,6 +447,7 @@ public:
 
   virtual void read_headers();
   virtual file_status_e read(generic_packetizer_c *ptzr, bool force = false);
+  virtual bool skip_to_timestamp(int64_t timestamp);
   virtual int get_progress();
   virtual void identify();
   virtual void create_packetizers();
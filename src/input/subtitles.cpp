@@ -18,6 +18,7 @@
 #include "common/mm_io.h"
 #include "common/strings/formatting.h"
 #include "common/strings/parsing.h"
+#include "common/subtitle_line_scanner.h"
 #include "input/subtitles.h"
 #include "merge/file_status.h"
 #include "merge/input_x.h"
@@ -39,11 +40,6 @@ subtitles_c::process(generic_packetizer_c *p) {
 
 // ------------------------------------------------------------
 
-#define SRT_RE_VALUE         "\\s*(-?)\\s*(\\d+)"
-#define SRT_RE_TIMECODE      SRT_RE_VALUE ":" SRT_RE_VALUE ":" SRT_RE_VALUE "[,\\.:]" SRT_RE_VALUE
-#define SRT_RE_TIMECODE_LINE "^" SRT_RE_TIMECODE "\\s*[\\-\\s]+>\\s*" SRT_RE_TIMECODE "\\s*"
-#define SRT_RE_COORDINATES   "([XY]\\d+:\\d+\\s*){4}\\s*$"
-
 bool
 srt_parser_c::probe(mm_text_io_c *io) {
   try {
@@ -59,9 +55,8 @@ srt_parser_c::probe(mm_text_io_c *io) {
       return false;
 
     s = io->getline();
-    boost::regex timecode_re(SRT_RE_TIMECODE_LINE, boost::regex::perl);
-    boost::smatch matches;
-    if (!boost::regex_search(s, timecode_re))
+    mtx::subtitles::srt_timestamp_t start, end;
+    if (!mtx::subtitles::parse_srt_timestamp_line(s, start, end))
       return false;
 
     s = io->getline();
@@ -86,10 +81,6 @@ srt_parser_c::srt_parser_c(mm_text_io_c *io,
 
 void
 srt_parser_c::parse() {
-  boost::regex timecode_re(SRT_RE_TIMECODE_LINE, boost::regex::perl);
-  boost::regex number_re("^\\d+$", boost::regex::perl);
-  boost::regex coordinates_re(SRT_RE_COORDINATES, boost::regex::perl);
-
   int64_t start                 = 0;
   int64_t end                   = 0;
   int64_t previous_start        = 0;
@@ -123,7 +114,7 @@ srt_parser_c::parse() {
     }
 
     if (STATE_INITIAL == state) {
-      if (!boost::regex_match(s, number_re)) {
+      if (!mtx::subtitles::is_srt_number(s)) {
         mxwarn_tid(m_file_name, m_tid, boost::format(Y("Error in line %1%: expected subtitle number and found some text.\n")) % line_number);
         break;
       }
@@ -131,38 +122,13 @@ srt_parser_c::parse() {
       parse_number(s, subtitle_number);
 
     } else if (STATE_TIME == state) {
-      boost::smatch matches;
-      if (!boost::regex_search(s, matches, timecode_re)) {
+      mtx::subtitles::srt_timestamp_t s_ts, e_ts;
+      if (!mtx::subtitles::parse_srt_timestamp_line(s, s_ts, e_ts)) {
         mxwarn_tid(m_file_name, m_tid, boost::format(Y("Error in line %1%: expected a SRT timecode line but found something else. Aborting this file.\n")) % line_number);
         break;
       }
 
-      int s_h = 0, s_min = 0, s_sec = 0, e_h = 0, e_min = 0, e_sec = 0;
-
-      //        1         2       3      4        5     6             7    8
-      // "\\s*(-?)\\s*(\\d+):\\s(-?)*(\\d+):\\s*(-?)(\\d+)[,\\.]\\s*(-?)(\\d+)?"
-
-      parse_number(matches[ 2].str(), s_h);
-      parse_number(matches[ 4].str(), s_min);
-      parse_number(matches[ 6].str(), s_sec);
-      parse_number(matches[10].str(), e_h);
-      parse_number(matches[12].str(), e_min);
-      parse_number(matches[14].str(), e_sec);
-
-      std::string s_rest = matches[ 8].str();
-      std::string e_rest = matches[16].str();
-
-      auto neg_calculator = [&](size_t const start_idx) -> int64_t {
-        int64_t neg = 1;
-        for (size_t idx = start_idx; idx <= (start_idx + 6); idx += 2)
-          neg *= matches[idx].str() == "-" ? -1 : 1;
-        return neg;
-      };
-
-      int64_t s_neg = neg_calculator(1);
-      int64_t e_neg = neg_calculator(9);
-
-      if (boost::regex_search(s, coordinates_re) && !m_coordinates_warning_shown) {
+      if (!m_coordinates_warning_shown && mtx::subtitles::has_srt_coordinates(s)) {
         mxwarn_tid(m_file_name, m_tid,
                    Y("This file contains coordinates in the timecode lines. "
                      "Such coordinates are not supported by the Matroska SRT subtitle format. "
@@ -177,23 +143,14 @@ srt_parser_c::parse() {
       }
 
       // Calculate the start and end time in ns precision for the following entry.
-      start  = (int64_t)s_h * 60 * 60 + s_min * 60 + s_sec;
-      end    = (int64_t)e_h * 60 * 60 + e_min * 60 + e_sec;
-
-      start *= 1000000000ll * s_neg;
-      end   *= 1000000000ll * e_neg;
+      start  = (int64_t)s_ts.hours * 60 * 60 + s_ts.minutes * 60 + s_ts.seconds;
+      end    = (int64_t)e_ts.hours * 60 * 60 + e_ts.minutes * 60 + e_ts.seconds;
 
-      while (s_rest.length() < 9)
-        s_rest += "0";
-      if (s_rest.length() > 9)
-        s_rest.erase(9);
-      start += atol(s_rest.c_str());
+      start *= 1000000000ll * (s_ts.negative ? -1 : 1);
+      end   *= 1000000000ll * (e_ts.negative ? -1 : 1);
 
-      while (e_rest.length() < 9)
-        e_rest += "0";
-      if (e_rest.length() > 9)
-        e_rest.erase(9);
-      end += atol(e_rest.c_str());
+      start += s_ts.nanoseconds;
+      end   += e_ts.nanoseconds;
 
       if (0 > start) {
         mxwarn_tid(m_file_name, m_tid,
@@ -224,7 +181,7 @@ srt_parser_c::parse() {
         subtitles += "\n";
       subtitles += s;
 
-    } else if (boost::regex_match(s, number_re)) {
+    } else if (mtx::subtitles::is_srt_number(s)) {
       state = STATE_TIME;
       parse_number(s, subtitle_number);
 
@@ -247,10 +204,6 @@ srt_parser_c::parse() {
 
 bool
 ssa_parser_c::probe(mm_text_io_c *io) {
-  boost::regex script_info_re("^\\s*\\[script\\s+info\\]",   boost::regex::perl | boost::regex::icase);
-  boost::regex styles_re(     "^\\s*\\[V4\\+?\\s+Styles\\]", boost::regex::perl | boost::regex::icase);
-  boost::regex comment_re(    "^\\s*$|^\\s*[!;]",            boost::regex::perl | boost::regex::icase);
-
   try {
     int line_number = 0;
     io->setFilePointer(0, seek_beginning);
@@ -264,11 +217,13 @@ ssa_parser_c::probe(mm_text_io_c *io) {
         return false;
 
       // Skip comments and empty lines.
-      if (boost::regex_search(line, comment_re))
+      if (mtx::subtitles::is_ssa_comment_or_empty(line))
         continue;
 
       // This is the line mkvmerge is looking for: positive match.
-      if (boost::regex_search(line, script_info_re) || boost::regex_search(line, styles_re))
+      if (   mtx::subtitles::is_ssa_section_header(line, "[script info]")
+          || mtx::subtitles::is_ssa_section_header(line, "[v4+ styles]")
+          || mtx::subtitles::is_ssa_section_header(line, "[v4 styles]"))
         return true;
 
       // Neither a wanted line nor an empty one/a comment: negative result.
@@ -296,13 +251,6 @@ ssa_parser_c::ssa_parser_c(generic_reader_c *reader,
 
 void
 ssa_parser_c::parse() {
-  boost::regex sec_styles_ass_re("^\\s*\\[V4\\+\\s+Styles\\]", boost::regex::perl | boost::regex::icase);
-  boost::regex sec_styles_re(    "^\\s*\\[V4\\s+Styles\\]",    boost::regex::perl | boost::regex::icase);
-  boost::regex sec_info_re(      "^\\s*\\[Script\\s+Info\\]",  boost::regex::perl | boost::regex::icase);
-  boost::regex sec_events_re(    "^\\s*\\[Events\\]",          boost::regex::perl | boost::regex::icase);
-  boost::regex sec_graphics_re(  "^\\s*\\[Graphics\\]",        boost::regex::perl | boost::regex::icase);
-  boost::regex sec_fonts_re(     "^\\s*\\[Fonts\\]",           boost::regex::perl | boost::regex::icase);
-
   int num                        = 0;
   ssa_section_e section          = SSA_SECTION_NONE;
   ssa_section_e previous_section = SSA_SECTION_NONE;
@@ -323,24 +271,24 @@ ssa_parser_c::parse() {
     if (!strcasecmp(line.c_str(), "ScriptType: v4.00+"))
       m_is_ass = true;
 
-    else if (boost::regex_search(line, sec_styles_ass_re)) {
+    else if (mtx::subtitles::is_ssa_section_header(line, "[v4+ styles]")) {
       m_is_ass = true;
       section  = SSA_SECTION_V4STYLES;
 
-    } else if (boost::regex_search(line, sec_styles_re))
+    } else if (mtx::subtitles::is_ssa_section_header(line, "[v4 styles]"))
       section = SSA_SECTION_V4STYLES;
 
-    else if (boost::regex_search(line, sec_info_re))
+    else if (mtx::subtitles::is_ssa_section_header(line, "[script info]"))
       section = SSA_SECTION_INFO;
 
-    else if (boost::regex_search(line, sec_events_re))
+    else if (mtx::subtitles::is_ssa_section_header(line, "[events]"))
       section = SSA_SECTION_EVENTS;
 
-    else if (boost::regex_search(line, sec_graphics_re)) {
+    else if (mtx::subtitles::is_ssa_section_header(line, "[graphics]")) {
       section       = SSA_SECTION_GRAPHICS;
       add_to_global = false;
 
-    } else if (boost::regex_search(line, sec_fonts_re)) {
+    } else if (mtx::subtitles::is_ssa_section_header(line, "[fonts]")) {
       section       = SSA_SECTION_FONTS;
       add_to_global = false;
 
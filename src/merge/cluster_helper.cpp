@@ -16,8 +16,10 @@
 
 #include "common/date_time.h"
 #include "common/ebml.h"
+#include "common/ebml_crc32.h"
 #include "common/hacks.h"
 #include "common/math.h"
+#include "common/profiling.h"
 #include "common/strings/formatting.h"
 #include "common/tags/tags.h"
 #include "merge/cluster_helper.h"
@@ -36,10 +38,11 @@
 cluster_helper_c::impl_t::impl_t()
   : cluster{}
   , cluster_content_size{}
+  , bytes_since_video_keyframe{}
   , max_timecode_and_duration{}
   , max_video_timecode_rendered{}
   , previous_cluster_tc{-1}
-  , num_cue_elements{}
+  , queued_packets_size{}
   , header_overhead{-1}
   , timecode_offset{}
   , bytes_in_file{}
@@ -146,6 +149,7 @@ cluster_helper_c::render_before_adding_if_necessary(packet_cptr &packet) {
              % packet->bref              % packet->fref                 % packet->assigned_timecode % format_timestamp(timecode_delay));
 
   bool is_video_keyframe = (packet->source == g_video_packetizer) && packet->is_key_frame();
+  bool start_new_cluster = g_target_cluster_size ? target_cluster_size_reached(packet, is_video_keyframe) : is_video_keyframe;
   bool do_render         = (std::numeric_limits<int16_t>::max() < timecode_delay)
                         || (std::numeric_limits<int16_t>::min() > timecode_delay)
                         || (   (std::max<int64_t>(0, m->min_timecode_in_cluster) > m->previous_cluster_tc)
@@ -153,10 +157,12 @@ cluster_helper_c::render_before_adding_if_necessary(packet_cptr &packet) {
                             && (!g_video_packetizer || !is_video_keyframe || m->first_video_keyframe_seen)
                             && (   (packet->gap_following && !m->packets.empty())
                                 || ((packet->assigned_timecode - timecode) > g_max_ns_per_cluster)
-                                || is_video_keyframe));
+                                || start_new_cluster));
 
-  if (is_video_keyframe)
-    m->first_video_keyframe_seen = true;
+  if (is_video_keyframe) {
+    m->first_video_keyframe_seen  = true;
+    m->bytes_since_video_keyframe = 0;
+  }
 
   mxdebug_if(m->debug_rendering,
              boost::format("render check cur_tc %9% min_tc_ic %1% prev_cl_tc %2% test %3% is_vid_and_key %4% tc_delay %5% gap_following_and_not_empty %6% cur_tc>min_tc_ic %8% first_video_key_seen %10% do_render %7%\n")
@@ -170,13 +176,34 @@ cluster_helper_c::render_before_adding_if_necessary(packet_cptr &packet) {
   prepare_new_cluster();
 }
 
+bool
+cluster_helper_c::target_cluster_size_reached(packet_cptr const &packet,
+                                              bool is_video_keyframe)
+  const {
+  // Without video all frames can start a new cluster.
+  if (!g_video_packetizer)
+    return (m->cluster_content_size + static_cast<int64_t>(packet->data->get_size())) > g_target_cluster_size;
+
+  if (!is_video_keyframe)
+    return false;
+
+  // The key frame ends the GOP whose bytes have been counted since the
+  // previous key frame. The next GOP is assumed to be about as big.
+  // End the cluster here if adding that GOP would move the cluster's
+  // size further away from the target than it is now.
+  return (m->cluster_content_size + m->bytes_since_video_keyframe / 2) >= g_target_cluster_size;
+}
+
 void
 cluster_helper_c::render_after_adding_if_necessary(packet_cptr &packet) {
   // Render the cluster if it is full (according to my many criteria).
-  auto timecode = get_timecode();
+  // With a target size the cluster is only cut between key frames if
+  // no key frame has been found before reaching twice the target.
+  auto timecode         = get_timecode();
+  auto max_content_size = g_target_cluster_size ? std::max<int64_t>(1500000, g_target_cluster_size * 2) : 1500000;
   if (   ((packet->assigned_timecode - timecode) > g_max_ns_per_cluster)
       || (m->packets.size()                      > static_cast<size_t>(g_max_blocks_per_cluster))
-      || (get_cluster_content_size()             > 1500000)) {
+      || (get_cluster_content_size()             > max_content_size)) {
     render();
     prepare_new_cluster();
   }
@@ -196,13 +223,13 @@ cluster_helper_c::split_if_necessary(packet_cptr &packet) {
 
   // Maybe we want to start a new file now.
   if (split_point_c::size == m->current_split_point->m_type) {
-    int64_t additional_size = 0;
-
-    if (!m->packets.empty())
-      // Cluster + Cluster timecode: roughly 21 bytes. Add all frame sizes & their overheaders, too.
-      additional_size = 21 + boost::accumulate(m->packets, 0, [](size_t size, const packet_cptr &p) { return size + p->data->get_size() + (p->is_key_frame() ? 10 : p->is_p_frame() ? 13 : 16); });
+    // Cluster + Cluster timecode: roughly 21 bytes. Add all queued
+    // frame sizes & their overheaders, too. The clusters already
+    // rendered are accounted for with their exact sizes in
+    // bytes_in_file.
+    int64_t additional_size = m->packets.empty() ? 0 : 21 + m->queued_packets_size;
 
-    additional_size += 18 * m->num_cue_elements;
+    additional_size += cues_c::get().get_current_element_size();
 
     mxdebug_if(m->debug_splitting,
                boost::format("cluster_helper split decision: header_overhead: %1%, additional_size: %2%, bytes_in_file: %3%, sum: %4%\n")
@@ -235,14 +262,18 @@ void
 cluster_helper_c::split(packet_cptr &packet) {
   render();
 
-  m->num_cue_elements = 0;
-
   bool create_new_file       = m->current_split_point->m_create_new_file;
   bool previously_discarding = m->discarding;
 
   mxdebug_if(m->debug_splitting, boost::format("Splitting: splitpoint %1% reached before timecode %2%, create new? %3%.\n") % m->current_split_point->str() % format_timestamp(packet->assigned_timecode) % create_new_file);
 
-  finish_file(false, create_new_file, previously_discarding);
+  // If only discarded parts follow in 'parts:' mode then no other file
+  // will be written, and the current one's links must be finalized
+  // like the last file's.
+  auto last_file = m->current_split_point->m_discard
+                && std::none_of(m->current_split_point, m->split_points.end(), [](split_point_c const &point) { return !point.m_discard; });
+
+  finish_file(last_file, create_new_file, previously_discarding);
 
   if (m->current_split_point->m_use_once) {
     if (   m->current_split_point->m_discard
@@ -287,7 +318,9 @@ cluster_helper_c::add_packet(packet_cptr packet) {
   split_if_necessary(packet);
 
   m->packets.push_back(packet);
-  m->cluster_content_size += packet->data->get_size();
+  m->cluster_content_size       += packet->data->get_size();
+  m->bytes_since_video_keyframe += packet->data->get_size();
+  m->queued_packets_size        += packet->data->get_size() + (packet->is_key_frame() ? 10 : packet->is_p_frame() ? 13 : 16);
 
   if (packet->assigned_timecode > m->max_timecode_in_cluster)
     m->max_timecode_in_cluster = packet->assigned_timecode;
@@ -312,6 +345,7 @@ cluster_helper_c::prepare_new_cluster() {
 
   m->cluster              = new kax_cluster_c;
   m->cluster_content_size = 0;
+  m->queued_packets_size  = 0;
   m->packets.clear();
 
   m->cluster->SetParent(*g_kax_segment);
@@ -392,6 +426,9 @@ cluster_helper_c::must_duration_be_set(render_groups_c *rg,
 
 int
 cluster_helper_c::render() {
+  static auto s_profiling_stage = g_profiler.get_stage("cluster rendering");
+  mtx::profiling::scoped_timer_c timer{s_profiling_stage};
+
   std::vector<render_groups_cptr> render_groups;
   KaxCues cues;
   cues.SetGlobalTimecodeScale(g_timecode_scale);
@@ -512,8 +549,6 @@ cluster_helper_c::render() {
     render_group->m_durations.push_back(pack->get_unmodified_duration());
     render_group->m_duration_mandatory |= pack->duration_mandatory;
 
-    cues_c::get().set_duration_for_id_timecode(source->get_track_num(), pack->assigned_timecode - timecode_offset, pack->get_duration());
-
     if (new_block_group) {
       // Set the reference priority if it was wanted.
       if ((0 < pack->ref_priority) && new_block_group->replace_simple_by_group())
@@ -542,8 +577,10 @@ cluster_helper_c::render() {
 
     else if (g_write_cues && (!added_to_cues || has_codec_state)) {
       added_to_cues = add_to_cues_maybe(pack);
-      if (added_to_cues)
+      if (added_to_cues) {
         cues.AddBlockBlob(*new_block_group);
+        cues_c::get().set_duration_for_id_timecode(source->get_track_num(), pack->assigned_timecode - timecode_offset, pack->get_duration());
+      }
     }
 
     pack->group = new_block_group;
@@ -562,7 +599,14 @@ cluster_helper_c::render() {
       m->cluster->set_min_timecode(min_cl_timecode - timecode_offset);
       m->cluster->set_max_timecode(max_cl_timecode - timecode_offset);
 
-      m->cluster->Render(*m->out, cues);
+      if (g_streaming_output)
+        start_streaming_output();
+
+      if (g_write_crc32)
+        render_with_ebml_crc32(*m->cluster, *m->out, [this, &cues](mm_io_c &out) { m->cluster->Render(out, cues); });
+      else
+        m->cluster->Render(*m->out, cues);
+
       m->bytes_in_file += m->cluster->ElementSize();
 
       if (g_kax_sh_cues)
@@ -611,7 +655,6 @@ cluster_helper_c::add_to_cues_maybe(packet_cptr &pack) {
 
   source.set_last_cue_timecode(pack->assigned_timecode);
 
-  ++m->num_cue_elements;
   g_cue_writing_requested = 1;
 
   return true;
@@ -671,6 +714,25 @@ cluster_helper_c::add_split_point(const split_point_c &split_point) {
     ++m->current_split_point;
 }
 
+/** \brief The timestamp everything before is discarded in 'parts:' mode
+
+   Only valid if splitting by timestamp parts is active, the first
+   part doesn't start at 0 and no packet has been processed yet.
+*/
+timestamp_c
+cluster_helper_c::get_start_of_first_part()
+  const {
+  if (   !splitting()
+      || (m->split_points.size() < 2)
+      || (split_point_c::parts != m->split_points.front().m_type)
+      || !m->split_points.front().m_discard
+      || (0 != m->split_points.front().m_point)
+      || (m->current_split_point != (m->split_points.begin() + 1)))
+    return timestamp_c{};
+
+  return timestamp_c::ns(m->current_split_point->m_point);
+}
+
 bool
 cluster_helper_c::split_mode_produces_many_files()
   const {
@@ -695,6 +757,7 @@ cluster_helper_c::split_mode_produces_many_files()
 void
 cluster_helper_c::discard_queued_packets() {
   m->packets.clear();
+  m->queued_packets_size = 0;
 }
 
 void
@@ -705,6 +768,12 @@ cluster_helper_c::dump_split_points()
              % boost::accumulate(m->split_points, std::string(""), [](std::string const &accu, split_point_c const &point) { return accu + " " + point.str(); }));
 }
 
+std::vector<split_point_c> const &
+cluster_helper_c::get_split_points()
+  const {
+  return m->split_points;
+}
+
 void
 cluster_helper_c::create_tags_for_track_statistics(KaxTags &tags,
                                                    std::string const &writing_app,
@@ -23,6 +23,7 @@
 #include <matroska/KaxCluster.h>
 
 #include "common/split_point.h"
+#include "common/timestamp.h"
 #include "merge/libmatroska_extensions.h"
 
 #define RND_TIMECODE_SCALE(a) (std::llround(static_cast<double>(a) / static_cast<double>(g_timecode_scale)) * static_cast<int64_t>(g_timecode_scale))
@@ -57,6 +58,8 @@ public:
 
   void add_split_point(split_point_c const &split_point);
   void dump_split_points() const;
+  std::vector<split_point_c> const &get_split_points() const;
+  timestamp_c get_start_of_first_part() const;
   bool splitting() const;
   bool split_mode_produces_many_files() const;
 
@@ -74,6 +77,7 @@ private:
   bool must_duration_be_set(render_groups_c *rg, packet_cptr &new_packet);
 
   void render_before_adding_if_necessary(packet_cptr &packet);
+  bool target_cluster_size_reached(packet_cptr const &packet, bool is_video_keyframe) const;
   void render_after_adding_if_necessary(packet_cptr &packet);
   void split_if_necessary(packet_cptr &packet);
   void split(packet_cptr &packet);
@@ -18,6 +18,7 @@
 #include "common/fs_sys_helpers.h"
 #include "common/hacks.h"
 #include "common/math.h"
+#include "common/profiling.h"
 #include "merge/cluster_helper.h"
 #include "merge/cues.h"
 #include "merge/generic_packetizer.h"
@@ -28,6 +29,8 @@ cues_cptr cues_c::s_cues;
 
 cues_c::cues_c()
   : m_num_cue_points_postprocessed{}
+  , m_num_cue_points_in_size{}
+  , m_points_size{}
   , m_no_cue_duration{hack_engaged(ENGAGE_NO_CUE_DURATION)}
   , m_no_cue_relative_position{hack_engaged(ENGAGE_NO_CUE_RELATIVE_POSITION)}
   , m_debug_cue_duration{         "cues|cues_cue_duration"}
@@ -40,7 +43,7 @@ cues_c::set_duration_for_id_timecode(uint64_t id,
                                      uint64_t timecode,
                                      uint64_t duration) {
   if (!m_no_cue_duration)
-    m_id_timecode_duration_multimap.insert({ id_timecode_t{id, timecode}, duration });
+    m_id_timecode_durations.emplace_back(id_timecode_t{id, timecode}, duration);
 }
 
 void
@@ -125,11 +128,48 @@ cues_c::write(mm_io_c &out,
   m_points.clear();
   m_codec_state_position_map.clear();
   m_num_cue_points_postprocessed = 0;
+  m_num_cue_points_in_size       = 0;
+  m_points_size                  = 0;
 
   // auto end_all = mtx::sys::get_current_time_millis();
   // mxinfo(boost::format("dur sort %1% write %2% total %3%\n") % (end_sort - start) % (end_all - end_sort) % (end_all - start));
 }
 
+bool
+cues_c::write_into_placeholder(mm_io_c &out,
+                                KaxSeekHead &seek_head,
+                                EbmlVoid &placeholder) {
+  if (!m_points.size() || !g_cue_writing_requested)
+    return true;
+
+  // A remainder of a single byte cannot be filled with an EbmlVoid.
+  auto available = placeholder.ElementSize(true);
+  auto needed    = calculate_element_size();
+
+  if ((needed > available) || ((needed + 1) == available))
+    return false;
+
+  out.save_pos(placeholder.GetElementPosition());
+
+  write(out, seek_head);
+
+  if (needed < available) {
+    auto remainder_size = available - needed;
+    auto size_length    = 1;
+    while (CodedSizeLength(remainder_size - 1 - size_length, 0) > size_length)
+      ++size_length;
+
+    EbmlVoid remainder;
+    remainder.SetSize(remainder_size - 1 - size_length);
+    remainder.SetSizeLength(size_length);
+    remainder.Render(out);
+  }
+
+  out.restore_pos();
+
+  return true;
+}
+
 void
 cues_c::sort() {
   brng::sort(m_points, [](cue_point_t const &a, cue_point_t const &b) -> bool {
@@ -177,10 +217,22 @@ cues_c::calculate_block_positions(KaxCluster &cluster)
 void
 cues_c::postprocess_cues(KaxCues &cues,
                          KaxCluster &cluster) {
+  static auto s_profiling_stage = g_profiler.get_stage("cue post-processing");
+  mtx::profiling::scoped_timer_c timer{s_profiling_stage};
+
   add(cues);
 
-  if (m_no_cue_duration && m_no_cue_relative_position)
+  if (m_no_cue_duration && m_no_cue_relative_position) {
+    m_id_timecode_durations.clear();
+    update_points_size();
     return;
+  }
+
+  // Only the blocks that became cue points have their durations
+  // recorded, and only for the current cluster. Keep the order of
+  // identical track number/timecode pairs intact.
+  auto compare_ids = [](id_timecode_duration_t const &a, id_timecode_duration_t const &b) { return a.first < b.first; };
+  std::stable_sort(m_id_timecode_durations.begin(), m_id_timecode_durations.end(), compare_ids);
 
   auto cluster_data_start_pos = cluster.GetElementPosition() + cluster.HeadSize();
   auto block_positions        = calculate_block_positions(cluster);
@@ -214,7 +266,7 @@ cues_c::postprocess_cues(KaxCues &cues,
     if (m_no_cue_duration)
       continue;
 
-    auto pair          = m_id_timecode_duration_multimap.equal_range({ point->track_num, point->timecode });
+    auto pair          = std::equal_range(m_id_timecode_durations.begin(), m_id_timecode_durations.end(), id_timecode_duration_t{ { point->track_num, point->timecode }, 0 }, compare_ids);
     auto duration_itr  = pair.first;
     auto dur_end       = pair.second;
     auto num_processed = nblocks_processed[id_timecode_t{ point->track_num, point->timecode }];
@@ -227,17 +279,39 @@ cues_c::postprocess_cues(KaxCues &cues,
     if (!ptzr || !ptzr->wants_cue_duration())
       continue;
 
-    if (m_id_timecode_duration_multimap.end() != duration_itr)
+    if (dur_end != duration_itr)
       point->duration = duration_itr->second;
 
     mxdebug_if(m_debug_cue_duration,
                boost::format("cue_duration: looking for <%1%:%2%>: %3%\n")
-               % point->track_num % point->timecode % (duration_itr == m_id_timecode_duration_multimap.end() ? static_cast<int64_t>(-1) : duration_itr->second));
+               % point->track_num % point->timecode % (duration_itr == dur_end ? static_cast<int64_t>(-1) : duration_itr->second));
   }
 
   m_num_cue_points_postprocessed = m_points.size();
 
-  m_id_timecode_duration_multimap.clear();
+  m_id_timecode_durations.clear();
+
+  update_points_size();
+}
+
+// Only the points that have been added since the last call are
+// looked at so that the size of the cues is known at all times
+// without iterating over all of them.
+void
+cues_c::update_points_size() {
+  for (auto idx = m_num_cue_points_in_size, end = m_points.size(); idx < end; ++idx)
+    m_points_size += calculate_point_size(m_points[idx]);
+
+  m_num_cue_points_in_size = m_points.size();
+}
+
+uint64_t
+cues_c::get_current_element_size()
+  const {
+  if (m_points.empty())
+    return 0;
+
+  return EBML_ID_LENGTH(EBML_ID(KaxCues)) + CodedSizeLength(m_points_size, 0) + m_points_size;
 }
 
 uint64_t
@@ -246,6 +320,24 @@ cues_c::calculate_total_size()
   return boost::accumulate(m_points, 0ull, [this](uint64_t sum, cue_point_t const &point) { return sum + calculate_point_size(point); });
 }
 
+uint64_t
+cues_c::calculate_element_size()
+  const {
+  auto total_size = calculate_total_size();
+  return EBML_ID_LENGTH(EBML_ID(KaxCues)) + CodedSizeLength(total_size, 0) + total_size;
+}
+
+uint64_t
+cues_c::estimate_element_size(uint64_t num_cue_points)
+  const {
+  // Assume fairly large values for all fields: a timecode and a
+  // cluster position from the end of a long and big file.
+  auto point      = cue_point_t{ 24ull * 3600 * 1000000000, 1000000000ull, 1ull << 39, 1, 1u << 23 };
+  auto total_size = num_cue_points * calculate_point_size(point);
+
+  return EBML_ID_LENGTH(EBML_ID(KaxCues)) + CodedSizeLength(total_size, 0) + total_size;
+}
+
 uint64_t
 cues_c::calculate_bytes_for_uint(uint64_t value)
   const {
@@ -296,6 +388,11 @@ cues_c::adjust_positions(uint64_t old_position,
   for (auto &element : m_codec_state_position_map)
     if (element.second >= old_position)
       element.second += delta;
+
+  // Moving the positions may change the sizes of the points.
+  m_num_cue_points_in_size = 0;
+  m_points_size            = 0;
+  update_points_size();
 }
 
 cues_c &
@@ -16,13 +16,15 @@
 
 #include "common/common_pch.h"
 
+#include <ebml/EbmlVoid.h>
 #include <matroska/KaxCues.h>
 #include <matroska/KaxCuesData.h>
 #include <matroska/KaxSeekHead.h>
 
 #include "common/mm_io.h"
 
-using id_timecode_t = std::pair<uint64_t, uint64_t>;
+using id_timecode_t          = std::pair<uint64_t, uint64_t>;
+using id_timecode_duration_t = std::pair<id_timecode_t, uint64_t>;
 
 struct cue_point_t {
   uint64_t timecode, duration, cluster_position;
@@ -35,10 +37,11 @@ using cues_cptr = std::shared_ptr<cues_c>;
 class cues_c {
 protected:
   std::vector<cue_point_t> m_points;
-  std::multimap<id_timecode_t, uint64_t> m_id_timecode_duration_multimap;
+  std::vector<id_timecode_duration_t> m_id_timecode_durations;
   std::map<id_timecode_t, uint64_t> m_codec_state_position_map;
 
-  size_t m_num_cue_points_postprocessed;
+  size_t m_num_cue_points_postprocessed, m_num_cue_points_in_size;
+  uint64_t m_points_size;
   bool m_no_cue_duration, m_no_cue_relative_position;
   debugging_option_c m_debug_cue_duration, m_debug_cue_relative_position;
 
@@ -51,6 +54,10 @@ public:
   void add(KaxCues &cues);
   void add(KaxCuePoint &point);
   void write(mm_io_c &out, KaxSeekHead &seek_head);
+  bool write_into_placeholder(mm_io_c &out, KaxSeekHead &seek_head, EbmlVoid &placeholder);
+  uint64_t calculate_element_size() const;
+  uint64_t estimate_element_size(uint64_t num_cue_points) const;
+  uint64_t get_current_element_size() const;
   void postprocess_cues(KaxCues &cues, KaxCluster &cluster);
   void set_duration_for_id_timecode(uint64_t id, uint64_t timecode, uint64_t duration);
   void adjust_positions(uint64_t old_position, uint64_t delta);
@@ -62,6 +69,7 @@ protected:
   void sort();
   std::multimap<id_timecode_t, uint64_t> calculate_block_positions(KaxCluster &cluster) const;
   uint64_t calculate_total_size() const;
+  void update_points_size();
   uint64_t calculate_point_size(cue_point_t const &point) const;
   uint64_t calculate_bytes_for_uint(uint64_t value) const;
 };
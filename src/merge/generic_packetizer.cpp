@@ -28,6 +28,7 @@
 #include "common/container.h"
 #include "common/ebml.h"
 #include "common/hacks.h"
+#include "common/profiling.h"
 #include "common/strings/formatting.h"
 #include "common/unique_numbers.h"
 #include "common/xml/ebml_tags_converter.h"
@@ -89,6 +90,7 @@ generic_packetizer_c::generic_packetizer_c(generic_reader_c *reader,
   , m_has_been_flushed{}
   , m_prevent_lacing{}
   , m_connected_successor{}
+  , m_profiling_stage{}
   , m_ti{ti}
   , m_reader{reader}
   , m_connected_to{}
@@ -952,6 +954,9 @@ generic_packetizer_c::apply_factory() {
   if (m_packet_queue.empty())
     return;
 
+  static auto s_profiling_stage = g_profiler.get_stage("timestamp factory");
+  mtx::profiling::scoped_timer_c timer{s_profiling_stage};
+
   // Find the first packet to which the factory hasn't been applied yet.
   packet_cptr_di p_start = m_packet_queue.begin() + m_next_packet_wo_assigned_timecode;
 
@@ -1199,9 +1204,31 @@ generic_packetizer_c::create_track_number() {
 
 file_status_e
 generic_packetizer_c::read() {
+  mtx::profiling::scoped_timer_c timer{m_reader->get_profiling_stage()};
+
   return m_reader->read(this);
 }
 
+int
+generic_packetizer_c::process(packet_cptr packet) {
+  if (!g_profiler.is_enabled())
+    return process_impl(packet);
+
+  if (!m_profiling_stage)
+    m_profiling_stage = g_profiler.get_stage((boost::format("packetizing: %1%") % get_format_name().get_untranslated()).str());
+
+  // The packets and bytes passed to the packetizers are what the
+  // readers have produced.
+  auto num_bytes = packet->data ? packet->data->get_size() : 0;
+  m_profiling_stage->add_data(num_bytes);
+  if (m_reader && m_reader->get_profiling_stage())
+    m_reader->get_profiling_stage()->add_data(num_bytes);
+
+  mtx::profiling::scoped_timer_c timer{m_profiling_stage};
+
+  return process_impl(packet);
+}
+
 void
 generic_packetizer_c::prevent_lacing() {
   m_prevent_lacing = true;
@@ -35,6 +35,10 @@ using namespace libmatroska;
 
 class generic_reader_c;
 
+namespace mtx { namespace profiling {
+class stage_c;
+}}
+
 enum connection_result_e {
   CAN_CONNECT_YES,
   CAN_CONNECT_NO_FORMAT,
@@ -86,6 +90,8 @@ protected:
   bool m_prevent_lacing;
   generic_packetizer_c *m_connected_successor;
 
+  mtx::profiling::stage_c *m_profiling_stage;
+
 protected:                      // static
   static int ms_track_number;
 
@@ -137,7 +143,7 @@ public:
   inline int process(packet_t *packet) {
     return process(packet_cptr(packet));
   }
-  virtual int process(packet_cptr packet) = 0;
+  int process(packet_cptr packet);
 
   virtual void set_cue_creation(cue_strategy_e create_cue_data) {
     m_ti.m_cues = create_cue_data;
@@ -259,6 +265,8 @@ public:
   virtual void after_file_created();
 
 protected:
+  virtual int process_impl(packet_cptr packet) = 0;
+
   virtual void flush_impl() {
   };
 
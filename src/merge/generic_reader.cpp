@@ -14,6 +14,7 @@
 #include "common/common_pch.h"
 
 #include "common/list_utils.h"
+#include "common/profiling.h"
 #include "common/strings/formatting.h"
 #include "merge/generic_packetizer.h"
 #include "merge/generic_reader.h"
@@ -41,6 +42,7 @@ generic_reader_c::generic_reader_c(const track_info_c &ti,
   , m_num_audio_tracks{}
   , m_num_subtitle_tracks{}
   , m_reference_timecode_tolerance{}
+  , m_profiling_stage{}
 {
   add_all_requested_track_ids(*this, m_ti.m_atracks.m_items);
   add_all_requested_track_ids(*this, m_ti.m_vtracks.m_items);
@@ -231,6 +233,14 @@ generic_reader_c::get_queued_bytes()
   return bytes;
 }
 
+mtx::profiling::stage_c *
+generic_reader_c::get_profiling_stage() {
+  if (!m_profiling_stage && g_profiler.is_enabled())
+    m_profiling_stage = g_profiler.get_stage((boost::format("reading: %1% (%2%)") % get_format_name().get_untranslated() % bfs::path{m_ti.m_fname}.filename().string()).str());
+
+  return m_profiling_stage;
+}
+
 file_status_e
 generic_reader_c::flush_packetizer(int num) {
   return flush_packetizer(PTZR(num));
@@ -32,6 +32,10 @@ using namespace libmatroska;
 
 class generic_packetizer_c;
 
+namespace mtx { namespace profiling {
+class stage_c;
+}}
+
 #define DEFTRACK_TYPE_AUDIO 0
 #define DEFTRACK_TYPE_VIDEO 1
 #define DEFTRACK_TYPE_SUBS  2
@@ -68,6 +72,8 @@ protected:
 
   timestamp_c m_restricted_timecodes_min, m_restricted_timecodes_max;
 
+  mtx::profiling::stage_c *m_profiling_stage;
+
 public:
   generic_reader_c(const track_info_c &ti, const mm_io_cptr &in);
   virtual ~generic_reader_c();
@@ -84,6 +90,12 @@ public:
 
   virtual void read_headers() = 0;
   virtual file_status_e read(generic_packetizer_c *ptzr, bool force = false) = 0;
+  // Readers with an index can start reading at the last key frame
+  // before the timestamp instead of at the beginning. Returns whether
+  // or not the reader has done so.
+  virtual bool skip_to_timestamp(int64_t /* timestamp */) {
+    return false;
+  }
   virtual void read_all();
   virtual int get_progress();
   virtual void set_headers();
@@ -112,6 +124,8 @@ public:
     return m_in->get_size();
   }
   virtual int64_t get_queued_bytes() const;
+  // Returns nullptr unless profiling is enabled.
+  mtx::profiling::stage_c *get_profiling_stage();
   virtual bool is_simple_subtitle_container() {
     return false;
   }
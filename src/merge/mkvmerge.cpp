@@ -31,6 +31,7 @@
 #include <iostream>
 #include <list>
 #include <sstream>
+#include <thread>
 #include <tuple>
 #include <typeinfo>
 
@@ -50,6 +51,9 @@
 #include "common/kax_analyzer.h"
 #include "common/list_utils.h"
 #include "common/mm_io.h"
+#include "common/mm_io_statistics.h"
+#include "common/output_digest.h"
+#include "common/profiling.h"
 #include "common/segmentinfo.h"
 #include "common/split_arg_parsing.h"
 #include "common/strings/formatting.h"
@@ -64,11 +68,14 @@
 #include "merge/generic_reader.h"
 #include "merge/id_result.h"
 #include "merge/output_control.h"
+#include "merge/parallel_split.h"
 #include "merge/reader_detection_and_creation.h"
 #include "merge/track_info.h"
 
 using namespace libmatroska;
 
+static std::string s_profile_format;
+
 /** \brief Outputs usage information
 */
 #define S(x) std::string{x}
@@ -81,7 +88,9 @@ set_usage() {
   usage_text += Y(" Global options:\n");
   usage_text += S("  -v, --verbose            ") + Y("Increase verbosity.") + nl;
   usage_text += S("  -q, --quiet              ") + Y("Suppress status output.") + nl;
-  usage_text += Y("  -o, --output out         Write to the file 'out'.\n");
+  usage_text += Y("  -o, --output out         Write to the file 'out'. '-' writes to the\n"
+                  "                           standard output and implies\n"
+                  "                           '--streaming-output'.\n");
   usage_text += Y("  -w, --webm               Create WebM compliant file.\n");
   usage_text += Y("  --title <title>          Title for this output file.\n");
   usage_text += Y("  --global-tags <file>     Read global tags from a XML file.\n");
@@ -110,8 +119,28 @@ set_usage() {
                   "                           If the number is postfixed with 'ms' then\n"
                   "                           put at most n milliseconds of data into each\n"
                   "                           cluster.\n");
+  usage_text += Y("  --cluster-size <n[k|m]>  Start new clusters at video key frames so that\n"
+                  "                           each cluster's size is close to n bytes.\n");
   usage_text += Y("  --no-cues                Do not write the cue data (the index).\n");
+  usage_text += Y("  --cues-at-front <n>      Reserve space for about n cue entries in front\n"
+                  "                           of the first cluster and write the cues there\n"
+                  "                           if they fit.\n");
+  usage_text += Y("  --header-padding <n[k|m]|n%>\n"
+                  "                           Reserve n bytes or n percent of the element's\n"
+                  "                           size as padding after the track headers, the\n"
+                  "                           chapters and the tags so that they can be\n"
+                  "                           edited in place later on.\n");
   usage_text += Y("  --clusters-in-meta-seek  Write meta seek data for clusters.\n");
+  usage_text += Y("  --write-crc32            Write CRC-32 elements into all clusters, the\n"
+                  "                           segment information and the track headers.\n");
+  usage_text += Y("  --output-digest <md5|crc32|adler32>\n"
+                  "                           Calculate the digest of each output file while\n"
+                  "                           writing it and store it in a file next to it.\n");
+  usage_text += Y("  --profile <table|json>   Measure the time spent reading, packetizing,\n"
+                  "                           rendering and writing and output it at the end.\n");
+  usage_text += Y("  --streaming-output       Never seek in the output file so that it can be\n"
+                  "                           a pipe or a FIFO. The segment size, duration\n"
+                  "                           and cues are not written.\n");
   usage_text += Y("  --disable-lacing         Do not use lacing.\n");
   usage_text += Y("  --enable-durations       Enable block durations for all blocks.\n");
   usage_text += Y("  --timecode-scale <n>     Force the timecode scale factor to n.\n");
@@ -139,6 +168,9 @@ set_usage() {
                   "                           Create a new file before each chapter (with 'all')\n"
                   "                           or before chapter numbers A, B etc.\n");
   usage_text += Y("  --split-max-files <n>    Create at most n files.\n");
+  usage_text += Y("  --split-jobs <n>         Create the files in up to n processes running in\n"
+                  "                           parallel (0: one per CPU core). Only for splitting\n"
+                  "                           by timecodes, parts or chapters.\n");
   usage_text += Y("  --link                   Link splitted files.\n");
   usage_text += Y("  --link-to-previous <SID> Link the first file to the given SID.\n");
   usage_text += Y("  --link-to-next <SID>     Link the last file to the given SID.\n");
@@ -1536,6 +1568,55 @@ parse_arg_segment_uid(const std::string &param,
   }
 }
 
+static void
+parse_arg_cluster_size(std::string arg) {
+  auto modifier = int64_t{1};
+  auto unit     = arg.empty() ? '\0' : tolower(arg[arg.length() - 1]);
+
+  if ('k' == unit)
+    modifier = 1024;
+  else if ('m' == unit)
+    modifier = 1024 * 1024;
+
+  if (1 != modifier)
+    arg.erase(arg.length() - 1);
+
+  int64_t size = 0;
+  if (!parse_number(arg, size) || (4096 > (size * modifier)) || ((64 * 1024 * 1024) < (size * modifier)))
+    mxerror(boost::format(Y("Cluster size '%1%' out of range (4k..64m).\n")) % arg);
+
+  g_target_cluster_size = size * modifier;
+
+  // The size and the key frames decide where clusters end, not the
+  // default limits for the number of blocks and the duration. Only
+  // the 16-bit relative timecodes in blocks still limit a cluster's
+  // duration.
+  g_max_ns_per_cluster     = 32000000000ull;
+  g_max_blocks_per_cluster = 65535;
+}
+
+static void
+parse_arg_header_padding(std::string arg) {
+  auto modifier = int64_t{1};
+  auto unit     = arg.empty() ? '\0' : tolower(arg[arg.length() - 1]);
+
+  g_header_padding_is_percentage = '%' == unit;
+
+  if ('k' == unit)
+    modifier = 1024;
+  else if ('m' == unit)
+    modifier = 1024 * 1024;
+
+  if ((1 != modifier) || g_header_padding_is_percentage)
+    arg.erase(arg.length() - 1);
+
+  int64_t padding = 0;
+  if (!parse_number(arg, padding) || (0 > padding) || (g_header_padding_is_percentage && (1000 < padding)) || ((64 * 1024 * 1024) < (padding * modifier)))
+    mxerror(boost::format(Y("Invalid header padding '%1%' (0..64m or 0%%..1000%%).\n")) % arg);
+
+  g_header_padding = padding * modifier;
+}
+
 static void
 parse_arg_cluster_length(std::string arg) {
   int idx = arg.find("ms");
@@ -1922,6 +2003,10 @@ parse_args(std::vector<std::string> args) {
       print_capabilities();
       mxexit();
 
+    } else if (mtx::included_in(this_arg, "-o", "--output") && (next_arg == "-") && !stdio_redirected()) {
+      // The standard output carries the file's content. All messages
+      // must go to the standard error output instead.
+      redirect_stdio(mm_io_cptr{ new mm_stdio_c{true} });
     }
 
   }
@@ -1945,6 +2030,9 @@ parse_args(std::vector<std::string> args) {
       g_outfile = next_arg;
       sit++;
 
+      if (g_outfile == "-")
+        g_streaming_output = true;
+
     } else if ((this_arg == "-w") || (this_arg == "--webm"))
       set_output_compatibility(OC_WEBM);
   }
@@ -2021,6 +2109,18 @@ parse_args(std::vector<std::string> args) {
 
       sit++;
 
+    } else if (this_arg == "--split-jobs") {
+      if ((no_next_arg) || (next_arg[0] == 0))
+        mxerror(Y("'--split-jobs' lacks the number of processes.\n"));
+
+      if (!parse_number(next_arg, g_split_jobs))
+        mxerror(Y("Wrong argument to '--split-jobs'.\n"));
+
+      if (!g_split_jobs)
+        g_split_jobs = std::max(std::thread::hardware_concurrency(), 1u);
+
+      sit++;
+
     } else if (this_arg == "--link") {
       g_no_linking = false;
 
@@ -2052,12 +2152,67 @@ parse_args(std::vector<std::string> args) {
       parse_arg_cluster_length(next_arg);
       sit++;
 
+    } else if (this_arg == "--cluster-size") {
+      if (no_next_arg)
+        mxerror(Y("'--cluster-size' lacks the size.\n"));
+
+      parse_arg_cluster_size(next_arg);
+      sit++;
+
     } else if (this_arg == "--no-cues")
       g_write_cues = false;
 
+    else if (this_arg == "--cues-at-front") {
+      if (no_next_arg)
+        mxerror(Y("'--cues-at-front' lacks the number of cue entries.\n"));
+
+      if (!parse_number(next_arg, g_num_cue_points_to_reserve) || (0 >= g_num_cue_points_to_reserve))
+        mxerror(boost::format(Y("Invalid number of cue entries in '--cues-at-front %1%'.\n")) % next_arg);
+
+      sit++;
+    }
+
+    else if (this_arg == "--header-padding") {
+      if (no_next_arg)
+        mxerror(Y("'--header-padding' lacks the size.\n"));
+
+      parse_arg_header_padding(next_arg);
+      sit++;
+    }
+
     else if (this_arg == "--clusters-in-meta-seek")
       g_write_meta_seek_for_clusters = true;
 
+    else if (this_arg == "--write-crc32")
+      g_write_crc32 = true;
+
+    else if (this_arg == "--output-digest") {
+      if (no_next_arg)
+        mxerror(Y("'--output-digest' lacks the algorithm.\n"));
+
+      auto algorithm = mtx::checksum::algorithm_e::md5;
+      if (!output_digest_c::parse_algorithm(next_arg, algorithm))
+        mxerror(boost::format(Y("Invalid digest algorithm in '--output-digest %1%'.\n")) % next_arg);
+
+      g_output_digest = algorithm;
+      sit++;
+    }
+
+    else if (this_arg == "--profile") {
+      if (no_next_arg)
+        mxerror(Y("'--profile' lacks the output format.\n"));
+
+      if ((next_arg != "table") && (next_arg != "json"))
+        mxerror(boost::format(Y("Invalid output format in '--profile %1%'.\n")) % next_arg);
+
+      s_profile_format = next_arg;
+      g_profiler.enable();
+      sit++;
+    }
+
+    else if (this_arg == "--streaming-output")
+      g_streaming_output = true;
+
     else if (this_arg == "--disable-lacing")
       g_no_lacing = true;
 
@@ -2436,6 +2591,19 @@ parse_args(std::vector<std::string> args) {
   if (!g_cluster_helper->splitting() && !g_no_linking)
     mxwarn(Y("'--link' is only useful in combination with '--split'.\n"));
 
+  if ((1 < g_split_jobs) && !g_cluster_helper->splitting() && g_splitting_by_chapters_arg.empty())
+    mxerror(Y("'--split-jobs' can only be used together with '--split'.\n"));
+
+  if (g_streaming_output) {
+    if (g_cluster_helper->splitting())
+      mxerror(Y("Splitting cannot be used together with streaming output ('--streaming-output' or '-o -').\n"));
+
+    // Both would have to be written at the end and referenced from the
+    // headers in front of the first cluster.
+    g_write_cues                   = false;
+    g_write_meta_seek_for_clusters = false;
+  }
+
   if (!inputs_found && g_files.empty())
     mxerror(Y("No input files were given. No output will be created.\n"));
 }
@@ -2599,6 +2767,20 @@ setup(int argc,
   return args;
 }
 
+static void
+display_profile() {
+  if (s_profile_format.empty())
+    return;
+
+  if (s_profile_format == "json") {
+    auto json  = g_profiler.to_json();
+    json["io"] = mtx::mm_io::statistics_c::all_to_json();
+    mxinfo(json.dump(2) + "\n");
+
+  } else
+    mxinfo(g_profiler.format_table() + mtx::mm_io::statistics_c::format_all());
+}
+
 /** \brief Setup and high level program control
 
    Calls the functions for setup, handling the command line arguments,
@@ -2615,16 +2797,26 @@ main(int argc,
   int64_t start = mtx::sys::get_current_time_millis();
 
   add_filelists_for_playlists();
-  create_readers();
+
+  {
+    mtx::profiling::scoped_timer_c timer{g_profiler.get_stage("probing")};
+    create_readers();
+  }
 
   if (!g_identifying) {
-    create_packetizers();
+    {
+      mtx::profiling::scoped_timer_c timer{g_profiler.get_stage("creating packetizers")};
+      create_packetizers();
+    }
+
     if (g_packetizers.empty() && !g_files.empty())
       mxerror(Y("No streams to output were found. Aborting.\n"));
 
     check_track_id_validity();
     create_append_mappings_for_playlists();
     check_append_mapping();
+    skip_to_first_part();
+    suspend_appended_files();
     calc_attachment_sizes();
     calc_max_chapter_size();
   }
@@ -2635,6 +2827,16 @@ main(int argc,
 
   g_cluster_helper->dump_split_points();
 
+  if (1 < g_split_jobs) {
+    run_parallel_split(args);
+
+    mxinfo(boost::format(Y("Muxing took %1%.\n")) % create_minutes_seconds_time_string((mtx::sys::get_current_time_millis() - start + 500) / 1000, true));
+    display_profile();
+
+    cleanup();
+    mxexit();
+  }
+
   try {
     create_next_output_file();
     main_loop();
@@ -2647,6 +2849,7 @@ main(int argc,
   }
 
   mxinfo(boost::format(Y("Muxing took %1%.\n")) % create_minutes_seconds_time_string((mtx::sys::get_current_time_millis() - start + 500) / 1000, true));
+  display_profile();
 
   cleanup();
 
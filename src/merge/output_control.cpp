@@ -52,9 +52,13 @@
 #include "common/date_time.h"
 #include "common/debugging.h"
 #include "common/ebml.h"
+#include "common/ebml_crc32.h"
 #include "common/fs_sys_helpers.h"
 #include "common/hacks.h"
+#include "common/mm_stream_output_io.h"
 #include "common/mm_write_buffer_io.h"
+#include "common/output_digest.h"
+#include "common/profiling.h"
 #include "common/strings/formatting.h"
 #include "common/tags/tags.h"
 #include "common/translation.h"
@@ -98,14 +102,21 @@ std::string g_outfile;
 int64_t g_file_sizes                        = 0;
 int g_max_blocks_per_cluster                = 65535;
 int64_t g_max_ns_per_cluster                = 5000000000ll;
+int64_t g_target_cluster_size               = 0;
 bool g_write_cues                           = true;
 bool g_cue_writing_requested                = false;
+int64_t g_num_cue_points_to_reserve         = 0;
+int64_t g_header_padding                    = 0;
+bool g_header_padding_is_percentage         = false;
+bool g_streaming_output                     = false;
 generic_packetizer_c *g_video_packetizer    = nullptr;
 bool g_write_meta_seek_for_clusters         = false;
 bool g_no_lacing                            = false;
 bool g_no_linking                           = true;
 bool g_use_durations                        = false;
 bool g_no_track_statistics_tags             = false;
+bool g_write_crc32                          = false;
+boost::optional<mtx::checksum::algorithm_e> g_output_digest;
 
 double g_timecode_scale                     = TIMECODE_SCALE;
 timecode_scale_mode_e g_timecode_scale_mode = TIMECODE_SCALE_MODE_NORMAL;
@@ -142,6 +153,7 @@ int64_t g_tags_size                         = 0;
 int g_file_num = 1;
 
 int g_split_max_num_files                   = 65535;
+unsigned int g_split_jobs                   = 1;
 std::string g_splitting_by_chapters_arg;
 
 append_mode_e g_append_mode                 = APPEND_MODE_FILE_BASED;
@@ -166,9 +178,15 @@ static std::unique_ptr<KaxAttachments> s_kax_as;
 static std::unique_ptr<EbmlVoid> s_kax_sh_void;
 static std::unique_ptr<EbmlVoid> s_kax_chapters_void;
 static int64_t s_max_chapter_size           = 0;
+static std::unique_ptr<EbmlVoid> s_kax_cues_void;
+static std::unique_ptr<EbmlVoid> s_kax_tags_void;
 static std::unique_ptr<EbmlVoid> s_void_after_track_headers;
 
 static mm_io_cptr s_out;
+// The write buffer calculating the current output file's digest. It is
+// either s_out itself or the one s_out streams to.
+static mm_write_buffer_io_c *s_digest_out = nullptr;
+static std::string s_digest_file_name;
 
 static bitvalue_c s_seguid_prev(128), s_seguid_current(128), s_seguid_next(128);
 
@@ -225,6 +243,12 @@ sighandler(int /* signum */) {
   if (!s_out)
     mxerror(Y("mkvmerge was interrupted by a SIGINT (Ctrl+C?)\n"));
 
+  // Nothing already written can be fixed when streaming.
+  if (g_streaming_output) {
+    cleanup();
+    mxerror(Y("mkvmerge was interrupted by a SIGINT (Ctrl+C?)\n"));
+  }
+
   mxwarn(Y("\nmkvmerge received a SIGINT (probably because the user pressed "
            "Ctrl+C). Trying to sanitize the file. If mkvmerge hangs during "
            "this process you'll have to kill it manually.\n"));
@@ -438,6 +462,12 @@ set_timecode_scale() {
   mxdebug_if(debug, boost::format("timecode_scale: %1% max ns per cluster: %2%\n") % g_timecode_scale % g_max_ns_per_cluster);
 }
 
+static bool
+streaming_output_started() {
+  auto stream_out = dynamic_cast<mm_stream_output_io_c *>(g_cluster_helper->get_output());
+  return stream_out && stream_out->is_streaming();
+}
+
 bool
 set_required_matroska_version(unsigned int required_version) {
   auto previous               = s_required_matroska_version;
@@ -489,6 +519,11 @@ rerender_ebml_head() {
   if (!out || !s_head)
     return;
 
+  if (streaming_output_started()) {
+    mxwarn(Y("The EBML head would have to be modified, but this is not possible anymore as the output is being streamed.\n"));
+    return;
+  }
+
   out->save_pos(s_head->GetElementPosition());
   render_ebml_head(out);
   out->restore_pos();
@@ -530,6 +565,32 @@ generate_segment_uids() {
   s_seguid_next.generate_random();
 }
 
+/** \brief Calculate the padding to reserve behind a header element
+
+   The padding requested with '--header-padding' is either a fixed
+   number of bytes or a percentage of the size of the element it
+   follows. Later edits with tools like mkvpropedit can then grow the
+   element in place.
+*/
+static int64_t
+calculate_header_padding(int64_t element_size) {
+  return g_header_padding_is_percentage ? element_size * g_header_padding / 100 : g_header_padding;
+}
+
+/** \brief Render a level 1 master element, with a CRC-32 if requested
+*/
+static void
+render_level1_element(EbmlMaster &master,
+                      mm_io_c &out,
+                      bool write_defaults) {
+  if (!g_write_crc32) {
+    master.Render(out, write_defaults);
+    return;
+  }
+
+  render_with_ebml_crc32(master, out, [&master, write_defaults](mm_io_c &buffer) { master.Render(buffer, write_defaults); });
+}
+
 /** \brief Render the basic EBML and Matroska headers
 
    Renders the segment information and track headers. Also reserves
@@ -543,10 +604,14 @@ render_headers(mm_io_c *out) {
 
     s_kax_infos = std::make_unique<KaxInfo>();
 
-    s_kax_duration = new KaxMyDuration{ !g_video_packetizer || (TIMECODE_SCALE_MODE_AUTO == g_timecode_scale_mode) ? EbmlFloat::FLOAT_64 : EbmlFloat::FLOAT_32};
+    // The duration is only known at the very end. A streamed file
+    // cannot be updated then, therefore it doesn't get one.
+    if (!g_streaming_output) {
+      s_kax_duration = new KaxMyDuration{ !g_video_packetizer || (TIMECODE_SCALE_MODE_AUTO == g_timecode_scale_mode) ? EbmlFloat::FLOAT_64 : EbmlFloat::FLOAT_32};
 
-    s_kax_duration->SetValue(0.0);
-    s_kax_infos->PushElement(*s_kax_duration);
+      s_kax_duration->SetValue(0.0);
+      s_kax_infos->PushElement(*s_kax_duration);
+    }
 
     if (s_muxing_app.empty()) {
       if (!hack_engaged(ENGAGE_NO_VARIABLE_DATA)) {
@@ -625,6 +690,16 @@ render_headers(mm_io_c *out) {
 
     g_kax_segment->WriteHead(*out, 8);
 
+    // A streamed segment's size is never known in advance. Mark it as
+    // unknown by setting all bits of its eight byte long size field.
+    if (g_streaming_output) {
+      unsigned char const unknown_size[8] = { 0x01, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+
+      out->save_pos(g_kax_segment->GetElementPosition() + g_kax_segment->HeadSize() - 8);
+      out->write(unknown_size, 8);
+      out->restore_pos();
+    }
+
     // Reserve some space for the meta seek stuff.
     g_kax_sh_main = std::make_unique<KaxSeekHead>();
     s_kax_sh_void = std::make_unique<EbmlVoid>();
@@ -655,7 +730,12 @@ render_headers(mm_io_c *out) {
     } else
       set_timecode_scale();
 
-    s_kax_infos->Render(*out, true);
+    if (g_write_crc32) {
+      add_ebml_crc32_element(*s_kax_infos);
+      add_ebml_crc32_element(*g_kax_tracks);
+    }
+
+    render_level1_element(*s_kax_infos, *out, true);
     g_kax_sh_main->IndexThis(*s_kax_infos, *g_kax_segment);
 
     if (!g_packetizers.empty()) {
@@ -663,13 +743,13 @@ render_headers(mm_io_c *out) {
       uint64_t full_header_size = g_kax_tracks->ElementSize(true);
       g_kax_tracks->UpdateSize(false);
 
-      g_kax_tracks->Render(*out, false);
+      render_level1_element(*g_kax_tracks, *out, false);
       g_kax_sh_main->IndexThis(*g_kax_tracks, *g_kax_segment);
 
       // Reserve some small amount of space for header changes by the
       // packetizers.
       s_void_after_track_headers = std::make_unique<EbmlVoid>();
-      s_void_after_track_headers->SetSize(1024 + full_header_size - g_kax_tracks->ElementSize(false));
+      s_void_after_track_headers->SetSize(1024 + full_header_size - g_kax_tracks->ElementSize(false) + calculate_header_padding(g_kax_tracks->ElementSize(false)));
       s_void_after_track_headers->Render(*out);
     }
 
@@ -771,8 +851,22 @@ relocate_written_data(uint64_t data_start_pos,
     s_kax_chapters_void->Render(*s_out);
   }
 
+  if (s_kax_cues_void) {
+    mxdebug_if(s_debug_rerender_track_headers, boost::format("[rerender]  re-writing cues placeholder; old position %1% new %2%\n") % s_kax_cues_void->GetElementPosition() % (s_kax_cues_void->GetElementPosition() + delta));
+    s_out->setFilePointer(s_kax_cues_void->GetElementPosition() + delta);
+    s_kax_cues_void->Render(*s_out);
+  }
+
+  if (s_kax_tags_void) {
+    mxdebug_if(s_debug_rerender_track_headers, boost::format("[rerender]  re-writing tags placeholder; old position %1% new %2%\n") % s_kax_tags_void->GetElementPosition() % (s_kax_tags_void->GetElementPosition() + delta));
+    s_out->setFilePointer(s_kax_tags_void->GetElementPosition() + delta);
+    s_kax_tags_void->Render(*s_out);
+  }
+
   s_out->setFilePointer(rel_pos_from_end, seek_end);
 
+  g_profiler.add_to_counter("relocated bytes", to_relocate);
+
   adjust_cue_and_seekhead_positions(data_start_pos, delta);
 }
 
@@ -802,7 +896,7 @@ shrink_void_and_rerender_track_headers(int64_t new_void_size) {
 
   s_out->setFilePointer(g_kax_tracks->GetElementPosition());
 
-  g_kax_tracks->Render(*s_out, false);
+  render_level1_element(*g_kax_tracks, *s_out, false);
   render_void(new_void_size);
 
   s_out->setFilePointer(0, seek_end);
@@ -827,6 +921,19 @@ shrink_void_and_rerender_track_headers(int64_t new_void_size) {
 */
 void
 rerender_track_headers() {
+  if (streaming_output_started()) {
+    static auto s_warning_issued = false;
+
+    mxdebug_if(s_debug_rerender_track_headers, "[rerender] not possible; the output is being streamed\n");
+
+    if (!s_warning_issued)
+      mxwarn(Y("The track headers would have to be modified, but this is not possible anymore as the output is being streamed. "
+               "The resulting file might not be played back correctly.\n"));
+
+    s_warning_issued = true;
+    return;
+  }
+
   g_kax_tracks->UpdateSize(false);
 
   auto position_before    = s_out->getFilePointer();
@@ -1154,6 +1261,37 @@ create_packetizers() {
   }
 }
 
+/** \brief Let readers skip the data in front of the first part
+
+   If only certain parts are kept ('--split parts:') then everything
+   in front of the first part is discarded. Readers with an index can
+   start reading shortly before that part instead of demuxing the
+   whole prefix. This is only done for files whose timestamps aren't
+   modified by command line options and if no file is appended.
+*/
+void
+skip_to_first_part() {
+  static auto s_debug = debugging_option_c{"skip_to_first_part|splitting"};
+
+  auto start = g_cluster_helper->get_start_of_first_part();
+  if (!start.valid() || s_appending_files)
+    return;
+
+  for (auto &file : g_files) {
+    auto &ti = file->reader->m_ti;
+
+    if (   file->is_playlist
+        || !ti.m_timecode_syncs.empty()
+        || !ti.m_all_ext_timecodes.empty()
+        || !ti.m_reset_timecodes_specs.empty())
+      continue;
+
+    auto skipped = file->reader->skip_to_timestamp(start.to_ns());
+
+    mxdebug_if(s_debug, boost::format("skip_to_first_part: file %1% start %2% skipped? %3%\n") % file->name % format_timestamp(start) % skipped);
+  }
+}
+
 void
 check_track_id_validity() {
   // Check if all track IDs given on the command line are actually
@@ -1282,10 +1420,28 @@ render_chapter_void_placeholder() {
   }
 
   s_kax_chapters_void = std::make_unique<EbmlVoid>();
-  s_kax_chapters_void->SetSize(s_max_chapter_size + 100);
+  s_kax_chapters_void->SetSize(s_max_chapter_size + 100 + calculate_header_padding(s_max_chapter_size));
   s_kax_chapters_void->Render(*s_out);
 }
 
+/** \brief Render an EbmlVoid element as a placeholder for the cues
+
+    The cues are normally written at the end of the file. Players
+    streaming a file have to read its end before they can seek. If the
+    user has requested it then space for the estimated number of cue
+    entries is reserved in front of the first cluster. The cues are
+    written into it in \c finish_file() if they fit.
+ */
+static void
+render_cues_void_placeholder() {
+  if (!g_write_cues || (0 >= g_num_cue_points_to_reserve))
+    return;
+
+  s_kax_cues_void = std::make_unique<EbmlVoid>();
+  s_kax_cues_void->SetSize(cues_c::get().estimate_element_size(g_num_cue_points_to_reserve));
+  s_kax_cues_void->Render(*s_out);
+}
+
 /** \brief Prepare tag elements for rendering
 
     Adds missing mandatory elements to the tag structures and sorts
@@ -1312,6 +1468,64 @@ prepare_tags_for_rendering() {
   g_tags_size = s_kax_tags->ElementSize();
 }
 
+/** \brief Render an EbmlVoid element as a placeholder for the tags
+
+    Tags are normally written at the end of the file where growing
+    them later on is cheap for mkvmerge but where \c kax_analyzer_c
+    cannot leave any padding behind them. If the user has requested
+    header padding then space for the tags plus the padding is
+    reserved in front of the first cluster. The tags are written into
+    it in \c finish_file() if they fit.
+
+    The track statistics tags are only created at the end. Their size
+    is estimated from the number of tracks.
+ */
+static void
+render_tags_void_placeholder() {
+  if (!g_header_padding || outputting_webm() || g_streaming_output)
+    return;
+
+  auto statistics_size = g_no_track_statistics_tags ? 0 : 400 * static_cast<int64_t>(g_packetizers.size());
+  auto tags_size       = g_tags_size + statistics_size;
+
+  if (!tags_size)
+    return;
+
+  s_kax_tags_void = std::make_unique<EbmlVoid>();
+  s_kax_tags_void->SetSize(tags_size + 100 + calculate_header_padding(tags_size));
+  s_kax_tags_void->Render(*s_out);
+}
+
+static void
+enable_output_digest(std::string const &file_name) {
+  if (!g_output_digest || g_cluster_helper->discarding()) {
+    s_digest_out = nullptr;
+    return;
+  }
+
+  if (!s_digest_out) {
+    mxwarn(boost::format(Y("The digest of the file '%1%' cannot be calculated when writing to the standard output.\n")) % file_name);
+    return;
+  }
+
+  s_digest_out->enable_digest(*g_output_digest);
+  s_digest_file_name = file_name;
+}
+
+static void
+finish_output_digest() {
+  if (!s_digest_out)
+    return;
+
+  auto digest  = s_digest_out->finish_digest();
+  s_digest_out = nullptr;
+
+  output_digest_c::write_digest_file(s_digest_file_name, *g_output_digest, digest);
+
+  if (verbose)
+    mxinfo(boost::format(Y("The %1% digest of the file '%2%' is %3%.\n")) % output_digest_c::get_algorithm_name(*g_output_digest) % s_digest_file_name % digest);
+}
+
 /** \brief Creates the next output file
 
    Creates a new file name depending on the split settings. Opens that
@@ -1328,11 +1542,24 @@ create_next_output_file() {
 
   // Open the output file.
   try {
-    s_out = !g_cluster_helper->discarding() ? mm_write_buffer_io_c::open(this_outfile, 20 * 1024 * 1024) : mm_io_cptr{ new mm_null_io_c{this_outfile} };
+    if (g_cluster_helper->discarding())
+      s_out = mm_io_cptr{ new mm_null_io_c{this_outfile} };
+
+    else if (!g_streaming_output) {
+      s_out        = mm_write_buffer_io_c::open(this_outfile, 20 * 1024 * 1024);
+      s_digest_out = static_cast<mm_write_buffer_io_c *>(s_out.get());
+
+    } else {
+      auto stream_out = this_outfile == "-" ? mm_io_cptr{ new mm_stdio_c } : mm_write_buffer_io_c::open(this_outfile, 4 * 1024 * 1024);
+      s_out           = mm_io_cptr{ new mm_stream_output_io_c{stream_out} };
+      s_digest_out    = dynamic_cast<mm_write_buffer_io_c *>(stream_out.get());
+    }
   } catch (mtx::mm_io::exception &ex) {
     mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % this_outfile % ex);
   }
 
+  enable_output_digest(this_outfile);
+
   if (verbose && !g_cluster_helper->discarding())
     mxinfo(boost::format(Y("The file '%1%' has been opened for writing.\n")) % this_outfile);
 
@@ -1341,8 +1568,10 @@ create_next_output_file() {
   render_headers(s_out.get());
   render_attachments(s_out.get());
   render_chapter_void_placeholder();
+  render_cues_void_placeholder();
   add_tags_from_cue_chapters();
   prepare_tags_for_rendering();
+  render_tags_void_placeholder();
 
   if (g_cluster_helper->discarding())
     return;
@@ -1406,57 +1635,89 @@ render_chapters() {
   s_kax_chapters_void.reset();
 }
 
-static KaxTags *
-set_track_statistics_tags(KaxTags *tags) {
-  if (g_no_track_statistics_tags || outputting_webm())
-    return tags;
+static void
+render_cues() {
+  auto &cues = cues_c::get();
 
-  if (!tags)
-    tags = new KaxTags;
+  if (s_kax_cues_void) {
+    auto needed    = cues.calculate_element_size();
+    auto available = s_kax_cues_void->ElementSize(true);
+    auto written   = cues.write_into_placeholder(*s_out, *g_kax_sh_main, *s_kax_cues_void);
 
-  g_cluster_helper->create_tags_for_track_statistics(*tags, s_writing_app, s_writing_date);
+    s_kax_cues_void.reset();
 
-  return tags;
+    if (written)
+      return;
+
+    mxwarn(boost::format(Y("The space reserved for the cues in front of the first cluster was too small (needed: %1% bytes, available: %2% bytes). "
+                           "The cues will be written at the end of the file instead. Use a higher value for '--cues-at-front'.\n"))
+           % needed % available);
+  }
+
+  cues.write(*s_out, *g_kax_sh_main);
 }
 
-/** \brief Finishes and closes the current file
+static void
+render_main_seek_head() {
+  if ((g_kax_sh_main->ListSize() == 0) || hack_engaged(ENGAGE_NO_META_SEEK))
+    return;
 
-   Renders the data that is generated during the muxing run. The cues
-   and meta seek information are rendered at the end. If splitting is
-   active the chapters are stripped to those that actually lie in this
-   file and rendered at the front.  The segment duration and the
-   segment size are set to their actual values.
+  g_kax_sh_main->UpdateSize();
+  if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
+    mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. Size needed: %1%. %2%\n"))
+           % g_kax_sh_main->ElementSize() % BUGMSG);
+}
+
+/** \brief Switch the output to writing sequentially
+
+   Only used for streaming output. Called right before the first
+   cluster is rendered. Up to this point everything has been kept in
+   memory so that the headers could still be modified. The chapters
+   and the meta seek information are rendered now as nothing in front
+   of the first cluster can be changed afterwards.
 */
 void
-finish_file(bool last_file,
-            bool create_new_file,
-            bool previously_discarding) {
-  if (g_kax_chapters && !previously_discarding)
+start_streaming_output() {
+  auto stream_out = dynamic_cast<mm_stream_output_io_c *>(s_out.get());
+  if (!stream_out || stream_out->is_streaming())
+    return;
+
+  if (g_kax_chapters)
     add_chapters_for_current_part();
 
-  if (!last_file && !create_new_file)
-    return;
+  render_chapters();
 
-  run_before_file_finished_packetizer_hooks();
+  if (s_chapters_in_this_file && !hack_engaged(ENGAGE_NO_CHAPTERS_IN_META_SEEK))
+    g_kax_sh_main->IndexThis(*s_chapters_in_this_file, *g_kax_segment);
 
-  bool do_output = verbose && !dynamic_cast<mm_null_io_c *>(s_out.get());
-  if (do_output)
-    mxinfo("\n");
+  if (s_kax_as)
+    g_kax_sh_main->IndexThis(*s_kax_as, *g_kax_segment);
 
-  // Render the track headers a second time if the user has requested that.
-  if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
-    auto second_tracks = clone(g_kax_tracks);
-    second_tracks->Render(*s_out);
-    g_kax_sh_main->IndexThis(*second_tracks, *g_kax_segment);
-  }
+  render_main_seek_head();
 
-  // Render the cues.
-  if (g_write_cues && g_cue_writing_requested) {
-    if (do_output)
-      mxinfo(Y("The cue entries (the index) are being written...\n"));
-    cues_c::get().write(*s_out, *g_kax_sh_main);
-  }
+  stream_out->start_streaming();
+}
+
+static KaxTags *
+set_track_statistics_tags(KaxTags *tags) {
+  if (g_no_track_statistics_tags || outputting_webm())
+    return tags;
+
+  if (!tags)
+    tags = new KaxTags;
+
+  g_cluster_helper->create_tags_for_track_statistics(*tags, s_writing_app, s_writing_date);
+
+  return tags;
+}
 
+/** \brief Update the segment info once the file is complete
+
+   Re-renders the segment duration with the biggest timecode
+   encountered and handles the 'next segment UID'.
+*/
+static void
+update_segment_info(bool last_file) {
   // Now re-render the s_kax_duration and fill in the biggest timecode
   // as the file's duration.
   s_out->save_pos(s_kax_duration->GetElementPosition());
@@ -1487,11 +1748,12 @@ finish_file(bool last_file,
       }
   }
 
-  if (0 != changed) {
+  // The CRC-32 has to be updated for the new duration as well.
+  if ((0 != changed) || g_write_crc32) {
     s_out->setFilePointer(s_kax_infos->GetElementPosition());
     s_kax_infos->UpdateSize(true);
     info_size -= s_kax_infos->ElementSize();
-    s_kax_infos->Render(*s_out, true);
+    render_level1_element(*s_kax_infos, *s_out, true);
     if (2 == changed) {
       if (2 < info_size) {
         EbmlVoid void_after_infos;
@@ -1507,10 +1769,55 @@ finish_file(bool last_file,
     }
   }
   s_out->restore_pos();
+}
+
+/** \brief Finishes and closes the current file
+
+   Renders the data that is generated during the muxing run. The cues
+   and meta seek information are rendered at the end. If splitting is
+   active the chapters are stripped to those that actually lie in this
+   file and rendered at the front.  The segment duration and the
+   segment size are set to their actual values.
+*/
+void
+finish_file(bool last_file,
+            bool create_new_file,
+            bool previously_discarding) {
+  if (g_kax_chapters && !previously_discarding)
+    add_chapters_for_current_part();
+
+  if (!last_file && !create_new_file)
+    return;
+
+  run_before_file_finished_packetizer_hooks();
+
+  // Nothing has been streamed yet if no cluster was written.
+  start_streaming_output();
+
+  bool do_output = verbose && !dynamic_cast<mm_null_io_c *>(s_out.get());
+  if (do_output)
+    mxinfo("\n");
+
+  // Render the track headers a second time if the user has requested that.
+  if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
+    auto second_tracks = clone(g_kax_tracks);
+    render_level1_element(*second_tracks, *s_out, true);
+    g_kax_sh_main->IndexThis(*second_tracks, *g_kax_segment);
+  }
+
+  // Render the cues.
+  if (g_write_cues && g_cue_writing_requested) {
+    if (do_output)
+      mxinfo(Y("The cue entries (the index) are being written...\n"));
+    render_cues();
+  }
+
+  if (!g_streaming_output)
+    update_segment_info(last_file);
 
   // Render the segment info a second time if the user has requested that.
   if (hack_engaged(ENGAGE_WRITE_HEADERS_TWICE)) {
-    s_kax_infos->Render(*s_out);
+    render_level1_element(*s_kax_infos, *s_out, true);
     g_kax_sh_main->IndexThis(*s_kax_infos, *g_kax_segment);
   }
 
@@ -1544,7 +1851,9 @@ finish_file(bool last_file,
   if (tags_here) {
     mtx::tags::fix_mandatory_elements(tags_here);
     tags_here->UpdateSize();
-    tags_here->Render(*s_out, true);
+
+    if (!s_kax_tags_void || (s_kax_tags_void->ReplaceWith(*tags_here, *s_out, true, true) == INVALID_FILEPOS_T))
+      tags_here->Render(*s_out, true);
 
     g_kax_sh_main->IndexThis(*tags_here, *g_kax_segment);
     delete tags_here;
@@ -1561,17 +1870,18 @@ finish_file(bool last_file,
     s_kax_as.reset();
   }
 
-  if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
-    g_kax_sh_main->UpdateSize();
-    if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
-      mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. Size needed: %1%. %2%\n"))
-             % g_kax_sh_main->ElementSize() % BUGMSG);
+  // When streaming the meta seek information has already been written
+  // by start_streaming_output(), and the segment's size stays unknown.
+  if (!g_streaming_output) {
+    render_main_seek_head();
+
+    // Set the correct size for the segment.
+    int64_t final_file_size = s_out->getFilePointer();
+    if (g_kax_segment->ForceSize(final_file_size - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
+      g_kax_segment->OverwriteHead(*s_out);
   }
 
-  // Set the correct size for the segment.
-  int64_t final_file_size = s_out->getFilePointer();
-  if (g_kax_segment->ForceSize(final_file_size - g_kax_segment->GetElementPosition() - g_kax_segment->HeadSize()))
-    g_kax_segment->OverwriteHead(*s_out);
+  finish_output_digest();
 
   s_out.reset();
 
@@ -1579,6 +1889,8 @@ finish_file(bool last_file,
   s_kax_sh_void.reset();
   g_kax_sh_main.reset();
   s_void_after_track_headers.reset();
+  s_kax_cues_void.reset();
+  s_kax_tags_void.reset();
   g_kax_sh_cues.reset();
   s_head.reset();
 }
@@ -1592,11 +1904,35 @@ force_close_output_file() {
   if (wb_out)
     wb_out->discard_buffer();
 
+  s_digest_out = nullptr;
   s_out.reset();
 }
 
 static void establish_deferred_connections(filelist_t &file);
 
+/** \brief Releases the file handle and read buffer of a finished file
+
+   When many files are appended to each other then only the files
+   currently being read are kept open. All others have either not been
+   started yet (see \c suspend_appended_files) or are finished. Only
+   the file handle and the read buffer are released. The reader, the
+   data parsed from the file's headers and its packetizers stay in
+   memory until the end as the packetizers are still referenced by the
+   appended tracks.
+*/
+static void
+release_input_of_finished_file(filelist_t &file) {
+  if (s_appending_files && file.reader && file.reader->m_in)
+    file.reader->m_in->suspend();
+}
+
+void
+suspend_appended_files() {
+  for (auto &file : g_files)
+    if (file->appending && file->reader && file->reader->m_in)
+      file->reader->m_in->suspend();
+}
+
 static void
 append_chapters_for_track(filelist_t &src_file,
                           int64_t timecode_adjustment) {
@@ -1658,6 +1994,7 @@ append_track(packetizer_t &ptzr,
     dst_file.old_num_unfinished_packetizers = 0;
     dst_file.done                           = true;
     establish_deferred_connections(dst_file);
+    release_input_of_finished_file(dst_file);
   }
 
   if (   !ptzr.deferred
@@ -1898,6 +2235,7 @@ pull_packetizers_for_packets() {
       if ((0 >= file.num_unfinished_packetizers) && (0 < file.old_num_unfinished_packetizers)) {
         establish_deferred_connections(file);
         file.done = true;
+        release_input_of_finished_file(file);
       }
       file.old_num_unfinished_packetizers = file.num_unfinished_packetizers;
     }
@@ -22,6 +22,7 @@
 
 #include "common/bitvalue.h"
 #include "common/chapters/chapters.h"
+#include "common/checksums/base_fwd.h"
 #include "common/mm_mpls_multi_file_io.h"
 #include "common/segmentinfo.h"
 #include "merge/file_status.h"
@@ -186,7 +187,12 @@ extern float g_video_fps;
 extern generic_packetizer_c *g_video_packetizer;
 
 extern bool g_write_cues, g_cue_writing_requested;
-extern bool g_no_lacing, g_no_linking, g_use_durations, g_no_track_statistics_tags;
+extern int64_t g_num_cue_points_to_reserve;
+extern int64_t g_header_padding;
+extern bool g_header_padding_is_percentage;
+extern bool g_streaming_output;
+extern bool g_no_lacing, g_no_linking, g_use_durations, g_no_track_statistics_tags, g_write_crc32;
+extern boost::optional<mtx::checksum::algorithm_e> g_output_digest;
 
 extern bool g_identifying;
 extern identification_output_format_e g_identification_output_format;
@@ -196,9 +202,11 @@ extern int64_t g_file_sizes;
 
 extern int64_t g_max_ns_per_cluster;
 extern int g_max_blocks_per_cluster;
+extern int64_t g_target_cluster_size;
 extern int g_default_tracks[3], g_default_tracks_priority[3];
 
 extern int g_split_max_num_files;
+extern unsigned int g_split_jobs;
 extern std::string g_splitting_by_chapters_arg;
 
 extern append_mode_e g_append_mode;
@@ -207,6 +215,8 @@ void create_packetizers();
 void calc_attachment_sizes();
 void calc_max_chapter_size();
 void check_track_id_validity();
+void skip_to_first_part();
+void suspend_appended_files();
 void check_append_mapping();
 
 void cleanup();
@@ -219,6 +229,7 @@ void create_next_output_file();
 void finish_file(bool last_file, bool create_new_file = false, bool previously_discarding = false);
 void force_close_output_file();
 void rerender_track_headers();
+void start_streaming_output();
 void rerender_ebml_head();
 std::string create_output_name();
 
@@ -0,0 +1,279 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   creating the parts of a split in parallel processes
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#if !defined(SYS_WINDOWS)
+# include <sys/wait.h>
+#endif
+
+#include "common/bitvalue.h"
+#include "common/fs_sys_helpers.h"
+#include "common/mm_io.h"
+#include "common/mm_io_x.h"
+#include "common/strings/editing.h"
+#include "common/strings/formatting.h"
+#include "merge/cluster_helper.h"
+#include "merge/output_control.h"
+#include "merge/parallel_split.h"
+
+namespace {
+
+struct job_t {
+  parallel_split_part_t m_part;
+  std::vector<std::string> m_args;
+  bfs::path m_option_file_name;
+  int m_exit_code{};
+};
+
+debugging_option_c s_debug{"parallel_split|splitting"};
+
+}
+
+std::vector<parallel_split_part_t>
+determine_parallel_split_parts() {
+  auto const &split_points = g_cluster_helper->get_split_points();
+  if (split_points.empty())
+    return {};
+
+  auto parts = std::vector<parallel_split_part_t>{};
+  auto type  = split_points.front().m_type;
+
+  if (split_point_c::timecode == type) {
+    std::vector<int64_t> starts{ 0 };
+
+    for (auto const &split_point : split_points)
+      if (split_point.m_point > starts.back())
+        starts.push_back(split_point.m_point);
+
+    for (auto idx = 0u; idx < starts.size(); ++idx)
+      parts.push_back({ { { starts[idx], idx + 1 < starts.size() ? starts[idx + 1] : -1 } }, {} });
+
+  } else if (split_point_c::parts == type) {
+    // Points that aren't discarded start a range, either in a new file
+    // or appended to the current one ('+'). Each point ends the range
+    // started before it.
+    for (auto const &split_point : split_points) {
+      if (!parts.empty() && (-1 == parts.back().m_ranges.back().second))
+        parts.back().m_ranges.back().second = split_point.m_point;
+
+      if (split_point.m_discard)
+        continue;
+
+      if (split_point.m_create_new_file || parts.empty())
+        parts.emplace_back();
+
+      parts.back().m_ranges.emplace_back(split_point.m_point, -1);
+    }
+
+  } else
+    return {};
+
+  if (parts.size() > static_cast<std::size_t>(g_split_max_num_files))
+    parts.resize(g_split_max_num_files);
+
+  for (auto idx = 0u; idx < parts.size(); ++idx) {
+    g_file_num             = idx + 1;
+    parts[idx].m_file_name = create_output_name();
+  }
+
+  g_file_num = 1;
+
+  return parts;
+}
+
+static std::vector<std::string>
+remove_per_part_options(std::vector<std::string> const &args) {
+  static std::vector<std::string> const s_options_with_value{
+    "-o", "--output", "--split", "--split-jobs", "--split-max-files", "--segment-uid", "--link-to-previous", "--link-to-next",
+  };
+
+  auto remaining = std::vector<std::string>{};
+
+  // '--link' is kept: with it the children keep the source timestamps
+  // instead of starting each file at 0, just like sequential splitting.
+  for (auto idx = 0u; idx < args.size(); ++idx) {
+    if (brng::find(s_options_with_value, args[idx]) != s_options_with_value.end()) {
+      ++idx;
+      continue;
+    }
+
+    remaining.push_back(args[idx]);
+  }
+
+  return remaining;
+}
+
+static std::string
+format_segment_uid(bitvalue_c const &uid) {
+  auto formatted = std::string{};
+  for (auto idx = 0u; idx < uid.byte_size(); ++idx)
+    formatted += (boost::format("%|1$02x|") % static_cast<unsigned int>(uid[idx])).str();
+
+  return formatted;
+}
+
+static std::string
+quote_for_shell(std::string const &arg) {
+#if defined(SYS_WINDOWS)
+  return std::string{"\""} + arg + "\"";
+#else
+  auto quoted = std::string{"'"};
+  for (auto c : arg)
+    quoted += '\'' == c ? std::string{"'\\''"} : std::string(1, c);
+
+  return quoted + "'";
+#endif
+}
+
+static void
+write_option_file(job_t &job) {
+  job.m_option_file_name = bfs::temp_directory_path() / bfs::unique_path("mkvmerge-split-%%%%-%%%%-%%%%.txt");
+
+  try {
+    mm_file_io_c out{job.m_option_file_name.string(), MODE_CREATE};
+    for (auto const &arg : job.m_args)
+      out.puts((arg.empty() ? std::string{"#EMPTY#"} : escape(arg)) + "\n");
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % job.m_option_file_name.string() % ex);
+  }
+}
+
+static int
+run_job(job_t const &job) {
+  auto executable = mtx::sys::get_installation_path() / "mkvmerge";
+#if defined(SYS_WINDOWS)
+  executable.replace_extension(".exe");
+#endif
+
+  auto command = quote_for_shell(executable.string()) + " " + quote_for_shell(std::string{"@"} + job.m_option_file_name.string());
+  auto result  = mtx::sys::system(command);
+
+  // On Windows only a failure to start the process is reported.
+#if defined(SYS_WINDOWS)
+  return result ? 2 : 0;
+#else
+  return (-1 != result) && WIFEXITED(result) ? WEXITSTATUS(result) : 2;
+#endif
+}
+
+void
+run_parallel_split(std::vector<std::string> const &args) {
+  auto parts = determine_parallel_split_parts();
+  if (parts.empty())
+    mxerror(Y("Splitting in parallel is only possible with '--split timecodes:...', '--split parts:...' or '--split chapters:...'.\n"));
+
+  auto base_args = remove_per_part_options(args);
+  base_args.push_back("--quiet");
+
+  std::vector<bitvalue_cptr> segment_uids;
+  for (auto idx = 0u; idx < parts.size(); ++idx) {
+    if (!g_forced_seguids.empty()) {
+      segment_uids.push_back(g_forced_seguids.front());
+      g_forced_seguids.pop_front();
+      continue;
+    }
+
+    segment_uids.push_back(std::make_shared<bitvalue_c>(128));
+    segment_uids.back()->generate_random();
+  }
+
+  std::vector<job_t> jobs;
+
+  for (auto idx = 0u; idx < parts.size(); ++idx) {
+    auto const &part = parts[idx];
+    auto ranges      = std::vector<std::string>{};
+
+    for (auto const &range : part.m_ranges)
+      ranges.emplace_back((boost::format("%1%%2%ns-%3%")
+                           % (ranges.empty() ? "" : "+")
+                           % range.first
+                           % (-1 == range.second ? std::string{} : (boost::format("%1%ns") % range.second).str())).str());
+
+    jobs.emplace_back();
+    auto &job  = jobs.back();
+    job.m_part = part;
+    job.m_args = base_args;
+
+    job.m_args.insert(job.m_args.end(), { "-o", part.m_file_name, "--split", "parts:" + join(",", ranges), "--segment-uid", format_segment_uid(*segment_uids[idx]) });
+
+    // The UIDs of all parts are known up front. Therefore the links
+    // between the parts can be written directly instead of fixing
+    // them up once all parts have been created.
+    auto previous_uid = !idx                       ? g_seguid_link_previous
+                      : !g_no_linking              ? segment_uids[idx - 1]
+                      :                              bitvalue_cptr{};
+    auto next_uid     = (idx + 1) == parts.size()  ? g_seguid_link_next
+                      : !g_no_linking              ? segment_uids[idx + 1]
+                      :                              bitvalue_cptr{};
+
+    if (previous_uid)
+      job.m_args.insert(job.m_args.end(), { "--link-to-previous", format_segment_uid(*previous_uid) });
+    if (next_uid)
+      job.m_args.insert(job.m_args.end(), { "--link-to-next", format_segment_uid(*next_uid) });
+
+    write_option_file(job);
+
+    mxdebug_if(s_debug, boost::format("parallel split: part %1% option file %2% args %3%\n") % (idx + 1) % job.m_option_file_name.string() % join(" ", job.m_args));
+  }
+
+  auto num_threads = std::min<std::size_t>(g_split_jobs, jobs.size());
+  mxinfo(boost::format(Y("Creating %1% files with up to %2% processes running in parallel.\n")) % jobs.size() % num_threads);
+
+  std::atomic<std::size_t> next_job{0};
+  std::mutex output_mutex;
+  std::vector<std::thread> threads;
+
+  for (auto thread_idx = 0u; thread_idx < num_threads; ++thread_idx)
+    threads.emplace_back([&jobs, &next_job, &output_mutex]() {
+      while (true) {
+        auto job_idx = next_job++;
+        if (job_idx >= jobs.size())
+          return;
+
+        auto &job       = jobs[job_idx];
+        job.m_exit_code = run_job(job);
+
+        if (1 < job.m_exit_code)
+          continue;
+
+        std::lock_guard<std::mutex> lock{output_mutex};
+        mxinfo(boost::format(Y("The file '%1%' has been written.\n")) % job.m_part.m_file_name);
+      }
+    });
+
+  for (auto &thread : threads)
+    thread.join();
+
+  auto num_failed = 0u;
+
+  for (auto &job : jobs) {
+    boost::system::error_code ec;
+    bfs::remove(job.m_option_file_name, ec);
+
+    if (1 == job.m_exit_code)
+      mxwarn(boost::format(Y("There were warnings while creating the file '%1%'.\n")) % job.m_part.m_file_name);
+
+    else if (1 < job.m_exit_code)
+      ++num_failed;
+  }
+
+  for (auto &job : jobs)
+    if (1 < job.m_exit_code)
+      mxerror(boost::format(Y("Creating the file '%1%' failed. %2% of %3% files could not be created.\n")) % job.m_part.m_file_name % num_failed % jobs.size());
+}
@@ -0,0 +1,39 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   creating the parts of a split in parallel processes
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_PARALLEL_SPLIT_H
+#define MTX_MERGE_PARALLEL_SPLIT_H
+
+#include "common/common_pch.h"
+
+// The ranges of timestamps written to one file. An end of -1 means
+// that the range extends to the end of the source files.
+struct parallel_split_part_t {
+  std::vector<std::pair<int64_t, int64_t> > m_ranges;
+  std::string m_file_name;
+};
+
+// Determines the parts to create from the split points. Returns an
+// empty list if the split mode does not allow knowing the parts up
+// front. Only splitting by timestamps (including chapters) and by
+// parts does; with e.g. splitting by duration the files start at the
+// first key frame after the duration which isn't known before muxing.
+std::vector<parallel_split_part_t> determine_parallel_split_parts();
+
+// Runs one mkvmerge process per part with at most g_split_jobs
+// processes at the same time. Each process receives the original
+// command line arguments 'args' with the splitting, output and
+// segment linking options replaced by ones for its part.
+void run_parallel_split(std::vector<std::string> const &args);
+
+#endif  // MTX_MERGE_PARALLEL_SPLIT_H
@@ -38,8 +38,9 @@ public:
   kax_cluster_c *cluster;
   std::vector<packet_cptr> packets;
   int cluster_content_size;
+  int64_t bytes_since_video_keyframe;
   int64_t max_timecode_and_duration, max_video_timecode_rendered;
-  int64_t previous_cluster_tc, num_cue_elements, header_overhead;
+  int64_t previous_cluster_tc, queued_packets_size, header_overhead;
   int64_t timecode_offset;
   int64_t bytes_in_file, first_timecode_in_file, first_timecode_in_part, first_discarded_timecode, last_discarded_timecode_and_duration, discarded_duration, previous_discarded_duration;
   timestamp_c min_timecode_in_file;
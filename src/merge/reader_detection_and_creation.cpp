@@ -14,6 +14,7 @@
 
 #include "common/mm_mpls_multi_file_io.h"
 #include "common/mm_read_buffer_io.h"
+#include "common/mm_suspendable_file_io.h"
 #include "common/strings/formatting.h"
 #include "common/xml/xml.h"
 #include "input/r_aac.h"
@@ -69,7 +70,7 @@ static mm_io_cptr
 open_input_file(filelist_t &file) {
   try {
     if (file.all_names.size() == 1)
-      return mm_io_cptr(new mm_read_buffer_io_c(new mm_file_io_c(file.name), 1 << 17));
+      return mm_io_cptr(new mm_read_buffer_io_c(new mm_suspendable_file_io_c(file.name), 1 << 17));
 
     else {
       std::vector<bfs::path> paths = file_names_to_paths(file.all_names);
@@ -394,6 +395,12 @@ create_readers() {
       // multi I/O reader in read_headers().
       file->size = file->reader->get_file_size();
 
+      // Appended files are only read once the previous file has been
+      // read completely. Until then their files don't have to be
+      // kept open.
+      if (file->appending)
+        file->reader->m_in->suspend();
+
       mxdebug_if(s_debug_timecode_restrictions,
                  boost::format("Timecode restrictions for %3%: min %1% max %2%\n") % file->restricted_timecode_min % file->restricted_timecode_max % file->ti->m_fname);
 
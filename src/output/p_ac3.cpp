@@ -104,7 +104,7 @@ ac3_packetizer_c::set_headers() {
 }
 
 int
-ac3_packetizer_c::process(packet_cptr packet) {
+ac3_packetizer_c::process_impl(packet_cptr packet) {
   // if (packet->has_timecode())
   //   mxinfo(boost::format("tc %1% %2% %3% %4%\n") % format_timestamp(packet->timecode) % to_hex(packet->data->get_buffer(), std::min<size_t>(packet->data->get_size(), 16))
   //          % mtx::checksum::calculate_as_uint(mtx::checksum::adler32, packet->data->get_buffer(), std::min<size_t>(packet->data->get_size(), 512)) % packet->data->get_size());
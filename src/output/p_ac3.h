@@ -33,7 +33,7 @@ public:
   ac3_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, int samples_per_sec, int channels, int bsid, bool framed = false);
   virtual ~ac3_packetizer_c();
 
-  virtual int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet);
   virtual void flush_packets();
   virtual void set_headers();
 
@@ -37,7 +37,7 @@ public:
   dts_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, mtx::dts::header_t const &dts_header);
   virtual ~dts_packetizer_c();
 
-  virtual int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet);
   virtual void set_headers();
   virtual void set_skipping_is_normal(bool skipping_is_normal) {
     m_skipping_is_normal = skipping_is_normal;
@@ -32,7 +32,7 @@ public:
   kate_packetizer_c(generic_reader_c *reader, track_info_c &ti);
   virtual ~kate_packetizer_c();
 
-  virtual int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet);
   virtual void set_headers();
 
   virtual translatable_string_c get_format_name() const {
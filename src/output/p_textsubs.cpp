@@ -76,7 +76,7 @@ textsubs_packetizer_c::set_headers() {
 }
 
 int
-textsubs_packetizer_c::process(packet_cptr packet) {
+textsubs_packetizer_c::process_impl(packet_cptr packet) {
   ++m_packetno;
 
   if (0 > packet->duration) {
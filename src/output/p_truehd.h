@@ -33,7 +33,7 @@ public:
   truehd_packetizer_c(generic_reader_c *p_reader, track_info_c &p_ti, truehd_frame_t::codec_e codec, int sampling_rate, int channels);
   virtual ~truehd_packetizer_c();
 
-  virtual int process(packet_cptr packet);
+  virtual int process_impl(packet_cptr packet);
   virtual void process_framed(truehd_frame_cptr const &frame, int64_t provided_timecode);
   virtual void set_headers();
 
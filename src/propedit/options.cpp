@@ -32,6 +32,14 @@ options_c::validate() {
   if (m_file_name.empty())
     mxerror(Y("No file name given.\n"));
 
+  if (!m_output_file_name.empty()) {
+    auto file_name   = bfs::absolute(bfs::path{m_file_name});
+    auto output_name = bfs::absolute(bfs::path{m_output_file_name});
+
+    if (bfs::exists(output_name) && bfs::equivalent(file_name, output_name))
+      mxerror(Y("The output file must not be the same as the file to edit.\n"));
+  }
+
   if (!has_changes())
     mxerror(Y("Nothing to do.\n"));
 
@@ -103,6 +111,14 @@ options_c::set_file_name(const std::string &file_name) {
   m_file_name = file_name;
 }
 
+void
+options_c::set_output_file_name(const std::string &file_name) {
+  if (!m_output_file_name.empty())
+    mxerror(boost::format(Y("More than one output file name has been given ('%1%' and '%2%').\n")) % m_output_file_name % file_name);
+
+  m_output_file_name = file_name;
+}
+
 void
 options_c::set_parse_mode(const std::string &parse_mode) {
   if (parse_mode == "full")
@@ -120,12 +136,14 @@ options_c::dump_info()
   const
 {
   mxinfo(boost::format("options:\n"
-                       "  file_name:     %1%\n"
-                       "  show_progress: %2%\n"
-                       "  parse_mode:    %3%\n")
+                       "  file_name:        %1%\n"
+                       "  output_file_name: %4%\n"
+                       "  show_progress:    %2%\n"
+                       "  parse_mode:       %3%\n")
          % m_file_name
          % m_show_progress
-         % static_cast<int>(m_parse_mode));
+         % static_cast<int>(m_parse_mode)
+         % m_output_file_name);
 
   for (auto &target : m_targets)
     target->dump_info();
@@ -10,12 +10,21 @@
 
 #include "common/common_pch.h"
 
+#if defined(HAVE_UNISTD_H)
+# include <unistd.h>
+#endif  // HAVE_UNISTD_H
+#if defined(HAVE_SYS_SYSCALL_H)
+# include <sys/syscall.h>
+#endif
+#include <fcntl.h>
+
 #include <matroska/KaxChapters.h>
 #include <matroska/KaxInfo.h>
 #include <matroska/KaxTags.h>
 #include <matroska/KaxTracks.h>
 
 #include "common/command_line.h"
+#include "common/mm_io.h"
 #include "common/mm_io_x.h"
 #include "common/unique_numbers.h"
 #include "common/version.h"
@@ -78,6 +87,81 @@ write_changes(options_cptr &options,
   }
 }
 
+#if defined(HAVE_SYSCALL) && defined(SYS_copy_file_range)
+// Lets the kernel copy the data without passing it through user
+// space. On file systems supporting it (e.g. Btrfs, XFS, NFS) no data
+// is copied at all; the destination shares the source's extents.
+// Returns false if the kernel does not support this for the given
+// files so that the caller can fall back to copying the data itself.
+static bool
+copy_file_in_kernel(std::string const &source_name,
+                    std::string const &destination_name) {
+  auto in = ::open(source_name.c_str(), O_RDONLY);
+  if (-1 == in)
+    return false;
+
+  auto out = ::open(destination_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (-1 == out) {
+    ::close(in);
+    return false;
+  }
+
+  auto copied_anything = false;
+  auto ok              = true;
+
+  while (true) {
+    auto num_copied = syscall(SYS_copy_file_range, in, nullptr, out, nullptr, 1 << 30, 0u);
+    if (0 == num_copied)
+      break;
+
+    if (0 > num_copied) {
+      // Only fall back if nothing's been written yet; other errors
+      // such as a full disk are reported to the user.
+      if (copied_anything || ((ENOSYS != errno) && (EXDEV != errno) && (EINVAL != errno) && (EOPNOTSUPP != errno)))
+        mxerror(boost::format(Y("Copying the file '%1%' to '%2%' failed: %3%.\n")) % source_name % destination_name % strerror(errno));
+      ok = false;
+      break;
+    }
+
+    copied_anything = true;
+  }
+
+  ::close(in);
+  ::close(out);
+
+  return ok;
+}
+#endif  // HAVE_SYSCALL && SYS_copy_file_range
+
+static void
+copy_source_file(std::string const &source_name,
+                 std::string const &destination_name) {
+  mxinfo(boost::format(Y("The file is being copied to '%1%'.\n")) % destination_name);
+
+#if defined(HAVE_SYSCALL) && defined(SYS_copy_file_range)
+  if (copy_file_in_kernel(source_name, destination_name))
+    return;
+#endif
+
+  try {
+    mm_file_io_c in{source_name, MODE_READ};
+    mm_file_io_c out{destination_name, MODE_CREATE};
+    memory_cptr buffer = memory_c::alloc(4 * 1024 * 1024);
+
+    while (true) {
+      auto num_read = in.read(buffer->get_buffer(), buffer->get_size());
+      if (!num_read)
+        break;
+
+      if (out.write(buffer->get_buffer(), num_read) != num_read)
+        throw mtx::mm_io::end_of_file_x{};
+    }
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxerror(boost::format(Y("Copying the file '%1%' to '%2%' failed: %3%.\n")) % source_name % destination_name % ex);
+  }
+}
+
 static void
 run(options_cptr &options) {
   console_kax_analyzer_cptr analyzer;
@@ -86,6 +170,13 @@ run(options_cptr &options) {
     if (!kax_analyzer_c::probe(options->m_file_name))
       mxerror(boost::format("The file '%1%' is not a Matroska file or it could not be found.\n") % options->m_file_name);
 
+    // The clusters are copied verbatim; only the level 1 elements
+    // that are changed are rewritten in the copy afterwards.
+    if (!options->m_output_file_name.empty()) {
+      copy_source_file(options->m_file_name, options->m_output_file_name);
+      options->m_file_name = options->m_output_file_name;
+    }
+
     analyzer = console_kax_analyzer_cptr(new console_kax_analyzer_c(options->m_file_name));
   } catch (mtx::mm_io::exception &ex) {
     mxerror(boost::format("The file '%1%' could not be opened for reading and writing: %1.\n") % options->m_file_name % ex);
@@ -192,6 +192,11 @@ propedit_cli_parser_c::set_file_name() {
   m_options->set_file_name(m_current_arg);
 }
 
+void
+propedit_cli_parser_c::set_output_file_name() {
+  m_options->set_output_file_name(m_next_arg);
+}
+
 #define OPT(spec, func, description) add_option(spec, std::bind(&propedit_cli_parser_c::func, this), description)
 
 void
@@ -201,6 +206,7 @@ propedit_cli_parser_c::init_parser() {
   add_section_header(YT("Options"));
   OPT("l|list-property-names",      list_property_names, YT("List all valid property names and exit"));
   OPT("p|parse-mode=<mode>",        set_parse_mode,      YT("Sets the Matroska parser mode to 'fast' (default) or 'full'"));
+  OPT("o|output=<file>",            set_output_file_name, YT("Copy the file to 'file' and apply all changes to the copy instead of the original file"));
 
   add_section_header(YT("Actions for handling properties"));
   OPT("e|edit=<selector>",          add_target,          YT("Sets the Matroska file section that all following add/set/delete "
@@ -38,6 +38,7 @@ protected:
   void add_chapters();
   void set_parse_mode();
   void set_file_name();
+  void set_output_file_name();
 
   void set_attachment_name();
   void set_attachment_description();
@@ -0,0 +1,573 @@
+/*
+   sample_generator - A tool for generating large synthetic input files
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/command_line.h"
+#include "common/endian.h"
+#include "common/mm_io_x.h"
+#include "common/mm_write_buffer_io.h"
+#include "common/strings/formatting.h"
+#include "common/strings/parsing.h"
+
+enum class file_type_e {
+    unknown
+  , mkv
+  , wav
+  , srt
+};
+
+class cli_options_c {
+public:
+  std::string m_file_name;
+  file_type_e m_type;
+  uint64_t m_size, m_seed;
+
+  cli_options_c()
+    : m_type{file_type_e::unknown}
+    , m_size{100 * 1024 * 1024}
+    , m_seed{0x4d6b76546f6f6c4eull}
+  {
+  }
+};
+
+// xorshift64*: cheap and produces the same data on all platforms for
+// the same seed.
+class random_c {
+private:
+  uint64_t m_state;
+
+public:
+  random_c(uint64_t seed)
+    : m_state{seed ? seed : 1}
+  {
+  }
+
+  uint64_t
+  next() {
+    m_state ^= m_state >> 12;
+    m_state ^= m_state << 25;
+    m_state ^= m_state >> 27;
+    return m_state * 2685821657736338717ull;
+  }
+
+  uint64_t
+  next(uint64_t limit) {
+    return next() % limit;
+  }
+};
+
+// Frame data is taken from varying positions of a pool of random
+// bytes. Generating all of it byte by byte would make the generator
+// much slower than the programs it's supposed to feed.
+class payload_pool_c {
+private:
+  random_c &m_random;
+  memory_cptr m_pool;
+
+public:
+  payload_pool_c(random_c &random)
+    : m_random(random)
+    , m_pool{memory_c::alloc(4 * 1024 * 1024)}
+  {
+    auto ptr = m_pool->get_buffer();
+    for (auto idx = 0u, size = static_cast<unsigned int>(m_pool->get_size()); idx < size; idx += 8)
+      put_uint64_le(&ptr[idx], m_random.next());
+  }
+
+  std::string
+  get(size_t size) {
+    size        = std::min<size_t>(size, m_pool->get_size());
+    auto offset = m_random.next(m_pool->get_size() - size + 1);
+
+    return std::string{reinterpret_cast<char const *>(m_pool->get_buffer() + offset), size};
+  }
+};
+
+namespace ebml {
+
+std::string
+id(uint32_t value) {
+  auto num_bytes = value >= 0x1000000 ? 4 : value >= 0x10000 ? 3 : value >= 0x100 ? 2 : 1;
+  std::string result;
+
+  for (auto shift = (num_bytes - 1) * 8; shift >= 0; shift -= 8)
+    result += static_cast<char>((value >> shift) & 0xff);
+
+  return result;
+}
+
+std::string
+size(uint64_t value,
+     int num_bytes = 0) {
+  if (!num_bytes)
+    for (num_bytes = 1; (num_bytes < 8) && (value >= ((1ull << (7 * num_bytes)) - 1)); ++num_bytes)
+      ;
+
+  value |= 1ull << (7 * num_bytes);
+  std::string result;
+
+  for (auto shift = (num_bytes - 1) * 8; shift >= 0; shift -= 8)
+    result += static_cast<char>((value >> shift) & 0xff);
+
+  return result;
+}
+
+std::string
+element(uint32_t element_id,
+        std::string const &content) {
+  return id(element_id) + size(content.size()) + content;
+}
+
+std::string
+unsigned_int(uint32_t element_id,
+             uint64_t value) {
+  std::string content;
+
+  do {
+    content.insert(content.begin(), static_cast<char>(value & 0xff));
+    value >>= 8;
+  } while (value);
+
+  return element(element_id, content);
+}
+
+std::string
+float64(uint32_t element_id,
+        double value) {
+  uint64_t bits;
+  char buffer[8];
+
+  std::memcpy(&bits, &value, sizeof(bits));
+  put_uint64_be(buffer, bits);
+
+  return element(element_id, std::string{buffer, sizeof(buffer)});
+}
+
+}
+
+// Element IDs used below
+enum {
+    EBML_ID_HEADER                = 0x1a45dfa3
+  , EBML_ID_VERSION               = 0x4286
+  , EBML_ID_READ_VERSION          = 0x42f7
+  , EBML_ID_MAX_ID_LENGTH         = 0x42f2
+  , EBML_ID_MAX_SIZE_LENGTH       = 0x42f3
+  , EBML_ID_DOC_TYPE              = 0x4282
+  , EBML_ID_DOC_TYPE_VERSION      = 0x4287
+  , EBML_ID_DOC_TYPE_READ_VERSION = 0x4285
+  , KAX_ID_SEGMENT                = 0x18538067
+  , KAX_ID_INFO                   = 0x1549a966
+  , KAX_ID_TIMECODE_SCALE         = 0x2ad7b1
+  , KAX_ID_MUXING_APP             = 0x4d80
+  , KAX_ID_WRITING_APP            = 0x5741
+  , KAX_ID_TRACKS                 = 0x1654ae6b
+  , KAX_ID_TRACK_ENTRY            = 0xae
+  , KAX_ID_TRACK_NUMBER           = 0xd7
+  , KAX_ID_TRACK_UID              = 0x73c5
+  , KAX_ID_TRACK_TYPE             = 0x83
+  , KAX_ID_FLAG_LACING            = 0x9c
+  , KAX_ID_DEFAULT_DURATION       = 0x23e383
+  , KAX_ID_CODEC_ID               = 0x86
+  , KAX_ID_CODEC_PRIVATE          = 0x63a2
+  , KAX_ID_VIDEO                  = 0xe0
+  , KAX_ID_PIXEL_WIDTH            = 0xb0
+  , KAX_ID_PIXEL_HEIGHT           = 0xba
+  , KAX_ID_AUDIO                  = 0xe1
+  , KAX_ID_SAMPLING_FREQUENCY     = 0xb5
+  , KAX_ID_CHANNELS               = 0x9f
+  , KAX_ID_BIT_DEPTH              = 0x6264
+  , KAX_ID_CLUSTER                = 0x1f43b675
+  , KAX_ID_CLUSTER_TIMECODE       = 0xe7
+  , KAX_ID_SIMPLE_BLOCK           = 0xa3
+  , KAX_ID_BLOCK_GROUP            = 0xa0
+  , KAX_ID_BLOCK                  = 0xa1
+  , KAX_ID_BLOCK_DURATION         = 0x9b
+};
+
+// 25 frames per second, PCM audio in blocks of the same duration
+// and one subtitle entry every two seconds. Each cluster holds one
+// second worth of data and starts with a video key frame.
+auto const s_frame_duration_ms      = 40;
+auto const s_frames_per_cluster     = 25;
+auto const s_subtitle_interval_ms   = 2000;
+auto const s_subtitle_duration_ms   = 1500;
+auto const s_video_frame_size       = 40000;
+auto const s_audio_sampling_rate    = 48000;
+auto const s_audio_channels         = 2;
+auto const s_audio_bytes_per_second = s_audio_sampling_rate * s_audio_channels * 2;
+
+static std::string
+create_text(random_c &random) {
+  static std::vector<std::string> const s_words{
+    "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "Matroska", "subtitle", "entry", "with", "some", "words", "in", "it",
+  };
+
+  auto num_lines = 1 + random.next(2);
+  std::string text;
+
+  for (auto line = 0u; line < num_lines; ++line) {
+    auto num_words = 3 + random.next(8);
+
+    for (auto word = 0u; word < num_words; ++word)
+      text += (word ? " " : "") + s_words[random.next(s_words.size())];
+
+    if (line < (num_lines - 1))
+      text += "\n";
+  }
+
+  return text;
+}
+
+static std::string
+create_block_content(unsigned int track_number,
+                     int16_t relative_timecode,
+                     unsigned char flags,
+                     std::string const &payload) {
+  char header[4];
+
+  header[0] = 0x80 | track_number;
+  put_uint16_be(&header[1], relative_timecode);
+  header[3] = flags;
+
+  return std::string{header, sizeof(header)} + payload;
+}
+
+static std::string
+create_track_entries() {
+  char bitmap_info_header[40];
+
+  std::memset(bitmap_info_header, 0, sizeof(bitmap_info_header));
+  put_uint32_le(&bitmap_info_header[0],  sizeof(bitmap_info_header));
+  put_uint32_le(&bitmap_info_header[4],  1280);
+  put_uint32_le(&bitmap_info_header[8],  720);
+  put_uint16_le(&bitmap_info_header[12], 1);
+  put_uint16_le(&bitmap_info_header[14], 24);
+  // A FourCC no packetizer knows: the frames are passed through as-is.
+  std::memcpy(&bitmap_info_header[16], "MTXS", 4);
+
+  auto video = ebml::unsigned_int(KAX_ID_TRACK_NUMBER,     1)
+             + ebml::unsigned_int(KAX_ID_TRACK_UID,        1)
+             + ebml::unsigned_int(KAX_ID_TRACK_TYPE,       1)
+             + ebml::unsigned_int(KAX_ID_FLAG_LACING,      0)
+             + ebml::unsigned_int(KAX_ID_DEFAULT_DURATION, s_frame_duration_ms * 1000000)
+             + ebml::element(KAX_ID_CODEC_ID,              "V_MS/VFW/FOURCC")
+             + ebml::element(KAX_ID_CODEC_PRIVATE,         std::string{bitmap_info_header, sizeof(bitmap_info_header)})
+             + ebml::element(KAX_ID_VIDEO,
+                               ebml::unsigned_int(KAX_ID_PIXEL_WIDTH,  1280)
+                             + ebml::unsigned_int(KAX_ID_PIXEL_HEIGHT, 720));
+
+  auto audio = ebml::unsigned_int(KAX_ID_TRACK_NUMBER, 2)
+             + ebml::unsigned_int(KAX_ID_TRACK_UID,    2)
+             + ebml::unsigned_int(KAX_ID_TRACK_TYPE,   2)
+             + ebml::unsigned_int(KAX_ID_FLAG_LACING,  0)
+             + ebml::element(KAX_ID_CODEC_ID,          "A_PCM/INT/LIT")
+             + ebml::element(KAX_ID_AUDIO,
+                               ebml::float64(KAX_ID_SAMPLING_FREQUENCY, s_audio_sampling_rate)
+                             + ebml::unsigned_int(KAX_ID_CHANNELS,      s_audio_channels)
+                             + ebml::unsigned_int(KAX_ID_BIT_DEPTH,     16));
+
+  auto subtitles = ebml::unsigned_int(KAX_ID_TRACK_NUMBER, 3)
+                 + ebml::unsigned_int(KAX_ID_TRACK_UID,    3)
+                 + ebml::unsigned_int(KAX_ID_TRACK_TYPE,   0x11)
+                 + ebml::unsigned_int(KAX_ID_FLAG_LACING,  0)
+                 + ebml::element(KAX_ID_CODEC_ID,          "S_TEXT/UTF8");
+
+  return ebml::element(KAX_ID_TRACK_ENTRY, video)
+       + ebml::element(KAX_ID_TRACK_ENTRY, audio)
+       + ebml::element(KAX_ID_TRACK_ENTRY, subtitles);
+}
+
+static void
+write_string(mm_io_c &out,
+             std::string const &data) {
+  if (out.write(data.c_str(), data.size()) != data.size())
+    throw mtx::mm_io::end_of_file_x{};
+}
+
+static void
+generate_mkv(mm_io_c &out,
+             cli_options_c const &options) {
+  random_c random{options.m_seed};
+  payload_pool_c pool{random};
+
+  write_string(out,
+               ebml::element(EBML_ID_HEADER,
+                               ebml::unsigned_int(EBML_ID_VERSION,               1)
+                             + ebml::unsigned_int(EBML_ID_READ_VERSION,          1)
+                             + ebml::unsigned_int(EBML_ID_MAX_ID_LENGTH,         4)
+                             + ebml::unsigned_int(EBML_ID_MAX_SIZE_LENGTH,       8)
+                             + ebml::element(EBML_ID_DOC_TYPE,                   "matroska")
+                             + ebml::unsigned_int(EBML_ID_DOC_TYPE_VERSION,      2)
+                             + ebml::unsigned_int(EBML_ID_DOC_TYPE_READ_VERSION, 2)));
+
+  // The segment's size is only known at the end. Reserve eight bytes
+  // for it.
+  write_string(out, ebml::id(KAX_ID_SEGMENT));
+  auto segment_size_position = out.getFilePointer();
+  write_string(out, ebml::size(0, 8));
+  auto segment_data_position = out.getFilePointer();
+
+  write_string(out,
+               ebml::element(KAX_ID_INFO,
+                               ebml::unsigned_int(KAX_ID_TIMECODE_SCALE, 1000000)
+                             + ebml::element(KAX_ID_MUXING_APP,  "sample_generator")
+                             + ebml::element(KAX_ID_WRITING_APP, "sample_generator v" PACKAGE_VERSION)));
+  write_string(out, ebml::element(KAX_ID_TRACKS, create_track_entries()));
+
+  auto audio_block_size = s_audio_bytes_per_second * s_frame_duration_ms / 1000;
+  auto timecode         = int64_t{};
+
+  while (out.getFilePointer() < options.m_size) {
+    auto cluster_content = ebml::unsigned_int(KAX_ID_CLUSTER_TIMECODE, timecode);
+
+    for (auto frame = 0; frame < s_frames_per_cluster; ++frame) {
+      auto relative_timecode = frame * s_frame_duration_ms;
+      auto is_key_frame      = !frame;
+      auto video_frame_size  = (is_key_frame ? 3 : 1) * s_video_frame_size / 2 + random.next(s_video_frame_size);
+
+      cluster_content += ebml::element(KAX_ID_SIMPLE_BLOCK, create_block_content(1, relative_timecode, is_key_frame ? 0x80 : 0x00, pool.get(video_frame_size)));
+      cluster_content += ebml::element(KAX_ID_SIMPLE_BLOCK, create_block_content(2, relative_timecode, 0x80,                        pool.get(audio_block_size)));
+
+      if ((timecode + relative_timecode) % s_subtitle_interval_ms)
+        continue;
+
+      auto block       = ebml::element(KAX_ID_BLOCK, create_block_content(3, relative_timecode, 0x00, create_text(random)));
+      cluster_content += ebml::element(KAX_ID_BLOCK_GROUP, block + ebml::unsigned_int(KAX_ID_BLOCK_DURATION, s_subtitle_duration_ms));
+    }
+
+    write_string(out, ebml::element(KAX_ID_CLUSTER, cluster_content));
+
+    timecode += s_frames_per_cluster * s_frame_duration_ms;
+  }
+
+  auto end_position = out.getFilePointer();
+  out.setFilePointer(segment_size_position);
+  write_string(out, ebml::size(end_position - segment_data_position, 8));
+  out.setFilePointer(end_position);
+}
+
+static void
+generate_wav(mm_io_c &out,
+             cli_options_c const &options) {
+  auto const header_size   = uint64_t{44};
+  auto const max_data_size = (0xffffffffull - header_size) / 4 * 4;
+  auto data_size           = (std::max(options.m_size, header_size) - header_size) / 4 * 4;
+
+  // Not a warning: callers such as tests/benchmark.rb ask for the same
+  // size for all file types and would treat the exit code 1 as failure.
+  if (data_size > max_data_size) {
+    mxinfo(boost::format("WAV files cannot be bigger than 4 GB; the file will only contain %1% bytes of audio data.\n") % max_data_size);
+    data_size = max_data_size;
+  }
+
+  out.write("RIFF", 4);
+  out.write_uint32_le(data_size + header_size - 8);
+  out.write("WAVEfmt ", 8);
+  out.write_uint32_le(16);
+  out.write_uint16_le(1);
+  out.write_uint16_le(s_audio_channels);
+  out.write_uint32_le(s_audio_sampling_rate);
+  out.write_uint32_le(s_audio_bytes_per_second);
+  out.write_uint16_le(s_audio_channels * 2);
+  out.write_uint16_le(16);
+  out.write("data", 4);
+  out.write_uint32_le(data_size);
+
+  random_c random{options.m_seed};
+  payload_pool_c pool{random};
+
+  for (auto remaining = data_size; remaining > 0;) {
+    auto chunk = pool.get(std::min<uint64_t>(remaining, 64 * 1024));
+    write_string(out, chunk);
+    remaining -= chunk.size();
+  }
+}
+
+static void
+generate_srt(mm_io_c &out,
+             cli_options_c const &options) {
+  random_c random{options.m_seed};
+  auto timecode = int64_t{};
+
+  for (auto number = 1u; out.getFilePointer() < options.m_size; ++number) {
+    auto start = timecode                            * 1000000;
+    auto end   = (timecode + s_subtitle_duration_ms) * 1000000;
+
+    write_string(out,
+                 (boost::format("%1%\n%2% --> %3%\n%4%\n\n")
+                  % number
+                  % format_timestamp(start, "%H:%M:%S,%3n")
+                  % format_timestamp(end,   "%H:%M:%S,%3n")
+                  % create_text(random)).str());
+
+    timecode += s_subtitle_interval_ms;
+  }
+}
+
+static void
+show_help() {
+  mxinfo("sample_generator [options] file_name\n"
+         "\n"
+         "Generates large synthetic input files for measuring the performance of\n"
+         "MKVToolNix' programs. The same options always result in the same file.\n"
+         "The defaults are:\n"
+         "- Type: derived from the file name's extension\n"
+         "- Size: 100M\n"
+         "\n"
+         "Generator options:\n"
+         "\n"
+         "  -t, --type type        Type of file to generate:\n"
+         "                         'mkv': Matroska with video (passthrough FourCC),\n"
+         "                         PCM audio and text subtitles\n"
+         "                         'wav': 48 kHz stereo 16 bit PCM audio\n"
+         "                         'srt': text subtitles\n"
+         "  -s, --size size        Generate about 'size' bytes; the suffixes K, M and\n"
+         "                         G are supported\n"
+         "  --seed number          Seed for the pseudo-random number generator\n"
+         "\n"
+         "General options:\n"
+         "\n"
+         "  -h, --help             This help text\n"
+         "  -V, --version          Print version information\n");
+  mxexit();
+}
+
+static void
+show_version() {
+  mxinfo("sample_generator v" PACKAGE_VERSION "\n");
+  mxexit();
+}
+
+static bool
+parse_size(std::string arg,
+           uint64_t &size) {
+  auto multiplier = uint64_t{1};
+  auto suffix     = arg.empty() ? '\0' : std::toupper(arg.back());
+
+  if (suffix == 'K')
+    multiplier = 1024ull;
+  else if (suffix == 'M')
+    multiplier = 1024ull * 1024;
+  else if (suffix == 'G')
+    multiplier = 1024ull * 1024 * 1024;
+
+  if (1 != multiplier)
+    arg.pop_back();
+
+  if (!parse_number(arg, size))
+    return false;
+
+  size *= multiplier;
+
+  return true;
+}
+
+static file_type_e
+parse_type(std::string const &type) {
+  auto lower = balg::to_lower_copy(type);
+
+  return lower == "mkv" ? file_type_e::mkv
+       : lower == "wav" ? file_type_e::wav
+       : lower == "srt" ? file_type_e::srt
+       :                  file_type_e::unknown;
+}
+
+static cli_options_c
+parse_args(std::vector<std::string> &args) {
+  auto options = cli_options_c{};
+
+  for (auto current = args.begin(), end = args.end(); current != end; ++current) {
+    auto arg      = *current;
+    auto next     = current + 1;
+    auto next_arg = next != end ? *next : "";
+
+    if ((arg == "-h") || (arg == "--help"))
+      show_help();
+
+    else if ((arg == "-V") || (arg == "--version"))
+      show_version();
+
+    else if ((arg == "-t") || (arg == "--type")) {
+      if (next_arg.empty())
+        mxerror(boost::format("Missing argument to %1%\n") % arg);
+
+      options.m_type = parse_type(next_arg);
+      if (file_type_e::unknown == options.m_type)
+        mxerror(boost::format("Invalid argument to %1%: %2%\n") % arg % next_arg);
+
+      ++current;
+
+    } else if ((arg == "-s") || (arg == "--size")) {
+      if (next_arg.empty())
+        mxerror(boost::format("Missing argument to %1%\n") % arg);
+
+      if (!parse_size(next_arg, options.m_size))
+        mxerror(boost::format("Invalid argument to %1%: %2%\n") % arg % next_arg);
+
+      ++current;
+
+    } else if (arg == "--seed") {
+      if (next_arg.empty())
+        mxerror(boost::format("Missing argument to %1%\n") % arg);
+
+      if (!parse_number(next_arg, options.m_seed))
+        mxerror(boost::format("Invalid argument to %1%: %2%\n") % arg % next_arg);
+
+      ++current;
+
+    } else if (!options.m_file_name.empty())
+      mxerror("More than one output file given\n");
+
+    else
+      options.m_file_name = arg;
+  }
+
+  if (options.m_file_name.empty())
+    mxerror("No file name given\n");
+
+  if (file_type_e::unknown == options.m_type)
+    options.m_type = parse_type(balg::trim_left_copy_if(bfs::path{options.m_file_name}.extension().string(), balg::is_any_of(".")));
+
+  if (file_type_e::unknown == options.m_type)
+    mxerror("The file type could not be derived from the file name; use --type\n");
+
+  return options;
+}
+
+int
+main(int argc,
+     char **argv) {
+  mtx_common_init("sample_generator", argv[0]);
+
+  auto args = command_line_utf8(argc, argv);
+  while (handle_common_cli_args(args, "-r"))
+    ;
+
+  auto options = parse_args(args);
+
+  try {
+    auto out = mm_write_buffer_io_c::open(options.m_file_name, 4 * 1024 * 1024);
+
+    if (file_type_e::mkv == options.m_type)
+      generate_mkv(*out, options);
+
+    else if (file_type_e::wav == options.m_type)
+      generate_wav(*out, options);
+
+    else
+      generate_srt(*out, options);
+
+  } catch (mtx::mm_io::exception &) {
+    mxerror(boost::format("The file '%1%' could not be written.\n") % options.m_file_name);
+  }
+
+  mxexit();
+}
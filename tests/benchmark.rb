@@ -0,0 +1,108 @@
+#!/usr/bin/env ruby
+
+# Measures the throughput of the programs on large synthetic input
+# files created by src/tools/sample_generator. Build the programs and
+# the tools first ("rake" and "rake apps:tools").
+
+require "fileutils"
+require "tmpdir"
+
+$top_dir = File.expand_path("..", File.dirname(__FILE__))
+
+def error_and_exit(text, exit_code = 2)
+  puts text
+  exit exit_code
+end
+
+def program(name)
+  [ "#{$top_dir}/src/#{name}", "#{$top_dir}/src/tools/#{name}" ].detect { |file| File.executable? file } || error_and_exit("#{name} has not been built.")
+end
+
+# mkvtoolnix' programs exit with 1 if they've only emitted warnings.
+def run_program(*command)
+  system(*command)
+  !$?.nil? && !$?.exitstatus.nil? && ($?.exitstatus <= 1)
+end
+
+def have_gnu_time?
+  return @have_gnu_time unless @have_gnu_time.nil?
+  @have_gnu_time = File.executable?("/usr/bin/time") && system("/usr/bin/time -f %M true > /dev/null 2>&1")
+end
+
+# Runs the command and returns the wall clock time in seconds and the
+# peak resident set size in bytes (nil if it cannot be determined).
+def run_timed(*command)
+  rss_file = "#{$work_dir}/rss.txt"
+  command  = [ "/usr/bin/time", "-f", "%M", "-o", rss_file ] + command if have_gnu_time?
+  start    = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+
+  run_program(*command, :out => File::NULL) || error_and_exit("Command failed: #{command.join(' ')}")
+
+  duration = Process.clock_gettime(Process::CLOCK_MONOTONIC) - start
+  peak_rss = have_gnu_time? ? IO.readlines(rss_file).last.to_i * 1024 : nil
+
+  [ duration, peak_rss ]
+end
+
+def report(name, input_size, duration, peak_rss)
+  puts sprintf("%-28s %10.1f MB/s %8.2f s   peak RSS %s",
+               name, input_size / duration / 1024 / 1024, duration, peak_rss ? "#{peak_rss / 1024 / 1024} MB" : "n/a")
+end
+
+def generate(file_name, size)
+  puts "Generating #{File.basename(file_name)} (#{size})"
+  run_program(program("sample_generator"), "--size", size, file_name) || error_and_exit("Generating #{file_name} failed")
+end
+
+def main
+  size      = "1G"
+  keep      = false
+  $work_dir = nil
+  args      = ARGV.dup
+
+  while !args.empty?
+    arg = args.shift
+
+    if ((arg == "-s") || (arg == "--size"))
+      size = args.shift || error_and_exit("Missing argument to #{arg}")
+    elsif ((arg == "-d") || (arg == "--directory"))
+      $work_dir = args.shift || error_and_exit("Missing argument to #{arg}")
+      keep      = true
+    elsif ((arg == "-h") || (arg == "--help"))
+      puts <<EOHELP
+Syntax: benchmark.rb [options]
+  -s, --size SIZE       size of the generated Matroska and WAV files (default: 1G)
+  -d, --directory DIR   generate files in DIR and keep them (default: temporary
+                        directory that is removed afterwards)
+EOHELP
+      exit 0
+    else
+      error_and_exit "Unknown argument '#{arg}'."
+    end
+  end
+
+  $work_dir ||= Dir.mktmpdir("mtxbench")
+  FileUtils.mkdir_p $work_dir
+
+  mkv = "#{$work_dir}/sample.mkv"
+  wav = "#{$work_dir}/sample.wav"
+  srt = "#{$work_dir}/sample.srt"
+  out = "#{$work_dir}/out.mkv"
+
+  [ [ mkv, size ], [ wav, size ], [ srt, "4M" ] ].each { |file_name, file_size| generate file_name, file_size unless keep && File.exist?(file_name) }
+
+  puts "Peak RSS is only available if GNU time is installed as /usr/bin/time." unless have_gnu_time?
+
+  mkv_size     = File.size(mkv)
+  wav_srt_size = File.size(wav) + File.size(srt)
+
+  report "mkvmerge: remux Matroska", mkv_size,     *run_timed(program("mkvmerge"),   "-o", out, mkv)
+  report "mkvmerge: WAV + SRT",      wav_srt_size, *run_timed(program("mkvmerge"),   "-o", out, wav, srt)
+  report "mkvextract: all tracks",   mkv_size,     *run_timed(program("mkvextract"), "tracks", mkv, "0:#{$work_dir}/video.avi", "1:#{$work_dir}/audio.wav", "2:#{$work_dir}/subtitles.srt")
+  report "mkvinfo: summary",         mkv_size,     *run_timed(program("mkvinfo"),    "-s", mkv)
+
+ensure
+  FileUtils.rm_rf $work_dir if $work_dir && !keep
+end
+
+main
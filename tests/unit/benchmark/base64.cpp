@@ -0,0 +1,28 @@
+#include "common/common_pch.h"
+
+#include "common/base64.h"
+#include "tests/unit/benchmark/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Attachments are stored Base64 encoded in XML files.
+TEST(Benchmark, Base64) {
+  auto data    = mtxbench::create_pseudo_random_data(16 * 1024 * 1024);
+  auto encoded = base64_encode(data->get_buffer(), data->get_size());
+
+  mtxbench::measure("Base64 encoding", [&data]() -> uint64_t {
+    base64_encode(data->get_buffer(), data->get_size());
+    return data->get_size();
+  });
+
+  mtxbench::measure("Base64 decoding", [&encoded]() -> uint64_t {
+    base64_decode(encoded);
+    return encoded.size();
+  });
+
+  EXPECT_EQ(std::string(reinterpret_cast<char const *>(data->get_buffer()), data->get_size()), base64_decode(encoded));
+}
+
+}
@@ -0,0 +1,19 @@
+#include "common/common_pch.h"
+
+#include <iostream>
+
+#include "common/fs_sys_helpers.h"
+#include "tests/unit/init.h"
+
+int
+main(int argc,
+     char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  ::mtxut::init_suite(argv[0]);
+
+  auto result = RUN_ALL_TESTS();
+
+  std::cout << boost::format("Peak memory usage: %1% bytes\n") % mtx::sys::get_peak_memory_usage();
+
+  return result;
+}
@@ -0,0 +1,60 @@
+#include "common/common_pch.h"
+
+#include "common/bit_cursor.h"
+#include "tests/unit/benchmark/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(Benchmark, BitReaderGetBits) {
+  auto data = mtxbench::create_pseudo_random_data(4 * 1024 * 1024);
+
+  // Field widths as they occur in typical headers
+  static std::size_t const s_widths[] = { 1, 3, 5, 8, 2, 13, 1, 16, 4, 7, 1, 24, 6, 1, 9, 32 };
+
+  mtxbench::measure("bit_reader_c::get_bits()", [&data]() -> uint64_t {
+    bit_reader_c r{data->get_buffer(), data->get_size()};
+    auto sum = uint64_t{};
+
+    while (r.get_remaining_bits() >= 128)
+      for (auto width : s_widths)
+        sum += r.get_bits(width);
+
+    EXPECT_NE(0u, sum);
+
+    return data->get_size();
+  });
+}
+
+TEST(Benchmark, BitReaderGetUnsignedGolomb) {
+  auto data = memory_c::alloc(4 * 1024 * 1024);
+  bit_writer_c w{data->get_buffer(), data->get_size()};
+  auto num_values = 0u;
+
+  // Exp-Golomb codes of 0…255 repeated until the buffer's almost full
+  while (w.get_bit_position() < static_cast<int>(data->get_size() * 8 - 32)) {
+    auto code_num = (num_values++ % 256) + 1;
+    auto num_bits = 0u;
+
+    while ((code_num >> num_bits) > 1)
+      ++num_bits;
+
+    w.put_bits(num_bits, 0);
+    w.put_bits(num_bits + 1, code_num);
+  }
+
+  mtxbench::measure("bit_reader_c::get_unsigned_golomb()", [&data, num_values]() -> uint64_t {
+    bit_reader_c r{data->get_buffer(), data->get_size()};
+    auto sum = uint64_t{};
+
+    for (auto idx = 0u; idx < num_values; ++idx)
+      sum += r.get_unsigned_golomb();
+
+    EXPECT_EQ(num_values / 256 * 255 * 128 + ((num_values % 256) * ((num_values % 256) - 1) / 2), sum);
+
+    return data->get_size();
+  });
+}
+
+}
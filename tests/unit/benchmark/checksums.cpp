@@ -0,0 +1,55 @@
+#include "common/common_pch.h"
+
+#include "common/checksums/base.h"
+#include "tests/unit/benchmark/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class BenchmarkChecksum: public ::testing::Test {
+public:
+  memory_cptr m_data;
+
+  BenchmarkChecksum()
+    : m_data{mtxbench::create_pseudo_random_data(16 * 1024 * 1024)}
+  {
+  }
+
+  void
+  run(std::string const &name,
+      mtx::checksum::algorithm_e algorithm) {
+    auto &data = *m_data;
+
+    mtxbench::measure(name, [&data, algorithm]() -> uint64_t {
+      mtx::checksum::calculate_as_uint(algorithm, data);
+      return data.get_size();
+    });
+  }
+};
+
+TEST_F(BenchmarkChecksum, Adler32) {
+  run("Adler-32", mtx::checksum::algorithm_e::adler32);
+}
+
+TEST_F(BenchmarkChecksum, CRC8ATM) {
+  run("CRC-8 ATM", mtx::checksum::algorithm_e::crc8_atm);
+}
+
+TEST_F(BenchmarkChecksum, CRC32IEEE) {
+  run("CRC-32 IEEE", mtx::checksum::algorithm_e::crc32_ieee);
+}
+
+TEST_F(BenchmarkChecksum, CRC32IEEELE) {
+  run("CRC-32 IEEE little endian", mtx::checksum::algorithm_e::crc32_ieee_le);
+}
+
+TEST_F(BenchmarkChecksum, CRC16ANSI) {
+  run("CRC-16 ANSI", mtx::checksum::algorithm_e::crc16_ansi);
+}
+
+TEST_F(BenchmarkChecksum, MD5) {
+  run("MD5", mtx::checksum::algorithm_e::md5);
+}
+
+}
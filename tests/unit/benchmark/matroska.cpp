@@ -0,0 +1,132 @@
+#include "common/common_pch.h"
+
+#include <matroska/KaxCluster.h>
+#include <matroska/KaxCues.h>
+#include <matroska/KaxSegment.h>
+#include <matroska/KaxTracks.h>
+
+#include "common/ebml.h"
+#include "common/kax_cluster_walker.h"
+#include "common/kax_file.h"
+#include "common/mm_io.h"
+#include "merge/libmatroska_extensions.h"
+#include "tests/unit/benchmark/util.h"
+
+#include "gtest/gtest.h"
+
+using namespace libmatroska;
+
+namespace {
+
+auto const s_num_clusters   = 64;
+auto const s_num_blocks     = 128;
+auto const s_block_size     = 2048;
+auto const s_block_duration = int64_t{40000000};
+auto const s_timecode_scale = int64_t{1000000};
+
+class BenchmarkMatroska: public ::testing::Test {
+public:
+  KaxSegment m_segment;
+  KaxTrackEntry m_track;
+  memory_cptr m_payload;
+
+  BenchmarkMatroska()
+    : m_payload{mtxbench::create_pseudo_random_data(s_block_size)}
+  {
+    GetChild<KaxTrackNumber>(m_track).SetValue(1);
+    m_track.SetGlobalTimecodeScale(s_timecode_scale);
+    m_track.EnableLacing(false);
+  }
+
+  // Renders clusters the same way cluster_helper_c does: one block
+  // blob per frame, simple blocks only, no lacing.
+  void
+  render_clusters(mm_io_c &out) {
+    auto timecode = int64_t{};
+
+    for (auto cluster_idx = 0; cluster_idx < s_num_clusters; ++cluster_idx) {
+      kax_cluster_c cluster;
+      KaxCues cues;
+      std::vector<kax_block_blob_cptr> blobs;
+
+      cues.SetGlobalTimecodeScale(s_timecode_scale);
+      cluster.SetParent(m_segment);
+      cluster.SetPreviousTimecode(std::max<int64_t>(0, timecode - 1), s_timecode_scale);
+      cluster.set_min_timecode(timecode);
+
+      for (auto block_idx = 0; block_idx < s_num_blocks; ++block_idx) {
+        auto blob = kax_block_blob_cptr{new kax_block_blob_c(BLOCK_BLOB_ALWAYS_SIMPLE)};
+        blobs.push_back(blob);
+
+        cluster.AddBlockBlob(blob.get());
+        blob->SetParent(cluster);
+        blob->add_frame_auto(m_track, timecode, *new DataBuffer(m_payload->get_buffer(), m_payload->get_size()), LACING_NONE, -1, -1);
+
+        cluster.set_max_timecode(timecode);
+        timecode += s_block_duration;
+      }
+
+      cluster.Render(out, cues);
+      cluster.delete_non_blocks();
+    }
+  }
+
+  memory_cptr
+  create_rendered_clusters() {
+    mm_mem_io_c out{nullptr, 0, 1024 * 1024};
+    render_clusters(out);
+
+    return memory_c::clone(out.get_buffer(), out.getFilePointer());
+  }
+};
+
+TEST_F(BenchmarkMatroska, ClusterRendering) {
+  mtxbench::measure("cluster rendering", [this]() -> uint64_t {
+    mm_mem_io_c out{nullptr, 0, 1024 * 1024};
+    render_clusters(out);
+
+    return out.getFilePointer();
+  });
+}
+
+TEST_F(BenchmarkMatroska, ClusterParsing) {
+  auto clusters = create_rendered_clusters();
+
+  mtxbench::measure("cluster parsing with kax_file_c", [&clusters]() -> uint64_t {
+    auto in         = mm_io_cptr{new mm_mem_io_c{*clusters}};
+    auto num_blocks = 0;
+    kax_file_c file{in};
+
+    // There's no segment whose end would stop the reader.
+    while (in->getFilePointer() < clusters->get_size()) {
+      auto cluster = std::unique_ptr<KaxCluster>{file.read_next_cluster()};
+      if (!cluster)
+        break;
+
+      num_blocks += cluster->ListSize() - 1;
+    }
+
+    EXPECT_EQ(s_num_clusters * s_num_blocks, num_blocks);
+
+    return clusters->get_size();
+  });
+}
+
+TEST_F(BenchmarkMatroska, ClusterWalking) {
+  auto clusters = create_rendered_clusters();
+
+  mtxbench::measure("cluster walking with kax_cluster_walker_c", [&clusters]() -> uint64_t {
+    mm_mem_io_c in{*clusters};
+    auto num_blocks = 0;
+
+    kax_cluster_walker_c{in, s_timecode_scale}
+      .set_block_handler([&num_blocks](kax_block_header_t const &) { ++num_blocks; })
+      .walk(0, clusters->get_size());
+
+    EXPECT_EQ(s_num_clusters * s_num_blocks, num_blocks);
+
+    return clusters->get_size();
+  });
+}
+
+}
@@ -0,0 +1,34 @@
+#include "common/common_pch.h"
+
+#include "tests/unit/benchmark/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Packetizers allocate and copy one buffer per frame. Sizes range
+// from subtitle entries to video frames.
+static size_t const s_sizes[] = { 16, 256, 4 * 1024, 64 * 1024 };
+
+TEST(Benchmark, MemoryAlloc) {
+  for (auto size : s_sizes)
+    mtxbench::measure((boost::format("memory_c::alloc(%1%)") % size).str(), [size]() -> uint64_t {
+      for (auto idx = 0; idx < 1000; ++idx)
+        memory_c::alloc(size);
+      return size * 1000;
+    });
+}
+
+TEST(Benchmark, MemoryClone) {
+  for (auto size : s_sizes) {
+    auto data = mtxbench::create_pseudo_random_data(size);
+
+    mtxbench::measure((boost::format("memory_c::clone(%1%)") % size).str(), [size, &data]() -> uint64_t {
+      for (auto idx = 0; idx < 1000; ++idx)
+        data->clone();
+      return size * 1000;
+    });
+  }
+}
+
+}
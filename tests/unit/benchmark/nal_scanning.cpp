@@ -0,0 +1,85 @@
+#include "common/common_pch.h"
+
+#include "common/byte_buffer.h"
+#include "common/hevc.h"
+#include "common/mpeg4_p10.h"
+#include "tests/unit/benchmark/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// An elementary stream consisting of filler data NAL units only. The
+// parsers skip them right after finding them so that the time is
+// spent on finding the start codes and on copying the NAL units.
+memory_cptr
+create_elementary_stream(std::vector<unsigned char> const &nalu_header) {
+  static unsigned char const s_start_code[] = { 0x00, 0x00, 0x00, 0x01 };
+
+  auto random = mtxbench::create_pseudo_random_data(64 * 1024);
+  auto ptr    = random->get_buffer();
+  auto offset = 0u;
+  byte_buffer_c stream;
+
+  while (stream.get_size() < 16 * 1024 * 1024) {
+    // Between 1000 and 52000 bytes taken from a varying position
+    auto size    = 1000 + ptr[offset] * 200;
+    offset       = (offset + 4099) % (random->get_size() - size);
+    auto payload = memory_c::clone(ptr + offset, size);
+
+    mpeg4::p10::rbsp_to_nalu(payload);
+
+    stream.add(s_start_code, sizeof(s_start_code));
+    stream.add(nalu_header.data(), nalu_header.size());
+    stream.add(payload);
+  }
+
+  return memory_c::clone(stream.get_buffer(), stream.get_size());
+}
+
+// Feeds the stream in chunks of the size readers use.
+template<typename ParserT>
+uint64_t
+parse_in_chunks(ParserT &parser,
+                memory_c const &stream) {
+  auto chunk_size = 64 * 1024u;
+  auto ptr        = stream.get_buffer();
+  auto size       = stream.get_size();
+
+  for (auto position = 0u; position < size; position += chunk_size)
+    parser.add_bytes(ptr + position, std::min<size_t>(chunk_size, size - position));
+
+  parser.flush();
+
+  return size;
+}
+
+TEST(Benchmark, AvcNaluScanning) {
+  auto stream = create_elementary_stream({ NALU_TYPE_FILLER_DATA });
+
+  mtxbench::measure("AVC ES parser, start code scanning", [&stream]() -> uint64_t {
+    mpeg4::p10::avc_es_parser_c parser;
+    return parse_in_chunks(parser, *stream);
+  });
+}
+
+TEST(Benchmark, HevcNaluScanning) {
+  auto stream = create_elementary_stream({ HEVC_NALU_TYPE_FILLER_DATA << 1, 0x01 });
+
+  mtxbench::measure("HEVC ES parser, start code scanning", [&stream]() -> uint64_t {
+    mtx::hevc::es_parser_c parser;
+    return parse_in_chunks(parser, *stream);
+  });
+}
+
+TEST(Benchmark, NaluToRbsp) {
+  auto stream = create_elementary_stream({ NALU_TYPE_FILLER_DATA });
+
+  mtxbench::measure("AVC NALU to RBSP conversion", [&stream]() -> uint64_t {
+    auto copy = stream->clone();
+    mpeg4::p10::nalu_to_rbsp(copy);
+    return stream->get_size();
+  });
+}
+
+}
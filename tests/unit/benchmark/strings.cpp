@@ -0,0 +1,45 @@
+#include "common/common_pch.h"
+
+#include "common/locale.h"
+#include "common/strings/utf8.h"
+#include "tests/unit/benchmark/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string
+create_ssa_lines(std::string const &text) {
+  auto lines = std::string{};
+  while (lines.size() < 16 * 1024 * 1024)
+    lines += "Dialogue: 0,0:00:01.00,0:00:02.00,Default,,0,0,0,," + text + "\n";
+
+  return lines;
+}
+
+TEST(Benchmark, StringsIsAscii) {
+  auto lines = create_ssa_lines("Hello world");
+
+  mtxbench::measure("is_ascii", [&lines]() -> uint64_t {
+    is_ascii(lines);
+    return lines.size();
+  });
+}
+
+TEST(Benchmark, StringsCharsetConversion) {
+  auto latin1 = charset_converter_c::init("ISO-8859-15");
+  auto ascii  = create_ssa_lines("Hello world");
+  auto utf8   = create_ssa_lines("Hello w\xc3\xb6rld");
+
+  mtxbench::measure("ISO-8859-15 to UTF-8, ASCII only", [&latin1, &ascii]() -> uint64_t {
+    latin1->utf8(ascii);
+    return ascii.size();
+  });
+
+  mtxbench::measure("UTF-8 to ISO-8859-15", [&latin1, &utf8]() -> uint64_t {
+    latin1->native(utf8);
+    return utf8.size();
+  });
+}
+
+}
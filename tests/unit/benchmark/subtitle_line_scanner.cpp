@@ -0,0 +1,63 @@
+#include "common/common_pch.h"
+
+#include "common/subtitle_line_scanner.h"
+#include "tests/unit/benchmark/util.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace mtx::subtitles;
+
+class BenchmarkSubtitleLineScanner: public ::testing::Test {
+public:
+  std::vector<std::string> m_lines;
+  uint64_t m_num_bytes;
+
+  BenchmarkSubtitleLineScanner()
+    : m_num_bytes{}
+  {
+    for (auto idx = 0; idx < 100000; ++idx) {
+      m_lines.push_back((boost::format("%|1$02d|:%|2$02d|:%|3$02d|,%|4$03d| --> %|1$02d|:%|2$02d|:%|5$02d|,%|4$03d|") % (idx / 3600 % 100) % (idx / 60 % 60) % (idx % 60) % (idx % 1000) % ((idx + 1) % 60)).str());
+      m_num_bytes += m_lines.back().size();
+    }
+  }
+
+  void
+  run(std::string const &name,
+      std::function<bool(std::string const &)> const &matcher) {
+    auto num_matches = m_lines.size();
+
+    mtxbench::measure(name, [this, &matcher, &num_matches]() -> uint64_t {
+      num_matches = 0;
+      for (auto const &line : m_lines)
+        if (matcher(line))
+          ++num_matches;
+
+      return m_num_bytes;
+    });
+
+    EXPECT_EQ(m_lines.size(), num_matches);
+  }
+};
+
+TEST_F(BenchmarkSubtitleLineScanner, SrtTimestampLinesRegex) {
+  boost::regex timecode_re("^\\s*(-?)\\s*(\\d+):\\s*(-?)\\s*(\\d+):\\s*(-?)\\s*(\\d+)[,\\.:]\\s*(-?)\\s*(\\d+)"
+                           "\\s*[\\-\\s]+>\\s*"
+                           "\\s*(-?)\\s*(\\d+):\\s*(-?)\\s*(\\d+):\\s*(-?)\\s*(\\d+)[,\\.:]\\s*(-?)\\s*(\\d+)\\s*",
+                           boost::regex::perl);
+
+  run("SRT timestamp lines: boost::regex", [&timecode_re](std::string const &line) -> bool {
+    boost::smatch matches;
+    return boost::regex_search(line, matches, timecode_re);
+  });
+}
+
+TEST_F(BenchmarkSubtitleLineScanner, SrtTimestampLinesScanner) {
+  run("SRT timestamp lines: scanner", [](std::string const &line) -> bool {
+    srt_timestamp_t start, end;
+    return parse_srt_timestamp_line(line, start, end);
+  });
+}
+
+}
@@ -0,0 +1,79 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   helper functions for benchmarks
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "common/fs_sys_helpers.h"
+#include "common/strings/parsing.h"
+#include "tests/unit/benchmark/util.h"
+
+namespace mtxbench {
+
+namespace {
+
+double
+get_min_duration() {
+  static auto s_min_duration = 0.0;
+
+  if (0.0 == s_min_duration) {
+    auto seconds = 0.0;
+    s_min_duration = parse_number(mtx::sys::get_environment_variable("MTX_BENCHMARK_SECONDS"), seconds) && (0.0 < seconds) ? seconds : 1.0;
+  }
+
+  return s_min_duration;
+}
+
+}
+
+void
+measure(std::string const &name,
+        std::function<uint64_t()> const &worker) {
+  // One call outside of the measurement for warming up caches and for
+  // lazily initialized tables.
+  worker();
+
+  auto min_duration = get_min_duration();
+  auto num_calls    = uint64_t{};
+  auto num_bytes    = uint64_t{};
+  auto start        = std::chrono::steady_clock::now();
+  auto seconds      = 0.0;
+
+  do {
+    num_bytes += worker();
+    ++num_calls;
+    seconds    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  } while (seconds < min_duration);
+
+  std::cout << boost::format("%1%: %|2$.1f| MB/s, %|3$.3f| ms per call (%4% calls)\n")
+    % name % (num_bytes / seconds / 1024 / 1024) % (seconds * 1000 / num_calls) % num_calls;
+}
+
+memory_cptr
+create_pseudo_random_data(size_t size,
+                          uint32_t seed) {
+  auto data  = memory_c::alloc(size);
+  auto ptr   = data->get_buffer();
+  auto value = seed;
+
+  for (auto idx = 0u; idx < size; ++idx) {
+    value    = value * 1103515245 + 12345;
+    ptr[idx] = value >> 16;
+  }
+
+  return data;
+}
+
+}
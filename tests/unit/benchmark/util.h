@@ -0,0 +1,32 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   definitions for helper functions for benchmarks
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_TESTS_UNIT_BENCHMARK_UTIL_H
+#define MTX_TESTS_UNIT_BENCHMARK_UTIL_H
+
+#include "common/common_pch.h"
+
+namespace mtxbench {
+
+// Calls 'worker' repeatedly for at least one second (or the number
+// of seconds in the environment variable MTX_BENCHMARK_SECONDS) and
+// outputs how many bytes per second it processed. 'worker' returns
+// the number of bytes it processed in one call.
+void measure(std::string const &name, std::function<uint64_t()> const &worker);
+
+// The same data for the same size and seed on all platforms.
+memory_cptr create_pseudo_random_data(size_t size, uint32_t seed = 0x12345678);
+
+}
+
+#endif // MTX_TESTS_UNIT_BENCHMARK_UTIL_H
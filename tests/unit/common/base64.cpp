@@ -0,0 +1,81 @@
+#include "common/common_pch.h"
+
+#include "common/base64.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string
+encode(std::string const &src,
+       bool line_breaks = false,
+       int max_line_len = 72) {
+  return base64_encode(reinterpret_cast<unsigned char const *>(src.data()), src.size(), line_breaks, max_line_len);
+}
+
+std::string
+make_data(size_t size) {
+  std::string data(size, '\0');
+  for (auto idx = 0u; idx < size; ++idx)
+    data[idx] = static_cast<char>(idx * 7 + idx / 251);
+  return data;
+}
+
+TEST(Base64, Encoding) {
+  EXPECT_EQ("",         encode(""));
+  EXPECT_EQ("Zg==",     encode("f"));
+  EXPECT_EQ("Zm8=",     encode("fo"));
+  EXPECT_EQ("Zm9v",     encode("foo"));
+  EXPECT_EQ("Zm9vYg==", encode("foob"));
+  EXPECT_EQ("Zm9vYmE=", encode("fooba"));
+  EXPECT_EQ("Zm9vYmFy", encode("foobar"));
+
+  EXPECT_EQ("Zm9vYmFyIGJhei4u", encode("foobar baz.."));
+  EXPECT_EQ("+/+/",             encode("\xfb\xff\xbf"));
+}
+
+TEST(Base64, EncodingWithLineBreaks) {
+  // A line break follows every complete line including the last one.
+  EXPECT_EQ("Zm9v\nYmFy\n",       encode("foobar",  true, 4));
+  EXPECT_EQ("Zm9v\nYmFy\nYg==\n", encode("foobarb", true, 7));
+  EXPECT_EQ("Zm9vYmFy\nYg==",     encode("foobarb", true, 8));
+
+  auto data    = make_data(1000);
+  auto encoded = encode(data, true, 72);
+  auto lines   = std::vector<std::string>{};
+  boost::split(lines, encoded, boost::is_any_of("\n"));
+
+  ASSERT_EQ(19u, lines.size());
+  for (auto idx = 0u; 18 > idx; ++idx)
+    EXPECT_EQ(72u, lines[idx].size());
+  EXPECT_EQ(40u, lines[18].size());
+}
+
+TEST(Base64, Decoding) {
+  EXPECT_EQ("",       base64_decode(""));
+  EXPECT_EQ("f",      base64_decode("Zg=="));
+  EXPECT_EQ("fo",     base64_decode("Zm8="));
+  EXPECT_EQ("foo",    base64_decode("Zm9v"));
+  EXPECT_EQ("foobar", base64_decode("Zm9vYmFy"));
+
+  // White space is ignored, decoding stops after the first padding.
+  EXPECT_EQ("foobar", base64_decode(" Zm9v\r\n\tYm Fy"));
+  EXPECT_EQ("fo",     base64_decode("Zm8=Zm9v"));
+}
+
+TEST(Base64, RoundTrip) {
+  for (auto size = 0u; 300 > size; ++size) {
+    auto data = make_data(size);
+    EXPECT_EQ(data, base64_decode(encode(data)));
+    EXPECT_EQ(data, base64_decode(boost::trim_right_copy(encode(data, true, 16))));
+  }
+}
+
+TEST(Base64, InvalidCharacters) {
+  EXPECT_THROW(base64_decode("Zm9v!mFy"),               mtx::base64::invalid_data_x);
+  EXPECT_THROW(base64_decode("Zm9vYmFy{"),              mtx::base64::invalid_data_x);
+  EXPECT_THROW(base64_decode("Zm9v-_"),                 mtx::base64::invalid_data_x);
+  EXPECT_THROW(base64_decode("Zm9vYmFyZm9vYmFy\xffm9v"), mtx::base64::invalid_data_x);
+}
+
+}
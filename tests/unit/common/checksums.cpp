@@ -2,7 +2,9 @@
 
 #include "gtest/gtest.h"
 
+#include "common/checksums/adler32.h"
 #include "common/checksums/base.h"
+#include "common/checksums/crc.h"
 #include "common/mm_io.h"
 #include "tests/unit/util.h"
 
@@ -66,6 +68,34 @@ public:
 
     return worker->get_result();
   }
+
+  static memory_cptr
+  create_pseudo_random_data(size_t size) {
+    auto data  = memory_c::alloc(size);
+    auto ptr   = data->get_buffer();
+    auto value = uint32_t{0x12345678};
+
+    for (auto idx = 0u; idx < size; ++idx) {
+      value    = value * 1103515245 + 12345;
+      ptr[idx] = value >> 16;
+    }
+
+    return data;
+  }
+
+  static uint32_t
+  crc32_ieee_le_bitwise(unsigned char const *buffer,
+                        size_t size) {
+    auto crc = uint32_t{0xffffffff};
+
+    for (auto idx = 0u; idx < size; ++idx) {
+      crc ^= buffer[idx];
+      for (auto bit = 0; bit < 8; ++bit)
+        crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+    }
+
+    return crc;
+  }
 };
 
 TEST_F(ChecksumTest, OneTwoThree) {
@@ -134,4 +164,61 @@ TEST_F(ChecksumTest, FileChunked1000) {
   EXPECT_EQ(*m_data_md5, *calculate_bin(mtx::checksum::algorithm_e::md5,                       1000));
 }
 
+TEST_F(ChecksumTest, AllSizesAndAlignments) {
+  auto data = create_pseudo_random_data(1024);
+  auto ptr  = data->get_buffer();
+
+  // Covers the byte-wise, slicing-by-8 and slicing-by-16 paths as
+  // well as the hardware paths and their remainders.
+  for (auto offset = 0u; offset < 16; ++offset)
+    for (auto size = 0u; (offset + size) <= 1000; size += (size < 200) ? 1 : 37)
+      EXPECT_EQ(crc32_ieee_le_bitwise(ptr + offset, size), mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::crc32_ieee_le, ptr + offset, size, 0xffffffff));
+}
+
+TEST_F(ChecksumTest, TableAndByteWiseResultsAreEqual) {
+  auto data = create_pseudo_random_data(300);
+  auto ptr  = data->get_buffer();
+
+  for (auto algorithm : { mtx::checksum::algorithm_e::crc8_atm, mtx::checksum::algorithm_e::crc16_ansi, mtx::checksum::algorithm_e::crc16_ccitt, mtx::checksum::algorithm_e::crc32_ieee, mtx::checksum::algorithm_e::crc32_ieee_le }) {
+    auto worker = mtx::checksum::for_algorithm(algorithm);
+    for (auto idx = 0u; idx < data->get_size(); ++idx)
+      worker->add(ptr + idx, 1);
+    worker->finish();
+
+    EXPECT_EQ(dynamic_cast<mtx::checksum::uint_result_c &>(*worker).get_result_as_uint(), mtx::checksum::calculate_as_uint(algorithm, *data));
+  }
+}
+
+TEST_F(ChecksumTest, Combine) {
+  auto data = create_pseudo_random_data(1000);
+  auto ptr  = data->get_buffer();
+
+  auto crc32 = [](unsigned char const *buffer, size_t size) {
+    return static_cast<uint32_t>(mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::crc32_ieee_le, buffer, size, 0xffffffff) ^ 0xffffffff);
+  };
+  auto adler32 = [](unsigned char const *buffer, size_t size) {
+    return static_cast<uint32_t>(mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::adler32, buffer, size));
+  };
+
+  for (auto split : { 0u, 1u, 7u, 500u, 999u, 1000u }) {
+    EXPECT_EQ(crc32(ptr, 1000),   mtx::checksum::combine_crc32_ieee_le(crc32(ptr, split), crc32(ptr + split, 1000 - split), 1000 - split));
+    EXPECT_EQ(adler32(ptr, 1000), mtx::checksum::combine_adler32(adler32(ptr, split), adler32(ptr + split, 1000 - split), 1000 - split));
+  }
+}
+
+TEST_F(ChecksumTest, Adler32LongRuns) {
+  // More bytes with the maximum value than can be summed up without
+  // reducing in between.
+  auto data = memory_c::alloc(20000);
+  std::memset(data->get_buffer(), 0xff, data->get_size());
+
+  auto a = uint32_t{1}, b = uint32_t{0};
+  for (auto idx = 0u; idx < data->get_size(); ++idx) {
+    a = (a + 0xff) % 65521;
+    b = (b + a)    % 65521;
+  }
+
+  EXPECT_EQ((b << 16) | a, mtx::checksum::calculate_as_uint(mtx::checksum::algorithm_e::adler32, *data));
+}
+
 }
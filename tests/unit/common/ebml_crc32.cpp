@@ -0,0 +1,88 @@
+#include "common/common_pch.h"
+
+#include <ebml/EbmlCrc32.h>
+#include <matroska/KaxInfo.h>
+#include <matroska/KaxInfoData.h>
+
+#include "gtest/gtest.h"
+
+#include "common/ebml.h"
+#include "common/ebml_crc32.h"
+#include "common/mm_io.h"
+
+using namespace libmatroska;
+
+namespace {
+
+std::unique_ptr<KaxInfo>
+create_info() {
+  auto info = std::make_unique<KaxInfo>();
+
+  GetChild<KaxTimecodeScale>(*info).SetValue(1000000);
+  GetChild<KaxMuxingApp>(*info).SetValueUTF8("unit test");
+  GetChild<KaxWritingApp>(*info).SetValueUTF8("unit test");
+
+  return info;
+}
+
+TEST(EbmlCrc32, NotPresent) {
+  auto info = create_info();
+  mm_mem_io_c out{nullptr, 0, 1024};
+
+  info->Render(out, true);
+
+  auto check = verify_ebml_crc32(out, 0);
+
+  EXPECT_FALSE(check.present);
+  EXPECT_FALSE(check.valid);
+}
+
+TEST(EbmlCrc32, RenderAndVerify) {
+  auto info = create_info();
+  mm_mem_io_c out{nullptr, 0, 1024};
+
+  // Don't start at position 0 so that the positions stored during
+  // rendering are checked as well.
+  out.write("abc", 3);
+
+  render_with_ebml_crc32(*info, out, [&info](mm_io_c &buffer) { info->Render(buffer, true); });
+
+  ASSERT_EQ(3 + info->ElementSize(true), out.getFilePointer());
+  EXPECT_EQ(3u, info->GetElementPosition());
+  ASSERT_TRUE(Is<EbmlCrc32>((*info)[0]));
+
+  out.setFilePointer(17);
+
+  auto check = verify_ebml_crc32(out, 3);
+
+  EXPECT_EQ(17u, out.getFilePointer());
+  EXPECT_TRUE(check.present);
+  EXPECT_TRUE(check.valid);
+  EXPECT_EQ(check.stored, check.calculated);
+  EXPECT_EQ(static_cast<EbmlCrc32 *>((*info)[0])->GetCrc32(), check.stored);
+  EXPECT_EQ(3 + info->HeadSize() + 6, check.start);
+  EXPECT_EQ(3 + info->ElementSize(true), check.end);
+}
+
+TEST(EbmlCrc32, CorruptedByte) {
+  auto info = create_info();
+  mm_mem_io_c out{nullptr, 0, 1024};
+
+  render_with_ebml_crc32(*info, out, [&info](mm_io_c &buffer) { info->Render(buffer, true); });
+
+  auto check = verify_ebml_crc32(out, 0);
+  ASSERT_TRUE(check.valid);
+
+  out.get_buffer()[check.end - 2] ^= 0x01;
+
+  auto corrupted_check = verify_ebml_crc32(out, 0);
+
+  EXPECT_TRUE(corrupted_check.present);
+  EXPECT_FALSE(corrupted_check.valid);
+  EXPECT_EQ(check.stored, corrupted_check.stored);
+  EXPECT_NE(corrupted_check.stored, corrupted_check.calculated);
+  EXPECT_EQ(check.start, corrupted_check.start);
+  EXPECT_EQ(check.end,   corrupted_check.end);
+}
+
+}
@@ -0,0 +1,131 @@
+#include "common/common_pch.h"
+
+#include <ebml/EbmlHead.h>
+#include <ebml/EbmlVoid.h>
+#include <matroska/KaxInfo.h>
+#include <matroska/KaxInfoData.h>
+#include <matroska/KaxSeekHead.h>
+#include <matroska/KaxSegment.h>
+#include <matroska/KaxTag.h>
+#include <matroska/KaxTags.h>
+
+#include "gtest/gtest.h"
+
+#include "common/ebml.h"
+#include "common/kax_analyzer.h"
+#include "common/mm_io.h"
+
+using namespace libmatroska;
+
+namespace {
+
+// A cluster with a size of three bytes containing only its timecode.
+unsigned char const s_cluster[] = { 0x1f, 0x43, 0xb6, 0x75, 0x83, 0xe7, 0x81, 0x00 };
+
+ebml_element_cptr
+create_tags(std::string const &title) {
+  auto tags    = std::make_shared<KaxTags>();
+  auto &tag    = GetChild<KaxTag>(*tags);
+  auto &simple = GetChild<KaxTagSimple>(tag);
+
+  GetChild<KaxTagTargets>(tag);
+  GetChild<KaxTagName>(simple).SetValueUTF8("TITLE");
+  GetChild<KaxTagString>(simple).SetValueUTF8(title);
+
+  return tags;
+}
+
+// Writes a file consisting of a seek head, the segment info, tags,
+// optional padding after the tags and a single cluster.
+uint64_t
+create_file(mm_io_c &out,
+            int64_t tags_padding) {
+  EbmlHead head;
+  GetChild<EDocType>(head).SetValue("matroska");
+  GetChild<EDocTypeVersion>(head).SetValue(4);
+  GetChild<EDocTypeReadVersion>(head).SetValue(2);
+  head.Render(out, true);
+
+  KaxSegment segment;
+  segment.WriteHead(out, 8);
+
+  EbmlVoid seek_head_placeholder;
+  seek_head_placeholder.SetSize(200);
+  seek_head_placeholder.Render(out);
+
+  KaxInfo info;
+  GetChild<KaxTimecodeScale>(info).SetValue(1000000);
+  GetChild<KaxMuxingApp>(info).SetValueUTF8("unit test");
+  GetChild<KaxWritingApp>(info).SetValueUTF8("unit test");
+  info.Render(out, true);
+
+  auto tags          = create_tags("short");
+  auto tags_position = out.getFilePointer();
+  tags->Render(out, true);
+
+  if (tags_padding) {
+    EbmlVoid padding;
+    padding.SetSize(tags_padding);
+    padding.Render(out);
+  }
+
+  out.write(s_cluster, sizeof(s_cluster));
+
+  KaxSeekHead seek_head;
+  seek_head.IndexThis(info,  segment);
+  seek_head.IndexThis(*tags, segment);
+  seek_head_placeholder.ReplaceWith(seek_head, out, true, true);
+
+  segment.ForceSize(out.getFilePointer() - segment.GetElementPosition() - segment.HeadSize());
+  segment.OverwriteHead(out);
+
+  return tags_position;
+}
+
+std::vector<uint64_t>
+find_positions(kax_analyzer_c const &analyzer,
+               EbmlId const &id) {
+  std::vector<uint64_t> positions;
+  analyzer.with_elements(id, [&positions](kax_analyzer_data_c const &data) { positions.push_back(data.m_pos); });
+
+  return positions;
+}
+
+TEST(KaxAnalyzer, TagsReusePaddedPreviousPosition) {
+  mm_mem_io_c out{nullptr, 0, 1024};
+  auto tags_position = create_file(out, 100);
+  auto file_size     = out.get_size();
+
+  kax_analyzer_c analyzer{&out};
+  ASSERT_TRUE(analyzer.process());
+
+  auto cluster_positions = find_positions(analyzer, EBML_ID(KaxCluster));
+  ASSERT_EQ(1u, cluster_positions.size());
+
+  EXPECT_EQ(kax_analyzer_c::uer_success, analyzer.update_element(create_tags("a title that is quite a bit longer than before"), true));
+
+  auto tags_positions = find_positions(analyzer, EBML_ID(KaxTags));
+  ASSERT_EQ(1u, tags_positions.size());
+  EXPECT_EQ(tags_position, tags_positions[0]);
+  EXPECT_EQ(cluster_positions, find_positions(analyzer, EBML_ID(KaxCluster)));
+  EXPECT_EQ(file_size, out.get_size());
+}
+
+TEST(KaxAnalyzer, TagsWithoutPaddingAreMovedToTheEnd) {
+  mm_mem_io_c out{nullptr, 0, 1024};
+  create_file(out, 0);
+
+  kax_analyzer_c analyzer{&out};
+  ASSERT_TRUE(analyzer.process());
+
+  EXPECT_EQ(kax_analyzer_c::uer_success, analyzer.update_element(create_tags("tiny"), true));
+
+  auto cluster_positions = find_positions(analyzer, EBML_ID(KaxCluster));
+  auto tags_positions    = find_positions(analyzer, EBML_ID(KaxTags));
+
+  ASSERT_EQ(1u, cluster_positions.size());
+  ASSERT_EQ(1u, tags_positions.size());
+  EXPECT_GT(tags_positions[0], cluster_positions[0]);
+}
+
+}
@@ -0,0 +1,105 @@
+#include "common/common_pch.h"
+
+#include "gtest/gtest.h"
+
+#include "common/kax_cluster_walker.h"
+#include "common/mm_io.h"
+
+namespace {
+
+unsigned char const s_clusters[] = {
+  // Cluster with a known size, timecode 100
+  0x1f, 0x43, 0xb6, 0x75, 0xa1,
+  0xe7, 0x81, 0x64,
+  // SimpleBlock, track 1, relative timecode 5, key frame, no lacing
+  0xa3, 0x87, 0x81, 0x00, 0x05, 0x80, 0xaa, 0xbb, 0xcc,
+  // BlockGroup: Block for track 2 with Xiph lacing, BlockDuration 20, ReferenceBlock -5
+  0xa0, 0x93,
+  0xa1, 0x8b, 0x82, 0x00, 0x0a, 0x02, 0x01, 0x02, 0x01, 0x02, 0x03, 0x04, 0x05,
+  0x9b, 0x81, 0x14,
+  0xfb, 0x81, 0xfb,
+
+  // Cluster with an unknown size, timecode 200
+  0x1f, 0x43, 0xb6, 0x75, 0xff,
+  0xe7, 0x81, 0xc8,
+  // SimpleBlock, track 1, relative timecode -2, EBML lacing with three frames
+  0xa3, 0x91, 0x81, 0xff, 0xfe, 0x06, 0x02, 0x84, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+  // Empty Cues ending the unknown-sized cluster
+  0x1c, 0x53, 0xbb, 0x6b, 0x80,
+};
+
+TEST(KaxClusterWalker, WalkBlockHeaders) {
+  mm_mem_io_c in{s_clusters, sizeof(s_clusters)};
+  kax_cluster_walker_c walker{in, 1000000};
+
+  std::vector<std::pair<uint64_t, int64_t> > clusters;
+  std::vector<kax_block_header_t> blocks;
+
+  walker
+    .set_cluster_handler([&clusters](uint64_t position, int64_t timecode) -> bool { clusters.emplace_back(position, timecode); return true; })
+    .set_block_handler([&blocks](kax_block_header_t const &block) { blocks.push_back(block); });
+
+  ASSERT_TRUE(walker.walk(0, sizeof(s_clusters)));
+
+  ASSERT_EQ(2u, clusters.size());
+  EXPECT_EQ(0u,         clusters[0].first);
+  EXPECT_EQ(100000000,  clusters[0].second);
+  EXPECT_EQ(38u,        clusters[1].first);
+  EXPECT_EQ(200000000,  clusters[1].second);
+
+  ASSERT_EQ(3u, blocks.size());
+
+  EXPECT_TRUE(blocks[0].is_simple_block);
+  EXPECT_TRUE(blocks[0].keyframe);
+  EXPECT_EQ(1u,         blocks[0].track_number);
+  EXPECT_EQ(105000000,  blocks[0].timecode);
+  EXPECT_EQ(14u,        blocks[0].data_position);
+  EXPECT_EQ(std::vector<uint64_t>({ 3 }), blocks[0].frame_sizes);
+
+  EXPECT_FALSE(blocks[1].is_simple_block);
+  EXPECT_FALSE(blocks[1].keyframe);
+  EXPECT_EQ(2u,         blocks[1].track_number);
+  EXPECT_EQ(110000000,  blocks[1].timecode);
+  EXPECT_EQ(1u,         blocks[1].num_references);
+  ASSERT_TRUE(!!blocks[1].duration);
+  EXPECT_EQ(20000000,   *blocks[1].duration);
+  EXPECT_EQ(std::vector<uint64_t>({ 2, 3 }), blocks[1].frame_sizes);
+
+  EXPECT_EQ(198000000,  blocks[2].timecode);
+  EXPECT_EQ(55u,        blocks[2].data_position);
+  EXPECT_EQ(std::vector<uint64_t>({ 4, 5, 1 }), blocks[2].frame_sizes);
+}
+
+TEST(KaxClusterWalker, StopAtCluster) {
+  mm_mem_io_c in{s_clusters, sizeof(s_clusters)};
+  kax_cluster_walker_c walker{in, 1000000};
+
+  auto num_blocks = 0u;
+
+  walker
+    .set_cluster_handler([](uint64_t, int64_t timecode) { return timecode < 150000000; })
+    .set_block_handler([&num_blocks](kax_block_header_t const &) { ++num_blocks; });
+
+  ASSERT_TRUE(walker.walk(0, sizeof(s_clusters)));
+  EXPECT_EQ(2u, num_blocks);
+}
+
+TEST(KaxClusterWalker, ReadElementHeader) {
+  mm_mem_io_c in{s_clusters, sizeof(s_clusters)};
+  kax_cluster_walker_c walker{in, 1000000};
+  kax_cluster_walker_c::element_header_t header;
+
+  ASSERT_TRUE(walker.read_element_header(0, header));
+  EXPECT_EQ(0x1f43b675u, header.id);
+  EXPECT_EQ(33u,         header.size);
+  EXPECT_EQ(5u,          header.head_size);
+  EXPECT_FALSE(header.unknown_size);
+
+  ASSERT_TRUE(walker.read_element_header(38, header));
+  EXPECT_TRUE(header.unknown_size);
+
+  EXPECT_FALSE(walker.read_element_header(sizeof(s_clusters), header));
+}
+
+}
@@ -16,4 +16,32 @@ TEST(MmIo, Slurp) {
   ASSERT_THROW(mm_file_io_c::slurp("doesnotexist"), mtx::mm_io::exception);
 }
 
+TEST(MmIo, TextLinesUtf8) {
+  std::string content{"\xef\xbb\xbf" "one\r\n" "two \xe2\x82\xac\r\n" "\r\n" "three"};
+  mm_text_io_c in(new mm_mem_io_c(reinterpret_cast<unsigned char const *>(content.c_str()), content.length()));
+
+  EXPECT_EQ(BO_UTF8, in.get_byte_order());
+  EXPECT_EQ("one",              in.getline());
+  EXPECT_EQ("two \xe2\x82\xac", in.getline());
+  EXPECT_EQ("",                 in.getline());
+  EXPECT_EQ("three",            in.getline());
+  EXPECT_TRUE(in.eof());
+
+  in.setFilePointer(0);
+  EXPECT_EQ(3u,    in.getFilePointer());
+  EXPECT_EQ("one", in.getline());
+}
+
+TEST(MmIo, TextLinesUtf16) {
+  // "a\r" "b\xe2\x82\xac\r" "U+1F600" in UTF-16LE with carriage returns only
+  std::string content{"\xff\xfe" "a\0\r\0" "b\0\xac\x20\r\0" "\x3d\xd8\x00\xde", 16};
+  mm_text_io_c in(new mm_mem_io_c(reinterpret_cast<unsigned char const *>(content.c_str()), content.length()));
+
+  EXPECT_EQ(BO_UTF16_LE,            in.get_byte_order());
+  EXPECT_EQ("a",                    in.getline());
+  EXPECT_EQ("b\xe2\x82\xac",        in.getline());
+  EXPECT_EQ("\xf0\x9f\x98\x80",     in.getline());
+  EXPECT_TRUE(in.eof());
+}
+
 }
@@ -0,0 +1,82 @@
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+#include "common/mm_io_statistics.h"
+#include "common/mm_read_buffer_io.h"
+#include "common/mm_write_buffer_io.h"
+#include "common/profiling.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(MmIoStatistics, ReadBuffer) {
+  g_profiler.enable();
+
+  unsigned char data[64];
+  for (auto idx = 0u; idx < sizeof(data); ++idx)
+    data[idx] = idx;
+
+  mm_read_buffer_io_c in{new mm_mem_io_c{data, sizeof(data)}, 16};
+  unsigned char buffer[16];
+
+  auto statistics = in.get_statistics();
+  ASSERT_NE(nullptr, statistics);
+
+  EXPECT_EQ(4u,  in.read(buffer, 4));  // miss: fills the buffer with 0-15
+  EXPECT_EQ(4u,  in.read(buffer, 4));  // hit
+  EXPECT_EQ(10u, in.read(buffer, 10)); // miss: refill with 16-31
+  EXPECT_EQ(8,   buffer[0]);
+  EXPECT_EQ(17,  buffer[9]);
+
+  in.setFilePointer(20);               // within the buffer
+  EXPECT_EQ(4u,  in.read(buffer, 4));  // hit
+  EXPECT_EQ(20,  buffer[0]);
+
+  in.setFilePointer(48);               // outside the buffer
+  EXPECT_EQ(8u,  in.read(buffer, 8));  // miss
+  EXPECT_EQ(48,  buffer[0]);
+
+  EXPECT_EQ(5u,  statistics->m_num_reads);
+  EXPECT_EQ(30u, statistics->m_num_bytes_read);
+  EXPECT_EQ(2u,  statistics->m_num_seeks);
+  EXPECT_EQ(26u, statistics->m_seek_distance);
+  EXPECT_EQ(2u,  statistics->m_num_buffer_hits);
+  EXPECT_EQ(3u,  statistics->m_num_buffer_misses);
+  EXPECT_EQ(0u,  statistics->m_num_writes);
+}
+
+TEST(MmIoStatistics, WriteBuffer) {
+  g_profiler.enable();
+
+  mm_mem_io_c mem{nullptr, 0, 1024};
+  mm_write_buffer_io_c out{&mem, 16, false};
+  unsigned char data[40];
+  for (auto idx = 0u; idx < sizeof(data); ++idx)
+    data[idx] = idx;
+
+  auto statistics = out.get_statistics();
+  ASSERT_NE(nullptr, statistics);
+
+  out.write(data, 4);                  // hit
+  out.write(data, 8);                  // hit
+  out.write(data, 10);                 // miss: fills and flushes the buffer
+  EXPECT_EQ(22u, out.getFilePointer());
+
+  out.setFilePointer(0);
+  out.write(data, 40);                 // miss: two blocks bypass the buffer
+  out.flush();
+
+  EXPECT_EQ(4u,  statistics->m_num_writes);
+  EXPECT_EQ(62u, statistics->m_num_bytes_written);
+  EXPECT_EQ(1u,  statistics->m_num_seeks);
+  EXPECT_EQ(22u, statistics->m_seek_distance);
+  EXPECT_EQ(2u,  statistics->m_num_buffer_hits);
+  EXPECT_EQ(2u,  statistics->m_num_buffer_misses);
+  EXPECT_EQ(0u,  statistics->m_num_reads);
+
+  EXPECT_EQ(40u, mem.get_size());
+  EXPECT_EQ(0,   memcmp(mem.get_buffer(), data, 40));
+}
+
+}
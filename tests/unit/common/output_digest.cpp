@@ -0,0 +1,119 @@
+#include "common/common_pch.h"
+
+#include "gtest/gtest.h"
+
+#include "common/checksums/base.h"
+#include "common/mm_io.h"
+#include "common/mm_write_buffer_io.h"
+#include "common/output_digest.h"
+#include "common/strings/formatting.h"
+
+namespace {
+
+memory_cptr
+create_data(size_t size) {
+  auto data  = memory_c::alloc(size);
+  auto ptr   = data->get_buffer();
+  auto value = uint32_t{0x87654321};
+
+  for (auto idx = 0u; idx < size; ++idx) {
+    value    = value * 1103515245 + 12345;
+    ptr[idx] = value >> 16;
+  }
+
+  return data;
+}
+
+std::string
+calculate_directly(mtx::checksum::algorithm_e algorithm,
+                   memory_c const &data) {
+  if (mtx::checksum::algorithm_e::md5 == algorithm)
+    return to_hex(mtx::checksum::calculate(algorithm, data), true);
+
+  auto value = mtx::checksum::calculate_as_uint(algorithm, data, mtx::checksum::algorithm_e::crc32_ieee_le == algorithm ? 0xffffffff : 0);
+  if (mtx::checksum::algorithm_e::crc32_ieee_le == algorithm)
+    value ^= 0xffffffff;
+
+  return (boost::format("%|1$08x|") % value).str();
+}
+
+// Writes the data in small pieces, patches some bytes in the first
+// and in a later block and appends more data afterwards, similar to
+// what mkvmerge does with its headers. If 'patch_while_writing' is set
+// then a block before the one currently being written is patched in
+// its middle before writing continues.
+std::pair<std::string, std::string>
+write_with_patches(mtx::checksum::algorithm_e algorithm,
+                   bool patch,
+                   bool patch_while_writing = false) {
+  auto data = create_data(9 * 1024 * 1024 + 123);
+  auto mem  = std::make_unique<mm_mem_io_c>(nullptr, 0, 1024 * 1024);
+  mm_write_buffer_io_c out{mem.get(), 64 * 1024, false};
+
+  out.enable_digest(algorithm);
+
+  auto ptr  = data->get_buffer();
+  auto size = data->get_size();
+
+  for (auto position = 0u; position < size; position += 100000) {
+    out.write(ptr + position, std::min<size_t>(100000, size - position));
+
+    if (!patch_while_writing || (position != 6 * 1000 * 1000))
+      continue;
+
+    auto patch_position = 1024 * 1024 + 4321u;
+    ptr[patch_position] ^= 0xa5;
+
+    out.setFilePointer(patch_position);
+    out.write(ptr + patch_position, 3);
+    out.setFilePointer(position + std::min<size_t>(100000, size - position));
+  }
+
+  if (patch) {
+    for (auto position : { 10u, 5 * 1024 * 1024 + 17u }) {
+      ptr[position] ^= 0x5a;
+      out.setFilePointer(position);
+      out.write(ptr + position, 1);
+    }
+
+    out.setFilePointer(size);
+  }
+
+  auto digest = out.finish_digest();
+  out.flush();
+
+  return std::make_pair(digest, calculate_directly(algorithm, memory_c{mem->get_buffer(), static_cast<size_t>(mem->get_size()), false}));
+}
+
+TEST(OutputDigest, SequentialWriting) {
+  for (auto algorithm : { mtx::checksum::algorithm_e::md5, mtx::checksum::algorithm_e::crc32_ieee_le, mtx::checksum::algorithm_e::adler32 }) {
+    auto result = write_with_patches(algorithm, false);
+    EXPECT_EQ(result.second, result.first);
+  }
+}
+
+TEST(OutputDigest, WritingWithPatches) {
+  for (auto algorithm : { mtx::checksum::algorithm_e::md5, mtx::checksum::algorithm_e::crc32_ieee_le, mtx::checksum::algorithm_e::adler32 }) {
+    auto result = write_with_patches(algorithm, true);
+    EXPECT_EQ(result.second, result.first);
+  }
+}
+
+TEST(OutputDigest, PatchingEarlierBlockWhileWriting) {
+  for (auto algorithm : { mtx::checksum::algorithm_e::md5, mtx::checksum::algorithm_e::crc32_ieee_le, mtx::checksum::algorithm_e::adler32 }) {
+    auto result = write_with_patches(algorithm, false, true);
+    EXPECT_EQ(result.second, result.first);
+  }
+}
+
+TEST(OutputDigest, ParseAlgorithm) {
+  auto algorithm = mtx::checksum::algorithm_e::md5;
+
+  EXPECT_TRUE(output_digest_c::parse_algorithm("CRC32", algorithm));
+  EXPECT_TRUE(mtx::checksum::algorithm_e::crc32_ieee_le == algorithm);
+  EXPECT_TRUE(output_digest_c::parse_algorithm("adler32", algorithm));
+  EXPECT_TRUE(mtx::checksum::algorithm_e::adler32 == algorithm);
+  EXPECT_FALSE(output_digest_c::parse_algorithm("sha1", algorithm));
+}
+
+}
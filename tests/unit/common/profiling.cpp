@@ -0,0 +1,71 @@
+#include "common/common_pch.h"
+
+#include <thread>
+
+#include "common/profiling.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace mtx::profiling;
+
+TEST(Profiling, DisabledByDefault) {
+  profiler_c profiler;
+
+  EXPECT_FALSE(profiler.is_enabled());
+  EXPECT_EQ(nullptr, profiler.get_stage("reading"));
+
+  profiler.add_to_counter("seeks");
+  EXPECT_TRUE(profiler.to_json()["counters"].empty());
+}
+
+TEST(Profiling, StagesAndCounters) {
+  profiler_c profiler;
+  profiler.enable();
+
+  auto reading = profiler.get_stage("reading");
+  auto writing = profiler.get_stage("writing");
+
+  ASSERT_NE(nullptr, reading);
+  ASSERT_NE(nullptr, writing);
+  EXPECT_EQ(reading, profiler.get_stage("reading"));
+
+  reading->add_data(100);
+  reading->add_data(50, 2);
+
+  profiler.add_to_counter("seeks");
+  profiler.add_to_counter("seeks", 2);
+  profiler.add_to_counter("flushes");
+
+  auto json = profiler.to_json();
+
+  ASSERT_EQ(2u, json["stages"].size());
+  EXPECT_EQ("reading",  json["stages"][0]["name"].get<std::string>());
+  EXPECT_EQ(150u,       json["stages"][0]["bytes"].get<uint64_t>());
+  EXPECT_EQ(3u,         json["stages"][0]["packets"].get<uint64_t>());
+  EXPECT_EQ("writing",  json["stages"][1]["name"].get<std::string>());
+  EXPECT_EQ(3u,         json["counters"]["seeks"].get<uint64_t>());
+  EXPECT_EQ(1u,         json["counters"]["flushes"].get<uint64_t>());
+}
+
+TEST(Profiling, ExclusiveTimes) {
+  profiler_c profiler;
+  profiler.enable();
+
+  auto outer = profiler.get_stage("outer");
+  auto inner = profiler.get_stage("inner");
+
+  profiler.start(*outer);
+  profiler.start(*inner);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  profiler.stop();
+  profiler.stop();
+
+  EXPECT_EQ(1u, outer->m_num_calls);
+  EXPECT_EQ(1u, inner->m_num_calls);
+  EXPECT_GE(inner->m_num_nanoseconds, 20000000u);
+  EXPECT_LT(outer->m_num_nanoseconds, inner->m_num_nanoseconds);
+}
+
+}
@@ -0,0 +1,51 @@
+#include "common/common_pch.h"
+
+#include "common/locale.h"
+#include "common/strings/utf8.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(StringsUtf8, IsAscii) {
+  EXPECT_TRUE(is_ascii(""));
+  EXPECT_TRUE(is_ascii("Hello world"));
+  EXPECT_TRUE(is_ascii(std::string(1000, '\x7f')));
+
+  EXPECT_FALSE(is_ascii("Hello w\xc3\xb6rld"));
+  EXPECT_FALSE(is_ascii(std::string(100, 'a') + "\x80"));
+  EXPECT_FALSE(is_ascii("\xff" + std::string(100, 'a')));
+}
+
+TEST(StringsUtf8, Conversion) {
+  EXPECT_EQ(L"Hello world",                    to_wide("Hello world"));
+  EXPECT_EQ(L"Hello w\u00f6rld \u20ac",        to_wide("Hello w\xc3\xb6rld \xe2\x82\xac"));
+  EXPECT_EQ("Hello w\xc3\xb6rld \xe2\x82\xac", to_utf8(std::wstring{L"Hello w\u00f6rld \u20ac"}));
+
+  auto text = std::string(1000, 'x') + "\xc3\xb6";
+  EXPECT_EQ(text, to_utf8(to_wide(text)));
+}
+
+TEST(StringsUtf8, CharsetConverterAsciiPassthrough) {
+  auto latin1 = charset_converter_c::init("ISO-8859-15");
+
+  EXPECT_EQ("Hello world",        latin1->utf8("Hello world"));
+  EXPECT_EQ("Hello w\xc3\xb6rld", latin1->utf8("Hello w\xf6rld"));
+  EXPECT_EQ("Hello w\xf6rld",     latin1->native("Hello w\xc3\xb6rld"));
+}
+
+TEST(StringsUtf8, CharsetConverterStatefulEncoding) {
+  auto jis = charset_converter_c::init("ISO-2022-JP");
+
+  // Plain ASCII is the same in ISO-2022-JP.
+  EXPECT_EQ("abc", jis->utf8("abc"));
+  EXPECT_EQ("abc", jis->native("abc"));
+
+  // ASCII strings with shift sequences must not be passed through.
+  EXPECT_EQ("\xe4\xba\x9c",          jis->utf8("\x1b$B\x30\x21\x1b(B"));
+  EXPECT_EQ("a\xe4\xba\x9c" "b",     jis->utf8("a\x1b$B\x30\x21\x1b(Bb"));
+  EXPECT_EQ("a\x1b$B\x30\x21\x1b(Bb", jis->native("a\xe4\xba\x9c" "b"));
+  EXPECT_EQ("a\x1b$B\x30\x21\x1b(Bb", jis->native(jis->utf8("a\x1b$B\x30\x21\x1b(Bb")));
+}
+
+}
@@ -0,0 +1,93 @@
+#include "common/common_pch.h"
+
+#include "common/subtitle_line_scanner.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace mtx::subtitles;
+
+TEST(SubtitleLineScanner, SrtNumbers) {
+  EXPECT_TRUE(is_srt_number("1"));
+  EXPECT_TRUE(is_srt_number("0123456789"));
+
+  EXPECT_FALSE(is_srt_number(""));
+  EXPECT_FALSE(is_srt_number(" 1"));
+  EXPECT_FALSE(is_srt_number("1 "));
+  EXPECT_FALSE(is_srt_number("-1"));
+  EXPECT_FALSE(is_srt_number("1a"));
+}
+
+TEST(SubtitleLineScanner, SrtTimestampLines) {
+  srt_timestamp_t start, end;
+
+  ASSERT_TRUE(parse_srt_timestamp_line("00:01:02,345 --> 01:02:03,456", start, end));
+  EXPECT_FALSE(start.negative);
+  EXPECT_EQ(0,         start.hours);
+  EXPECT_EQ(1,         start.minutes);
+  EXPECT_EQ(2,         start.seconds);
+  EXPECT_EQ(345000000, start.nanoseconds);
+  EXPECT_EQ(1,         end.hours);
+  EXPECT_EQ(2,         end.minutes);
+  EXPECT_EQ(3,         end.seconds);
+  EXPECT_EQ(456000000, end.nanoseconds);
+
+  // Shortened components, other decimal separators and spaces
+  ASSERT_TRUE(parse_srt_timestamp_line("0:0:1.5-->0:0:2:25", start, end));
+  EXPECT_EQ(1,         start.seconds);
+  EXPECT_EQ(500000000, start.nanoseconds);
+  EXPECT_EQ(2,         end.seconds);
+  EXPECT_EQ(250000000, end.nanoseconds);
+
+  EXPECT_FALSE(parse_srt_timestamp_line(" 00: 00: 01, 000 - - > 00 :00:02,000", start, end));
+  ASSERT_TRUE(parse_srt_timestamp_line(" 00: 00: 01, 000 - - > 00: 00: 02, 000", start, end));
+  EXPECT_EQ(1, start.seconds);
+  EXPECT_EQ(2, end.seconds);
+
+  // More than nine fractional digits are cut off.
+  ASSERT_TRUE(parse_srt_timestamp_line("00:00:01,1234567891 --> 00:00:02,000", start, end));
+  EXPECT_EQ(123456789, start.nanoseconds);
+
+  // Each minus sign flips the sign.
+  ASSERT_TRUE(parse_srt_timestamp_line("-00:00:01,000 --> 00:-00:-02,000", start, end));
+  EXPECT_TRUE(start.negative);
+  EXPECT_FALSE(end.negative);
+
+  // Anything may follow the end timestamp.
+  EXPECT_TRUE(parse_srt_timestamp_line("00:00:01,000 --> 00:00:02,000 X1:2 X3:4 Y5:6 Y7:8", start, end));
+
+  EXPECT_FALSE(parse_srt_timestamp_line("",                                start, end));
+  EXPECT_FALSE(parse_srt_timestamp_line("00:00:01,000 -> ",                start, end));
+  EXPECT_FALSE(parse_srt_timestamp_line("00:00:01,000 00:00:02,000",       start, end));
+  EXPECT_FALSE(parse_srt_timestamp_line("00:00:01 --> 00:00:02",           start, end));
+  EXPECT_FALSE(parse_srt_timestamp_line("x 00:00:01,000 --> 00:00:02,000", start, end));
+}
+
+TEST(SubtitleLineScanner, SrtCoordinates) {
+  EXPECT_TRUE(has_srt_coordinates("00:00:01,000 --> 00:00:02,000 X1:2 X3:4 Y5:6 Y7:8"));
+  EXPECT_TRUE(has_srt_coordinates("X1:2X3:4Y5:6Y7:8  "));
+
+  EXPECT_FALSE(has_srt_coordinates("00:00:01,000 --> 00:00:02,000 X1:2 X3:4 Y5:6"));
+  EXPECT_FALSE(has_srt_coordinates("X1:2 X3:4 Y5:6 Y7:8 x"));
+  EXPECT_FALSE(has_srt_coordinates("x1:2 X3:4 Y5:6 Y7:8"));
+}
+
+TEST(SubtitleLineScanner, SsaLines) {
+  EXPECT_TRUE(is_ssa_section_header("[Script Info]",          "[script info]"));
+  EXPECT_TRUE(is_ssa_section_header(" \t[SCRIPT \t INFO] foo", "[script info]"));
+  EXPECT_TRUE(is_ssa_section_header("[V4+ Styles]",           "[v4+ styles]"));
+
+  EXPECT_FALSE(is_ssa_section_header("[ScriptInfo]",          "[script info]"));
+  EXPECT_FALSE(is_ssa_section_header("x [Script Info]",       "[script info]"));
+  EXPECT_FALSE(is_ssa_section_header("[V4+ Styles]",          "[v4 styles]"));
+
+  EXPECT_TRUE(is_ssa_comment_or_empty(""));
+  EXPECT_TRUE(is_ssa_comment_or_empty(" \t"));
+  EXPECT_TRUE(is_ssa_comment_or_empty("; comment"));
+  EXPECT_TRUE(is_ssa_comment_or_empty("  !comment"));
+
+  EXPECT_FALSE(is_ssa_comment_or_empty("x ; comment"));
+}
+
+}
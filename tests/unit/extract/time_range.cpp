@@ -0,0 +1,119 @@
+#include "common/common_pch.h"
+
+#include "common/kax_analyzer.h"
+#include "common/mm_io.h"
+#include "extract/time_range.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+unsigned char const s_ebml_head[] = {
+  0x1a, 0x45, 0xdf, 0xa3, 0x93,
+  0x42, 0x82, 0x88, 0x6d, 0x61, 0x74, 0x72, 0x6f, 0x73, 0x6b, 0x61,
+  0x42, 0x87, 0x81, 0x02,
+  0x42, 0x85, 0x81, 0x02,
+};
+
+// Segment data starts at position 29.
+unsigned char const s_level1_elements[] = {
+  // Info: TimecodeScale 1000000
+  0x15, 0x49, 0xa9, 0x66, 0x87, 0x2a, 0xd7, 0xb1, 0x83, 0x0f, 0x42, 0x40,
+  // Tracks: track 1, A_PCM/INT/LIT
+  0x16, 0x54, 0xae, 0x6b, 0x9b, 0xae, 0x99, 0xd7, 0x81, 0x01, 0x73, 0xc5, 0x81, 0x01, 0x83, 0x81, 0x02,
+  0x86, 0x8d, 0x41, 0x5f, 0x50, 0x43, 0x4d, 0x2f, 0x49, 0x4e, 0x54, 0x2f, 0x4c, 0x49, 0x54,
+  // Cluster at position 73, timecode 0: SimpleBlocks at 0 and 40
+  0x1f, 0x43, 0xb6, 0x75, 0x93, 0xe7, 0x81, 0x00,
+  0xa3, 0x86, 0x81, 0x00, 0x00, 0x80, 0xaa, 0xbb,
+  0xa3, 0x86, 0x81, 0x00, 0x28, 0x80, 0xaa, 0xbb,
+  // Cluster at position 97, timecode 100: SimpleBlocks at 0 and 40
+  0x1f, 0x43, 0xb6, 0x75, 0x93, 0xe7, 0x81, 0x64,
+  0xa3, 0x86, 0x81, 0x00, 0x00, 0x80, 0xaa, 0xbb,
+  0xa3, 0x86, 0x81, 0x00, 0x28, 0x80, 0xaa, 0xbb,
+};
+
+// Cues: one cue point at 100 referencing the second cluster
+unsigned char const s_cues[] = {
+  0x1c, 0x53, 0xbb, 0x6b, 0x8d, 0xbb, 0x8b, 0xb3, 0x81, 0x64, 0xb7, 0x86, 0xf7, 0x81, 0x01, 0xf1, 0x81, 0x44,
+};
+
+uint64_t const s_timecode_scale = 1000000;
+
+class TimeRangeTest: public ::testing::Test {
+public:
+  memory_cptr m_data;
+  std::unique_ptr<mm_mem_io_c> m_in;
+  std::unique_ptr<kax_analyzer_c> m_analyzer;
+
+  void
+  analyze(bool with_cues) {
+    auto segment_size = sizeof(s_level1_elements) + (with_cues ? sizeof(s_cues) : 0);
+    unsigned char const segment_head[] = { 0x18, 0x53, 0x80, 0x67, static_cast<unsigned char>(0x80 | segment_size) };
+
+    m_data = memory_c::alloc(sizeof(s_ebml_head) + sizeof(segment_head) + segment_size);
+    auto ptr = m_data->get_buffer();
+
+    std::memcpy(ptr, s_ebml_head, sizeof(s_ebml_head));
+    ptr += sizeof(s_ebml_head);
+    std::memcpy(ptr, segment_head, sizeof(segment_head));
+    ptr += sizeof(segment_head);
+    std::memcpy(ptr, s_level1_elements, sizeof(s_level1_elements));
+    ptr += sizeof(s_level1_elements);
+
+    if (with_cues)
+      std::memcpy(ptr, s_cues, sizeof(s_cues));
+
+    m_in.reset(new mm_mem_io_c{*m_data});
+    m_analyzer.reset(new kax_analyzer_c{m_in.get()});
+
+    ASSERT_TRUE(m_analyzer->set_parse_mode(kax_analyzer_c::parse_mode_full).process());
+  }
+};
+
+TEST_F(TimeRangeTest, NoStartReadsFromFirstCluster) {
+  analyze(true);
+
+  time_range_c range;
+
+  EXPECT_FALSE(range.determine_start_position(*m_analyzer, s_timecode_scale));
+  EXPECT_EQ(73u, *range.determine_first_cluster_to_read(*m_analyzer, s_timecode_scale));
+}
+
+TEST_F(TimeRangeTest, StartUsesClusterFromCues) {
+  analyze(true);
+
+  time_range_c range;
+  range.m_start = timestamp_c::ms(120);
+
+  EXPECT_EQ(97u, *range.determine_start_position(*m_analyzer, s_timecode_scale));
+  EXPECT_EQ(97u, *range.determine_first_cluster_to_read(*m_analyzer, s_timecode_scale));
+}
+
+TEST_F(TimeRangeTest, StartWithoutCuesFallsBackToFirstCluster) {
+  analyze(false);
+
+  time_range_c range;
+  range.m_start = timestamp_c::ms(120);
+
+  EXPECT_FALSE(range.determine_start_position(*m_analyzer, s_timecode_scale));
+  EXPECT_EQ(73u, *range.determine_first_cluster_to_read(*m_analyzer, s_timecode_scale));
+}
+
+TEST_F(TimeRangeTest, FilteringDoesNotDependOnCues) {
+  for (auto with_cues : { false, true }) {
+    analyze(with_cues);
+
+    time_range_c range;
+    range.m_start = timestamp_c::ms(120);
+    range.m_end   = timestamp_c::ms(140);
+
+    range.determine_first_cluster_to_read(*m_analyzer, s_timecode_scale);
+
+    EXPECT_FALSE(range.includes(timestamp_c::ms(100).to_ns()));
+    EXPECT_TRUE(range.includes(timestamp_c::ms(120).to_ns()));
+    EXPECT_FALSE(range.includes(timestamp_c::ms(140).to_ns()));
+    EXPECT_TRUE(range.is_past_end(timestamp_c::ms(140).to_ns()));
+  }
+}
+
+}